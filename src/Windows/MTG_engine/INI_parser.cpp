@@ -1,54 +1,135 @@
 #include "INI_parser.hpp"
 
+#include <algorithm>
 #include <iostream>
 
-IniParser::IniParser() {}
-
-IniParser::~IniParser() {}
+namespace {
 
-void IniParser::removeLeadingTrailing(std::string& str) {
-    str.erase(0, str.find_first_not_of(" \t"));
-    str.erase(str.find_last_not_of(" \t") + 1);
+std::string_view trim(std::string_view str) {
+    size_t begin = str.find_first_not_of(" \t");
+    if (begin == std::string_view::npos) {
+        return {};
+    }
+    size_t end = str.find_last_not_of(" \t");
+    return str.substr(begin, end - begin + 1);
 }
 
-bool IniParser::isSectionHeader(std::string& line) {
-    return line[0] == '[' && line[line.size() - 1] == ']';
 }
 
-bool IniParser::isKeyValuePair(std::string& line) {
-    return line.find('=') != std::string::npos;
+IniDocument::IniDocument(std::string_view text) : buffer(text.begin(), text.end()) {
+    parse();
 }
 
-IniParser::IniData IniParser::parseIniFile(const std::string& filename) {
-    IniData data;
-    std::ifstream file(filename);
+IniDocument IniDocument::fromFile(const std::string& filename) {
+    IniDocument document;
+    std::ifstream file(filename, std::ios::binary);
 
 	if (!file.is_open()) {
 		std::cout << "Failed to open file: " << filename << "\n";
-		return data;
+		return document;
 	}
 
-    std::string line;
-    std::string currentSection;
+    file.seekg(0, std::ios::end);
+    std::streamoff size = file.tellg();
+    file.seekg(0, std::ios::beg);
+    if (size > 0) {
+        document.buffer.resize(static_cast<size_t>(size));
+        file.read(document.buffer.data(), size);
+        document.buffer.resize(static_cast<size_t>(file.gcount()));
+    }
+    document.parse();
+    return document;
+}
 
-    while (std::getline(file, line)) {
-        removeLeadingTrailing(line);
+void IniDocument::parse() {
+    std::string_view text(buffer.data(), buffer.size());
+    sections.clear();
+    entryList.clear();
+    sectionIndex.clear();
+    sectionIndex.reserve(static_cast<size_t>(std::count(text.begin(), text.end(), '[')));
 
-        if (isSectionHeader(line)) {
-            currentSection = line.substr(1, line.size() - 2);
-            data[currentSection] = {};
-        } else if (isKeyValuePair(line)) {
-            size_t equalsPos = line.find('=');
-            std::string key = line.substr(0, equalsPos);
-            std::string value = line.substr(equalsPos + 1);
+    size_t pos = 0;
+    while (pos < text.size()) {
+        size_t end = text.find('\n', pos);
+        if (end == std::string_view::npos) {
+            end = text.size();
+        }
+        std::string_view line = text.substr(pos, end - pos);
+        pos = end + 1;
 
-            removeLeadingTrailing(key);
-            removeLeadingTrailing(value);
+        if (!line.empty() && line.back() == '\r') {
+            line.remove_suffix(1);
+        }
+        line = trim(line);
+        if (line.empty()) {
+            continue;
+        }
+
+        if (line.size() >= 2 && line.front() == '[' && line.back() == ']') {
+            std::string_view name = line.substr(1, line.size() - 2);
+            sections.push_back(Section{ name, static_cast<std::uint32_t>(entryList.size()), 0 });
+            sectionIndex[name] = static_cast<std::uint32_t>(sections.size() - 1);
+            continue;
+        }
+
+        size_t equals = line.find('=');
+        if (equals == std::string_view::npos) {
+            continue;
+        }
+        if (sections.empty()) {
+            // keys before the first section header
+            sections.push_back(Section{ std::string_view(), 0, 0 });
+            sectionIndex[std::string_view()] = 0;
+        }
+        entryList.push_back(Entry{ trim(line.substr(0, equals)), trim(line.substr(equals + 1)) });
+        sections.back().count++;
+    }
+}
 
-            data[currentSection][key] = value;
+const std::string_view* IniDocument::find(size_t section, std::string_view key) const {
+    // the last pair with the key wins, like in IniParser::IniData
+    const Entry* first = entries(section);
+    for (size_t i = entryCount(section); i > 0; i--) {
+        if (first[i - 1].key == key) {
+            return &first[i - 1].value;
         }
     }
+    return nullptr;
+}
+
+const std::string_view* IniDocument::find(std::string_view section, std::string_view key) const {
+    auto it = sectionIndex.find(section);
+    return (it != sectionIndex.end()) ? find(it->second, key) : nullptr;
+}
+
+std::vector<size_t> IniDocument::sectionsByName() const {
+    std::vector<size_t> ret;
+    ret.reserve(sectionIndex.size());
+    for (auto&& [name, section] : sectionIndex) {
+        ret.push_back(section);
+    }
+    std::sort(ret.begin(), ret.end(), [this](size_t a, size_t b) {
+        return sections[a].name < sections[b].name;
+    });
+    return ret;
+}
+
+IniParser::IniParser() {}
 
-    file.close();
+IniParser::~IniParser() {}
+
+IniParser::IniData IniParser::toIniData(const IniDocument& document) {
+    IniData data;
+    for (auto&& section : document.sectionsByName()) {
+        auto& pairs = data[std::string(document.sectionName(section))];
+        const IniDocument::Entry* entries = document.entries(section);
+        for (size_t i = 0; i < document.entryCount(section); i++) {
+            pairs[std::string(entries[i].key)] = std::string(entries[i].value);
+        }
+    }
     return data;
+}
+
+IniParser::IniData IniParser::parseIniFile(const std::string& filename) {
+    return toIniData(IniDocument::fromFile(filename));
 }
\ No newline at end of file
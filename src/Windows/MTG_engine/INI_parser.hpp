@@ -1,9 +1,128 @@
 #ifndef MTG_ENGINE_INI_PARSER_H
 #define MTG_ENGINE_INI_PARSER_H
 
+#include <cstdint>
 #include <fstream>
 #include <string>
+#include <string_view>
 #include <map>
+#include <unordered_map>
+#include <vector>
+
+/**
+* an INI file read into one buffer and tokenized in a single pass, sections, keys and values are views into the buffer
+* sections are found by name through a hash index
+* keys before the first section are in the section "", lines that are neither a section header nor a key-value pair are ignored
+**/
+class IniDocument {
+public:
+    /**
+    * one key-value pair of a section
+    **/
+    struct Entry {
+        std::string_view key;
+        std::string_view value;
+    };
+
+    IniDocument() = default;
+
+    /**
+    * parses INI text
+    * @param text contents of an INI file
+    **/
+    explicit IniDocument(std::string_view text);
+
+    // the views point into the buffer, copying would leave them pointing into the original
+    IniDocument(const IniDocument&) = delete;
+    IniDocument& operator=(const IniDocument&) = delete;
+    IniDocument(IniDocument&&) = default;
+    IniDocument& operator=(IniDocument&&) = default;
+
+    /**
+    * reads and parses an INI file
+    * @param filename the name of the INI file
+    * 
+    * @returns the document, empty if the file can not be opened
+    **/
+    static IniDocument fromFile(const std::string& filename);
+
+    /**
+    * get the number of sections, a section that appears twice is counted twice
+    * 
+    * @returns number of sections
+    **/
+    size_t sectionCount() const { return sections.size(); }
+
+    /**
+    * checks if the document has no sections
+    * 
+    * @returns true if it is empty
+    **/
+    bool empty() const { return sections.empty(); }
+
+    /**
+    * get the name of a section
+    * @param section index of the section in the order of the file
+    * 
+    * @returns name
+    **/
+    std::string_view sectionName(size_t section) const { return sections[section].name; }
+
+    /**
+    * get the key-value pairs of a section in the order of the file
+    * @param section index of the section in the order of the file
+    * 
+    * @returns pointer to the first pair, the section has entryCount(section) of them
+    **/
+    const Entry* entries(size_t section) const { return entryList.data() + sections[section].first; }
+
+    /**
+    * get the number of key-value pairs of a section
+    * @param section index of the section in the order of the file
+    * 
+    * @returns number of pairs
+    **/
+    size_t entryCount(size_t section) const { return sections[section].count; }
+
+    /**
+    * find the value of a key in a section, sections have a handful of keys so they are scanned
+    * @param section index of the section in the order of the file
+    * @param key the key
+    * 
+    * @returns pointer to the value, nullptr if the section does not have the key
+    **/
+    const std::string_view* find(size_t section, std::string_view key) const;
+
+    /**
+    * find the value of a key in a section by names, a section that appears twice is looked up in its last appearance
+    * @param section name of the section
+    * @param key the key
+    * 
+    * @returns pointer to the value, nullptr if there is no such section or key
+    **/
+    const std::string_view* find(std::string_view section, std::string_view key) const;
+
+    /**
+    * get the sections in the order IniParser::IniData iterates them: sorted by name, the last appearance of every name
+    * 
+    * @returns indices of the sections
+    **/
+    std::vector<size_t> sectionsByName() const;
+
+private:
+    struct Section {
+        std::string_view name;
+        std::uint32_t first;
+        std::uint32_t count;
+    };
+
+    std::vector<char> buffer;
+    std::vector<Section> sections;
+    std::vector<Entry> entryList;
+    std::unordered_map<std::string_view, std::uint32_t> sectionIndex;
+
+    void parse();
+};
 
 class IniParser {
 public:
@@ -20,10 +139,13 @@ public:
     **/
     IniData parseIniFile(const std::string& filename);
 
-private:
-    void removeLeadingTrailing(std::string& str);
-    bool isSectionHeader(std::string& line);
-    bool isKeyValuePair(std::string& line);
+    /**
+    * copies a parsed INI document into a map of sections and key-value pairs
+    * @param document the document
+    * 
+    * @returns a map of sections and key-value pairs
+    **/
+    static IniData toIniData(const IniDocument& document);
 };
 
-#endif //MTG_ENGINE_INI_PARSER_H
+#endif //MTG_ENGINE_INI_PARSER_H
\ No newline at end of file
@@ -3,30 +3,58 @@
 
 #include <iostream>
 #include "game.hpp"
+#include "binary_deck.hpp"
 using namespace std;
 
-int main()
+int main(int argc, char* argv[])
 {
+    std::uint64_t seed = random_seed();
+    // decks can be INI files or binary decks compiled by MTG_deck_compiler
+    std::string deck1_file = "..\\..\\..\\..\\decks\\red.ini";
+    std::string deck2_file = deck1_file;
+    size_t n_of_decks = 0;
+    for (int i = 1; i < argc; i++) {
+        if (string(argv[i]) == "--seed" && i + 1 < argc) {
+            seed = std::stoull(argv[++i]);
+        } else if (n_of_decks == 0) {
+            deck1_file = deck2_file = argv[i];
+            n_of_decks++;
+        } else if (n_of_decks == 1) {
+            deck2_file = argv[i];
+            n_of_decks++;
+        }
+    }
+
 	string player1_name, player2_name;
 	cout << "Enter player names: ";
 
     std::getline(std::cin, player1_name);
 	std::getline(std::cin, player2_name);
 
-    IniParser parser;
-    IniParser::IniData deck1 = parser.parseIniFile("..\\..\\..\\..\\decks\\red.ini");
-    IniParser::IniData deck2 = parser.parseIniFile("..\\..\\..\\..\\decks\\red.ini");
-
-    deck deck_1(deck1);
-    deck deck_2(deck2);
+    compiled_deck deck1(std::vector<card_id>{});
+    compiled_deck deck2(std::vector<card_id>{});
+    try {
+        deck1 = load_deck(deck1_file);
+        deck2 = load_deck(deck2_file);
+    } catch (const std::exception& e) {
+        std::cout << e.what() << "\n";
+        return 1;
+    }
+    deck deck_1 = deck1.instantiate();
+    deck deck_2 = deck2.instantiate();
 
-	game game(player1_name, player2_name, std::move(deck_1), std::move(deck_2));
+    std::cout << "Game seed: " << seed << "\n";
+	game game(player1_name, player2_name, std::move(deck_1), std::move(deck_2), nullptr, nullptr, seed);
     game.start_game();
     while (!game.is_ended()) {
         game.turn();
     }
-    string winner = (game.get_active_player()->get_life()) > 0 ? game.get_active_player()->get_damagable_name() : game.get_non_active_player()->get_damagable_name();
-    std::cout << winner << " won the game!";
+    player* winner = game.get_winner();
+    if (winner != nullptr) {
+        std::cout << winner->get_damagable_name() << " won the game!";
+    } else {
+        std::cout << "The game ended in a draw!";
+    }
 
     std::cin.get();
     std::exit(0);
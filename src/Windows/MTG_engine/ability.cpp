@@ -4,7 +4,9 @@
 
 // TODO: work on abilities
 void haste::execute() {
-    this->me.set_summoning_sickness(false);
+    if (this->battlefield.contains(this->me)) {
+        this->battlefield.set_summoning_sickness(this->battlefield.index_of(this->me), false);
+    }
 }
 
 void lifelink::execute(player& controller) {
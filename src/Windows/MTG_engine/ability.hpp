@@ -5,10 +5,12 @@
 #include <functional>
 #include "color.hpp"
 #include "effect.hpp"
+#include "permanent_handle.hpp"
 
 class player;
 class creature;
 class permanent;
+class battlefield_zone;
 
 class ability
 {
@@ -39,9 +41,10 @@ public:
 // TODO: work on abilities
 
 class haste : public ability {
-	creature& me;
+	battlefield_zone& battlefield;
+	permanent_handle me;
 public:
-	haste(creature& me) : me(me) {}
+	haste(battlefield_zone& battlefield, permanent_handle me) : battlefield(battlefield), me(me) {}
 	void execute() override;
 };
 
@@ -0,0 +1,261 @@
+#ifndef MTG_ENGINE_ACTION_LOG_H
+#define MTG_ENGINE_ACTION_LOG_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+#include "move.hpp"
+
+// the decisions of one game as a stream of varints (7 bits per byte, the high bit marks that more follow), a few bytes
+// per decision, e.g. a main phase move is its kind and one or two indices
+// the game and its players add every decision where it takes effect, whoever made it (an agent or a decision_source),
+// the seed of the game and its decisions replay the game (see game_replay)
+class action_log
+{
+public:
+	// the main phase code of a command in the console format, moves have codes from 1
+	static constexpr std::uint64_t COMMAND = 0;
+
+	/**
+	* forget the decisions, e.g. for the next game
+	**/
+	void clear() {
+		bytes.clear();
+	}
+
+	/**
+	* add a yes or no decision, e.g. a mulligan
+	* @param flag the decision
+	**/
+	void add_flag(bool flag) {
+		put(flag ? 1 : 0);
+	}
+
+	/**
+	* add a main phase move
+	* @param chosen the move
+	**/
+	void add_move(const move& chosen) {
+		put(move_code(chosen));
+		if (chosen.type == MoveType::PASS) return;
+		put(chosen.index);
+		if (chosen.type == MoveType::BLOCK || chosen.type == MoveType::ORDER_BLOCKER) put(chosen.attacker);
+		if (chosen.target == MoveTarget::MY_CREATURE || chosen.target == MoveTarget::OPPONENT_CREATURE) put(chosen.target_index);
+	}
+
+	/**
+	* add a main phase command in the console format (see agent::choose_play)
+	* @param command the command
+	**/
+	void add_command(const std::string& command) {
+		put(COMMAND);
+		put_string(command);
+	}
+
+	/**
+	* add a list of creatures, e.g. the attackers or the order of blockers
+	* @param indices the creatures
+	**/
+	void add_indices(const std::vector<size_t>& indices) {
+		put(indices.size());
+		for (auto&& index : indices) put(index);
+	}
+
+	/**
+	* add the blockers of every attacker
+	* @param blocks map of attacker to blockers
+	**/
+	void add_blocks(const std::map<size_t, std::vector<size_t>>& blocks) {
+		put(blocks.size());
+		for (auto&& [attacker, blockers] : blocks) {
+			put(attacker);
+			add_indices(blockers);
+		}
+	}
+
+	/**
+	* add one index, e.g. the card a player discards
+	* @param index the index
+	**/
+	void add_index(size_t index) {
+		put(index);
+	}
+
+	/**
+	* add the target of an effect in the console format (see agent::choose_target), "me" and "opp" take one byte
+	* @param target the target
+	**/
+	void add_target(const std::string& target) {
+		if (target == "me") {
+			put(0);
+		} else if (target == "opp") {
+			put(1);
+		} else {
+			put(2);
+			put_string(target);
+		}
+	}
+
+	/**
+	* get the encoded decisions
+	*
+	* @returns bytes
+	**/
+	const std::vector<std::uint8_t>& get_bytes() const {
+		return bytes;
+	}
+
+	/**
+	* get the code a move is stored with, its type, target and color of mana together
+	* @param chosen the move
+	*
+	* @returns code, COMMAND is not one of them
+	**/
+	static constexpr std::uint64_t move_code(const move& chosen) {
+		return 1 + static_cast<std::uint64_t>(chosen.type) + 7 * (static_cast<std::uint64_t>(chosen.target) + 5 * static_cast<std::uint64_t>(chosen.mana_color));
+	}
+
+private:
+	std::vector<std::uint8_t> bytes;
+
+	void put(std::uint64_t value) {
+		while (value >= 0x80) {
+			bytes.push_back(static_cast<std::uint8_t>(value | 0x80));
+			value >>= 7;
+		}
+		bytes.push_back(static_cast<std::uint8_t>(value));
+	}
+
+	void put_string(const std::string& text) {
+		put(text.size());
+		bytes.insert(bytes.end(), text.begin(), text.end());
+	}
+};
+
+// reads the decisions of an action_log in the order they were added, reads past the end return zeros
+class action_reader
+{
+public:
+	action_reader() = default;
+
+	/**
+	* action reader constructor
+	* @param data the encoded decisions, they have to outlive the reader
+	* @param size number of bytes
+	**/
+	action_reader(const std::uint8_t* data, size_t size) : data(data), size(size) {}
+
+	/**
+	* checks if every decision was read
+	*
+	* @returns true at the end
+	**/
+	bool at_end() const {
+		return position >= size;
+	}
+
+	/**
+	* get the position of the next decision, e.g. to come back to it with seek
+	*
+	* @returns offset in bytes
+	**/
+	size_t tell() const {
+		return position;
+	}
+
+	/**
+	* continue reading from a position got from tell
+	* @param offset the position
+	**/
+	void seek(size_t offset) {
+		position = offset;
+	}
+
+	bool get_flag() {
+		return get() != 0;
+	}
+
+	/**
+	* read a main phase decision
+	* @param chosen the move, if it is one
+	*
+	* @returns false for a command, it is read with get_string
+	**/
+	bool get_move(move& chosen) {
+		std::uint64_t code = get();
+		if (code == action_log::COMMAND) return false;
+		code--;
+		chosen = move();
+		chosen.type = static_cast<MoveType>(code % 7);
+		chosen.target = static_cast<MoveTarget>(code / 7 % 5);
+		chosen.mana_color = static_cast<color>(code / 35);
+		if (chosen.type == MoveType::PASS) return true;
+		chosen.index = static_cast<std::uint16_t>(get());
+		if (chosen.type == MoveType::BLOCK || chosen.type == MoveType::ORDER_BLOCKER) chosen.attacker = static_cast<std::uint16_t>(get());
+		if (chosen.target == MoveTarget::MY_CREATURE || chosen.target == MoveTarget::OPPONENT_CREATURE) chosen.target_index = static_cast<std::uint16_t>(get());
+		return true;
+	}
+
+	std::vector<size_t> get_indices() {
+		std::vector<size_t> ret(checked_count());
+		for (auto&& index : ret) index = get();
+		return ret;
+	}
+
+	std::map<size_t, std::vector<size_t>> get_blocks() {
+		std::map<size_t, std::vector<size_t>> ret;
+		for (size_t n = checked_count(); n > 0; n--) {
+			size_t attacker = get();
+			ret[attacker] = get_indices();
+		}
+		return ret;
+	}
+
+	size_t get_index() {
+		return get();
+	}
+
+	std::string get_target() {
+		switch (get()) {
+			case 0:
+				return "me";
+			case 1:
+				return "opp";
+			default:
+				return get_string();
+		}
+	}
+
+	std::string get_string() {
+		size_t length = checked_count();
+		std::string ret(reinterpret_cast<const char*>(data + position), length);
+		position += length;
+		return ret;
+	}
+
+private:
+	const std::uint8_t* data = nullptr;
+	size_t size = 0;
+	size_t position = 0;
+
+	std::uint64_t get() {
+		std::uint64_t ret = 0;
+		for (unsigned shift = 0; position < size && shift < 64; shift += 7) {
+			std::uint8_t byte = data[position++];
+			ret |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+			if (!(byte & 0x80)) break;
+		}
+		return ret;
+	}
+
+	// a count can't be larger than the bytes left, a damaged log doesn't allocate more than that
+	size_t checked_count() {
+		std::uint64_t count = get();
+		return static_cast<size_t>(count <= size - std::min(position, size) ? count : size - std::min(position, size));
+	}
+};
+
+#endif //MTG_ENGINE_ACTION_LOG_H
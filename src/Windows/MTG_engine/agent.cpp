@@ -0,0 +1,313 @@
+#include "agent.hpp"
+#include "player.hpp"
+
+#include <iostream>
+#include <sstream>
+
+/**
+* picks the color to tap a land for, one that the cost still needs if the land can make it
+* @param taps_for the colors of the land
+* @param cost the cost being paid
+* @param pool the mana already there
+*
+* @returns color
+**/
+static color color_to_tap_for(color_set taps_for, const mana_cost& cost, const mana& pool) {
+    for (size_t i = 0; i < N_OF_COLORS; i++) {
+        color color_of_mana = static_cast<color>(i);
+        if (taps_for.contains(color_of_mana) && cost.colored.get(color_of_mana) > pool.get(color_of_mana)) {
+            return color_of_mana;
+        }
+    }
+    return taps_for.first();
+}
+
+console_agent& console_agent::instance() {
+    static console_agent console;
+    return console;
+}
+
+std::vector<size_t> console_agent::selector(const std::function<void()>& suggest) {
+    std::string choice;
+    std::getline(std::cin, choice);
+    while (choice == "suggest" && suggest) {
+        suggest();
+        std::getline(std::cin, choice);
+    }
+
+    std::istringstream iss(choice);
+    std::vector<size_t> ret;
+
+    size_t num;
+    while (iss >> num) {
+        ret.push_back(num - 1);
+    }
+    return ret;
+}
+
+std::string console_agent::choose_play(player&, player&) {
+    std::string action;
+    std::getline(std::cin, action);
+    return action;
+}
+
+bool console_agent::choose_mulligan(player& me) {
+    std::string player_mulligan;
+    me.display_hand();
+    std::cout << me.get_damagable_name() << " mulligan? y/N\n";
+    std::getline(std::cin, player_mulligan);
+    return player_mulligan == "Y" || player_mulligan == "y";
+}
+
+std::vector<size_t> console_agent::choose_attackers(player& me, player&) {
+    std::cout << me.get_damagable_name() << " Select attackers: \n";
+    for (size_t i = 0; i < me.get_battlefield().size(); i++) {
+        std::cout << i + 1 << ": " << me.get_battlefield().get_name(i) << "\n";
+    }
+    return selector();
+}
+
+std::map<size_t, std::vector<size_t>> console_agent::choose_blockers(player& me, player& opponent, const std::vector<size_t>& attackers) {
+    std::map<size_t, std::vector<size_t>> ret;
+    for (size_t i = 0; i < me.get_battlefield().size(); i++) {
+        std::cout << i + 1 << ": " << me.get_battlefield().get_name(i) << "\n";
+    }
+    std::cout << me.get_damagable_name() << " Select blocker/s for each attacker (suggest shows the best blocks): \n";
+    auto suggest = [&]() {
+        auto suggested = solver.best_blocks(me, opponent, attackers);
+        for (auto&& attacker : attackers) {
+            std::cout << opponent.get_battlefield().get_name(attacker) << ":";
+            for (auto&& blocker : suggested[attacker]) {
+                std::cout << " " << blocker + 1;
+            }
+            std::cout << "\n";
+        }
+    };
+    for (auto&& attacker : attackers) {
+        std::cout << opponent.get_battlefield().get_name(attacker) << "\n";
+        ret[attacker] = selector(suggest);
+    }
+    return ret;
+}
+
+std::vector<size_t> console_agent::choose_order_of_blockers(player& me, player& opponent, size_t attacker, const std::vector<size_t>& blockers) {
+    std::cout << me.get_damagable_name() << " Select order of blockers for " << me.get_battlefield().get_name(attacker) << " (suggest shows the best order)\n";
+    return selector([&]() {
+        for (auto&& blocker : combat_solver::best_order(me, opponent, attacker, blockers)) {
+            std::cout << blocker + 1 << " ";
+        }
+        std::cout << "\n";
+    });
+}
+
+size_t console_agent::choose_discard(player& me) {
+    std::cout << "Select a card to discard: \n";
+    for (size_t j = 0; j < me.get_hand().size(); j++) {
+        std::cout << j << ": " << card_definition(me.get_hand()[j]).get_name() << "\n";
+    }
+    std::string line;
+    std::getline(std::cin, line);
+    std::istringstream iss(line);
+    size_t choice = 0;
+    if (iss >> choice) {
+        return choice;
+    }
+    return me.get_hand().size(); // invalid, the player asks again
+}
+
+std::string console_agent::choose_target(player&, player&, const effect& eff) {
+    std::cout << "Enter target for effect " << eff.get_name() << " : ";
+    std::string target;
+    std::getline(std::cin, target);
+    return target;
+}
+
+bool random_agent::coin_flip() {
+    return gen.coin_flip();
+}
+
+size_t random_agent::choose_move(player& me, player&, const std::pmr::vector<move>& legal_moves) {
+    for (size_t i = 0; i < legal_moves.size(); i++) {
+        if (legal_moves[i].type == MoveType::PLAY_LAND) {
+            return i;
+        }
+    }
+
+    battlefield_zone& battlefield = me.get_battlefield();
+    // lands of one color add the same for every spell, only lands of more colors depend on the cost
+    mana available_fixed = me.get_mana_pool();
+    std::vector<color_set> multicolor_lands;
+    for (size_t i = 0; i < battlefield.size(); i++) {
+        if (battlefield.get_type(i) == CardType::LAND && !battlefield.is_tapped(i)) {
+            color_set taps_for = static_cast<const land&>(battlefield.definition(i)).get_taps_for();
+            if (taps_for.size() == 1) {
+                available_fixed.add(taps_for.first());
+            } else {
+                multicolor_lands.push_back(taps_for);
+            }
+        }
+    }
+
+    // keep tapping for the same spell until it can be cast
+    const spell* planned = nullptr;
+    for (auto&& id : me.get_hand()) {
+        if (card_definition(id).get_name() == planned_spell) {
+            planned = static_cast<const spell*>(&card_definition(id));
+            break;
+        }
+    }
+    if (planned == nullptr) {
+        std::vector<const spell*> castable;
+        for (auto&& id : me.get_hand()) {
+            if (card_definition(id).get_type() == CardType::LAND) continue;
+            auto spell_ = static_cast<const spell*>(&card_definition(id));
+            const mana_cost& cost = spell_->get_mana_cost();
+            mana available = available_fixed;
+            for (auto&& taps_for : multicolor_lands) {
+                available.add(color_to_tap_for(taps_for, cost, available));
+            }
+            if (can_pay(available, cost)) {
+                castable.push_back(spell_);
+            }
+        }
+        if (castable.empty()) {
+            planned_spell.clear();
+            return 0; // pass
+        }
+        planned = castable[gen.below(castable.size())];
+        planned_spell = planned->get_name();
+    }
+
+    candidates.clear();
+    for (size_t i = 0; i < legal_moves.size(); i++) {
+        if (legal_moves[i].type == MoveType::CAST_SPELL && &card_definition(me.get_hand()[legal_moves[i].index]) == planned) {
+            candidates.push_back(i);
+        }
+    }
+    if (!candidates.empty()) {
+        planned_spell.clear();
+        return choose_cast(legal_moves, *planned);
+    }
+
+    const mana_cost& cost = planned->get_mana_cost();
+    mana pool = me.get_mana_pool();
+    size_t to_tap = NO_MOVE;
+    for (size_t i = 0; i < legal_moves.size(); i++) {
+        if (legal_moves[i].type != MoveType::TAP_LAND) continue;
+        color color_of_mana = legal_moves[i].mana_color;
+        if (to_tap == NO_MOVE || cost.colored.get(color_of_mana) > pool.get(color_of_mana)) {
+            to_tap = i;
+        }
+    }
+    if (to_tap == NO_MOVE) {
+        planned_spell.clear();
+        return 0; // pass
+    }
+    return to_tap;
+}
+
+size_t random_agent::choose_cast(const std::pmr::vector<move>& legal_moves, const spell& spell_) {
+    if (candidates.size() == 1) {
+        return candidates[0];
+    }
+
+    // the same preferences as choose_target
+    MoveTarget wanted = MoveTarget::OPPONENT;
+    for (auto&& eff : spell_.get_effects()) {
+        if (eff->get_target() == EffectTarget::NONE) continue;
+        if (eff->get_name() == "draw card") {
+            wanted = MoveTarget::ME;
+        } else if (eff->get_name() != "discard card") {
+            size_t creatures = 0;
+            for (auto&& i : candidates) {
+                if (legal_moves[i].target == MoveTarget::OPPONENT_CREATURE) creatures++;
+            }
+            if (creatures > 0 && (eff->get_name() == "destroy permanent" || coin_flip())) {
+                size_t pick = gen.below(creatures);
+                for (auto&& i : candidates) {
+                    if (legal_moves[i].target == MoveTarget::OPPONENT_CREATURE && pick-- == 0) {
+                        return i;
+                    }
+                }
+            }
+        }
+        break;
+    }
+    for (auto&& i : candidates) {
+        if (legal_moves[i].target == wanted) {
+            return i;
+        }
+    }
+    return candidates[0];
+}
+
+bool random_agent::choose_mulligan(player& me) {
+    size_t lands = 0;
+    for (auto&& id : me.get_hand()) {
+        if (card_definition(id).get_type() == CardType::LAND) lands++;
+    }
+    return lands == 0 || lands == me.get_hand().size();
+}
+
+std::vector<size_t> random_agent::choose_attackers(player& me, player&) {
+    std::vector<size_t> ret;
+    for (auto&& attack : moves.attacks(me, ret)) {
+        if (attack.type == MoveType::ATTACK && coin_flip()) {
+            ret.push_back(attack.index);
+        }
+    }
+    return ret;
+}
+
+std::map<size_t, std::vector<size_t>> random_agent::choose_blockers(player& me, player&, const std::vector<size_t>& attackers) {
+    std::vector<size_t> untapped;
+    battlefield_zone& battlefield = me.get_battlefield();
+    for (size_t i = 0; i < battlefield.size(); i++) {
+        if (battlefield.get_type(i) == CardType::CREATURE && !battlefield.is_tapped(i)) {
+            untapped.push_back(i);
+        }
+    }
+    gen.shuffle(untapped.begin(), untapped.end());
+
+    std::map<size_t, std::vector<size_t>> ret;
+    for (auto&& attacker : attackers) {
+        ret[attacker];
+        if (!untapped.empty() && coin_flip()) {
+            ret[attacker].push_back(untapped.back());
+            untapped.pop_back();
+        }
+    }
+    return ret;
+}
+
+std::vector<size_t> random_agent::choose_order_of_blockers(player&, player&, size_t, const std::vector<size_t>& blockers) {
+    std::vector<size_t> ret = blockers;
+    gen.shuffle(ret.begin(), ret.end());
+    return ret;
+}
+
+size_t random_agent::choose_discard(player& me) {
+    if (me.get_hand().empty()) return 0;
+    return gen.below(me.get_hand().size());
+}
+
+std::string random_agent::choose_target(player&, player& opponent, const effect& eff) {
+    if (eff.get_name() == "draw card") {
+        return "me";
+    }
+    if (eff.get_name() == "discard card") {
+        return "opp";
+    }
+
+    std::vector<std::string> creatures;
+    battlefield_zone& battlefield = opponent.get_battlefield();
+    for (size_t i = 0; i < battlefield.size(); i++) {
+        if (battlefield.get_type(i) == CardType::CREATURE) {
+            creatures.push_back(battlefield.get_name(i));
+        }
+    }
+    if (!creatures.empty() && (eff.get_name() == "destroy permanent" || coin_flip())) {
+        return "opp-" + creatures[gen.below(creatures.size())];
+    }
+    return "opp";
+}
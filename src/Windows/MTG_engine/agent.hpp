@@ -0,0 +1,192 @@
+#ifndef MTG_ENGINE_AGENT_H
+#define MTG_ENGINE_AGENT_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <cstdint>
+#include <functional>
+#include <memory_resource>
+#include "random.hpp"
+#include "move_generator.hpp"
+#include "combat_solver.hpp"
+
+class player;
+class effect;
+class spell;
+
+// agents make every decision a player has to make during the game
+class agent
+{
+public:
+	static constexpr size_t NO_MOVE = SIZE_MAX;
+
+	virtual ~agent() = default;
+
+	/**
+	* choose the next main phase move among the legal ones
+	* @param me the player the agent decides for
+	* @param opponent the other player
+	* @param legal_moves the legal moves (see move_generator::main_phase)
+	*
+	* @returns index into legal_moves, NO_MOVE to be asked for a command through choose_play instead
+	**/
+	virtual size_t choose_move(player&, player&, const std::pmr::vector<move>&) {
+		return NO_MOVE;
+	}
+
+	/**
+	* choose the next main phase command, in the same format the console accepts
+	* (e.g. "tap Mountain", "cast Lightning Bolt", "pass"), only asked if choose_move returns NO_MOVE
+	* @param me the player the agent decides for
+	* @param opponent the other player
+	*
+	* @returns the command
+	**/
+	virtual std::string choose_play(player&, player&) {
+		return "pass";
+	}
+
+	/**
+	* decide if the current hand should be mulliganed
+	* @param me the player the agent decides for
+	*
+	* @returns true to mulligan
+	**/
+	virtual bool choose_mulligan(player& me) = 0;
+
+	/**
+	* choose creatures to attack with
+	* @param me the player the agent decides for
+	* @param opponent the defending player
+	*
+	* @returns indices into the battlefield of me
+	**/
+	virtual std::vector<size_t> choose_attackers(player& me, player& opponent) = 0;
+
+	/**
+	* choose blockers for each attacker
+	* @param me the player the agent decides for
+	* @param opponent the attacking player
+	* @param attackers indices into the battlefield of opponent
+	*
+	* @returns map of attacker to indices into the battlefield of me
+	**/
+	virtual std::map<size_t, std::vector<size_t>> choose_blockers(player& me, player& opponent, const std::vector<size_t>& attackers) = 0;
+
+	/**
+	* choose the order in which an attacker fights its blockers
+	* @param me the attacking player
+	* @param opponent the blocking player
+	* @param attacker index into the battlefield of me
+	* @param blockers indices into the battlefield of opponent
+	*
+	* @returns the blockers in the chosen order
+	**/
+	virtual std::vector<size_t> choose_order_of_blockers(player& me, player& opponent, size_t attacker, const std::vector<size_t>& blockers) = 0;
+
+	/**
+	* choose a card to discard
+	* @param me the player the agent decides for
+	*
+	* @returns index into the hand of me
+	**/
+	virtual size_t choose_discard(player& me) = 0;
+
+	/**
+	* choose a target for an effect, in the same format the console accepts
+	* ("me", "opp", "me-Name of creature", "opp-Name of creature")
+	* @param me the player the agent decides for
+	* @param opponent the other player
+	* @param eff the effect that needs a target
+	*
+	* @returns the target
+	**/
+	virtual std::string choose_target(player& me, player& opponent, const effect& eff) = 0;
+};
+
+// reads decisions from std::cin and prompts on std::cout
+class console_agent : public agent
+{
+public:
+	std::string choose_play(player& me, player& opponent) override;
+	bool choose_mulligan(player& me) override;
+	std::vector<size_t> choose_attackers(player& me, player& opponent) override;
+	std::map<size_t, std::vector<size_t>> choose_blockers(player& me, player& opponent, const std::vector<size_t>& attackers) override;
+	std::vector<size_t> choose_order_of_blockers(player& me, player& opponent, size_t attacker, const std::vector<size_t>& blockers) override;
+	size_t choose_discard(player& me) override;
+	std::string choose_target(player& me, player& opponent, const effect& eff) override;
+
+	/**
+	* get the agent shared by all players that were not given one
+	*
+	* @returns the console agent
+	**/
+	static console_agent& instance();
+
+private:
+	combat_solver solver;
+
+	/**
+	* read a line of numbers (counted from 1)
+	* @param suggest called when the line is "suggest" instead, the line is read again after it
+	*
+	* @returns the numbers counted from 0
+	**/
+	std::vector<size_t> selector(const std::function<void()>& suggest = nullptr);
+};
+
+// plays legal but random moves, used for headless self-play
+class random_agent : public agent
+{
+public:
+	/**
+	* random agent constructor
+	* @param seed seed of the agent's random generator
+	**/
+	explicit random_agent(std::uint64_t seed) : gen(seed) {}
+
+	/**
+	* restart the agent with a new seed and forget the spell it was tapping lands for, e.g. for the next playout of a search
+	* @param seed the new seed
+	**/
+	void reseed(std::uint64_t seed) {
+		gen.seed(seed);
+		planned_spell.clear();
+	}
+
+	size_t choose_move(player& me, player& opponent, const std::pmr::vector<move>& legal_moves) override;
+	bool choose_mulligan(player& me) override;
+	std::vector<size_t> choose_attackers(player& me, player& opponent) override;
+	std::map<size_t, std::vector<size_t>> choose_blockers(player& me, player& opponent, const std::vector<size_t>& attackers) override;
+	std::vector<size_t> choose_order_of_blockers(player& me, player& opponent, size_t attacker, const std::vector<size_t>& blockers) override;
+	size_t choose_discard(player& me) override;
+	std::string choose_target(player& me, player& opponent, const effect& eff) override;
+
+private:
+	game_rng gen;
+	move_generator moves;
+
+	/**
+	* indices of the legal moves casting the planned spell, reused between decisions
+	**/
+	std::vector<size_t> candidates;
+
+	/**
+	* name of the spell the agent is currently tapping lands for
+	**/
+	std::string planned_spell;
+
+	bool coin_flip();
+
+	/**
+	* choose among the candidates which target to cast the spell with
+	* @param legal_moves the legal moves
+	* @param spell_ the spell
+	*
+	* @returns index into legal_moves
+	**/
+	size_t choose_cast(const std::pmr::vector<move>& legal_moves, const spell& spell_);
+};
+
+#endif //MTG_ENGINE_AGENT_H
@@ -0,0 +1,97 @@
+#ifndef MTG_ENGINE_ARENA_H
+#define MTG_ENGINE_ARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+
+// memory of one game at a time: everything a game allocates (deck, zones of the players) comes from one buffer,
+// freeing is a no-op and reset() makes the whole buffer available to the next game
+// not thread safe, use one arena per thread
+class game_arena
+{
+public:
+	static constexpr size_t DEFAULT_SIZE = 16 * 1024;
+
+	/**
+	* game arena constructor
+	* @param initial_size size of the buffer, the arena grows it when a game does not fit
+	**/
+	explicit game_arena(size_t initial_size = DEFAULT_SIZE) : size(initial_size), buffer(new std::byte[initial_size]),
+		resource(std::make_unique<std::pmr::monotonic_buffer_resource>(buffer.get(), size, &overflow)) {}
+
+	game_arena(const game_arena&) = delete;
+	game_arena& operator=(const game_arena&) = delete;
+
+	/**
+	* get the memory resource to build a game with
+	*
+	* @returns the memory resource
+	**/
+	std::pmr::memory_resource* get_resource() {
+		return resource.get();
+	}
+
+	/**
+	* free everything allocated since the last reset at once, everything built with the arena has to be destroyed
+	* if the game did not fit into the buffer, the buffer is doubled so the next one does
+	**/
+	void reset() {
+		resource->release();
+		if (overflow.used) {
+			overflow.used = false;
+			resource.reset();
+			size *= 2;
+			buffer.reset(new std::byte[size]);
+			resource = std::make_unique<std::pmr::monotonic_buffer_resource>(buffer.get(), size, &overflow);
+		}
+	}
+
+	/**
+	* get the size of the buffer
+	*
+	* @returns size in bytes
+	**/
+	size_t capacity() const {
+		return size;
+	}
+
+	/**
+	* get the arena of the current thread, used by the simulator and the tournament
+	*
+	* @returns the arena
+	**/
+	static game_arena& thread_local_arena() {
+		thread_local game_arena arena;
+		return arena;
+	}
+
+private:
+	// takes what does not fit into the buffer from the heap and remembers that it had to
+	class overflow_resource : public std::pmr::memory_resource
+	{
+	public:
+		bool used = false;
+
+	private:
+		void* do_allocate(size_t bytes, size_t alignment) override {
+			used = true;
+			return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+		}
+
+		void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+			std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+		}
+
+		bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+			return this == &other;
+		}
+	};
+
+	size_t size;
+	std::unique_ptr<std::byte[]> buffer;
+	overflow_resource overflow;
+	std::unique_ptr<std::pmr::monotonic_buffer_resource> resource;
+};
+
+#endif //MTG_ENGINE_ARENA_H
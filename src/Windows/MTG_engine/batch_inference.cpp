@@ -0,0 +1,490 @@
+#include "batch_inference.hpp"
+
+#include <algorithm>
+#include <numeric>
+
+namespace {
+    constexpr size_t N_OF_DECISIONS = 7;
+    constexpr size_t N_OF_PHASES = 7;
+    constexpr size_t N_OF_MOVE_TYPES = 7;
+    constexpr size_t N_OF_TARGETS = 5;
+
+    // offsets into an option row
+    constexpr size_t MOVE_TYPE = 0;
+    constexpr size_t MULLIGAN_FLAG = MOVE_TYPE + N_OF_MOVE_TYPES;
+    constexpr size_t DISCARD_FLAG = MULLIGAN_FLAG + 1;
+    constexpr size_t TARGET = DISCARD_FLAG + 1;
+    constexpr size_t CARD = TARGET + N_OF_TARGETS;		// the card the option is about: mana value, power, toughness, land, creature
+    constexpr size_t OTHER = CARD + 5;					// the creature it fights or targets: present, power, health, mana value
+    constexpr size_t MANA = OTHER + 4;					// a tap adds mana a spell in the hand lacks, the mana a cast leaves unused
+    constexpr size_t EFFECT = MANA + 2;					// the targeted effects of a cast are good (1) or bad (-1) for the deciding player
+
+    /**
+    * write what a card is, for a card that is not on the battlefield
+    * @param id the card
+    * @param features mana value, power, toughness, land, creature
+    **/
+    void encode_card(card_id id, float* features) {
+        const card& definition = card_definition(id);
+        if (definition.get_type() == CardType::LAND) {
+            features[3] = 1.0f;
+            return;
+        }
+        features[0] = static_cast<const spell&>(definition).get_mana_cost().total() / 10.0f;
+        if (definition.get_type() == CardType::CREATURE) {
+            const auto& body = static_cast<const creature&>(definition);
+            features[1] = body.get_power() / 10.0f;
+            features[2] = body.get_toughness() / 10.0f;
+            features[4] = 1.0f;
+        }
+    }
+
+    /**
+    * write what a permanent is, with the damage it took
+    * @param battlefield its battlefield
+    * @param index its index
+    * @param features mana value, power, health, land, creature
+    **/
+    void encode_permanent(battlefield_zone& battlefield, size_t index, float* features) {
+        encode_card(battlefield.get_id(index), features);
+        if (battlefield.get_type(index) == CardType::CREATURE) {
+            features[1] = battlefield.get_power(index) / 10.0f;
+            features[2] = battlefield.get_health(index) / 10.0f;
+        }
+    }
+
+    /**
+    * checks if a land adds mana a spell in the hand still lacks
+    * @param me the player
+    * @param added the color the land adds
+    *
+    * @returns true if the pool can't pay for some spell and lacks mana of the color or generic mana for it
+    **/
+    bool adds_missing_mana(player& me, color added) {
+        mana pool = me.get_mana_pool();
+        for (auto&& id : me.get_hand()) {
+            const card& definition = card_definition(id);
+            if (definition.get_type() == CardType::LAND) continue;
+            const mana_cost& cost = static_cast<const spell&>(definition).get_mana_cost();
+            if (can_pay(pool, cost)) continue;
+            if (cost.colored.get(added) > pool.get(added) || pool.total() < cost.total()) return true;
+        }
+        return false;
+    }
+
+    /**
+    * get whether an effect is good for the caster, drawing and healing help the target, the rest hurts it
+    * @param eff the effect
+    * @param target its target
+    *
+    * @returns 1 if it helps the caster, -1 if it hurts them, 0 for an effect without a target
+    **/
+    float effect_for_caster(const effect& eff, MoveTarget target) {
+        if (target == MoveTarget::NONE || eff.get_target() == EffectTarget::NONE) return 0.0f;
+        bool mine = (target == MoveTarget::ME || target == MoveTarget::MY_CREATURE);
+        bool helps = (eff.get_name() == "draw card" || eff.get_name() == "heal");
+        return (helps == mine) ? 1.0f : -1.0f;
+    }
+
+    /**
+    * get whether the effects of a spell cast with a target are good for the caster, drawing and healing help the target,
+    * the rest hurts it
+    * @param cast the spell
+    * @param target its target
+    *
+    * @returns sum over the effects with a target, 1 per effect that helps the caster and -1 per effect that hurts them
+    **/
+    float effect_for_caster(const spell& cast, MoveTarget target) {
+        if (target == MoveTarget::NONE) return 0.0f;
+        float ret = 0.0f;
+        for (auto&& eff : cast.get_effects()) {
+            ret += effect_for_caster(*eff, target);
+        }
+        return ret;
+    }
+
+    /**
+    * get the target of an option of a TARGET decision in the format of agent::choose_target
+    * @param current the game
+    * @param option the option
+    *
+    * @returns the target, a creature by its name as the console names it
+    **/
+    std::string target_name(game& current, const move& option) {
+        switch (option.target) {
+            case MoveTarget::ME:
+                return "me";
+            case MoveTarget::MY_CREATURE:
+                return "me-" + current.get_active_player()->get_battlefield().get_name(option.target_index);
+            case MoveTarget::OPPONENT_CREATURE:
+                return "opp-" + current.get_non_active_player()->get_battlefield().get_name(option.target_index);
+            default:
+                // also an effect on creatures without a creature to target, the same as random_agent
+                return "opp";
+        }
+    }
+
+    /**
+    * write a creature an option fights or targets
+    * @param battlefield its battlefield
+    * @param index its index
+    * @param features present, power, health, mana value
+    **/
+    void encode_other(battlefield_zone& battlefield, size_t index, float* features) {
+        if (index >= battlefield.size()) return;
+        float card_features[5] = {};
+        encode_permanent(battlefield, index, card_features);
+        features[0] = 1.0f;
+        features[1] = card_features[1];
+        features[2] = card_features[2];
+        features[3] = card_features[0];
+    }
+}
+
+void state_encoder::list_options(game& current, std::vector<move>& options) {
+    options.clear();
+    player& me = *current.get_deciding_player();
+    player& opponent = (&me == current.get_active_player()) ? *current.get_non_active_player() : *current.get_active_player();
+    const std::pmr::vector<move>* generated = nullptr;
+    switch (current.get_decision()) {
+        case DecisionType::MULLIGAN: {
+            move take = move::pass();
+            take.index = 1;
+            options.push_back(move::pass());
+            options.push_back(take);
+            return;
+        }
+        case DecisionType::MAIN_PHASE:
+            generated = &generator.main_phase(me, opponent);
+            break;
+        case DecisionType::ATTACKERS:
+            generated = &generator.attacks(me, {});
+            break;
+        case DecisionType::BLOCKERS:
+            generated = &generator.blocks(me, current.get_attackers(), {});
+            break;
+        case DecisionType::ORDER_BLOCKERS:
+            generated = &generator.blocker_orders(current.get_ordered_attacker(), current.get_blockers_to_order(), {});
+            break;
+        case DecisionType::DISCARD:
+            for (size_t i = 0; i < me.get_hand().size(); i++) {
+                move discard = move::pass();
+                discard.index = static_cast<std::uint16_t>(i);
+                options.push_back(discard);
+            }
+            return;
+        case DecisionType::TARGET:
+            list_targets(*me.get_effect_to_target(), me, opponent, options);
+            return;
+        default:
+            return;
+    }
+    for (auto&& option : *generated) {
+        // declaring attackers and blockers is one decision, there is no pass to finish it
+        if (option.type == MoveType::PASS && current.get_decision() != DecisionType::MAIN_PHASE) continue;
+        options.push_back(option);
+    }
+}
+
+void state_encoder::list_targets(const effect& eff, player& me, player& opponent, std::vector<move>& options) {
+    auto add = [&options](MoveTarget target, size_t index) {
+        move option = move::pass();
+        option.target = target;
+        option.target_index = static_cast<std::uint16_t>(index);
+        options.push_back(option);
+    };
+    if (eff.get_target() != EffectTarget::CREATURE) {
+        add(MoveTarget::ME, 0);
+        add(MoveTarget::OPPONENT, 0);
+    }
+    if (eff.get_target() == EffectTarget::PLAYER) return;
+    for (size_t i = 0; i < me.get_battlefield().size(); i++) {
+        if (me.get_battlefield().get_type(i) == CardType::CREATURE) add(MoveTarget::MY_CREATURE, i);
+    }
+    for (size_t i = 0; i < opponent.get_battlefield().size(); i++) {
+        if (opponent.get_battlefield().get_type(i) == CardType::CREATURE) add(MoveTarget::OPPONENT_CREATURE, i);
+    }
+}
+
+void state_encoder::encode(game& current, const std::vector<move>& options, float* state, float* rows) {
+    player& me = *current.get_deciding_player();
+    player& opponent = (&me == current.get_active_player()) ? *current.get_non_active_player() : *current.get_active_player();
+    DecisionType decision = current.get_decision();
+
+    std::fill(state, state + STATE_FEATURES, 0.0f);
+    state[static_cast<size_t>(decision) - 1] = 1.0f;
+    state[N_OF_DECISIONS + static_cast<size_t>(current.get_phase())] = 1.0f;
+    float* rest = state + N_OF_DECISIONS + N_OF_PHASES;
+    rest[0] = current.get_turn_number() / 50.0f;
+    rest[1] = (&me == current.get_active_player()) ? 1.0f : 0.0f;
+    rest[2] = current.get_attackers().size() / 10.0f;
+    rest[3] = (decision == DecisionType::ORDER_BLOCKERS) ? current.get_blockers_to_order().size() / 10.0f : 0.0f;
+    encode_player(me, true, rest + 4);
+    encode_player(opponent, false, rest + 4 + PLAYER_FEATURES);
+
+    for (size_t i = 0; i < options.size(); i++) {
+        encode_option(decision, options[i], me, opponent, rows + i * OPTION_FEATURES);
+    }
+}
+
+void state_encoder::encode_player(player& encoded, bool sees_hand, float* features) {
+    battlefield_zone& battlefield = encoded.get_battlefield();
+    features[0] = encoded.get_life() / 20.0f;
+    features[1] = encoded.get_hand().size() / 7.0f;
+    features[2] = encoded.get_library().size() / 60.0f;
+    features[3] = encoded.get_graveyard().size() / 60.0f;
+    for (size_t i = 4; i < PLAYER_FEATURES; i++) features[i] = 0.0f;
+    for (size_t i = 0; i < battlefield.size(); i++) {
+        if (battlefield.get_type(i) == CardType::LAND) {
+            features[battlefield.is_tapped(i) ? 5 : 4] += 0.1f;
+        } else if (battlefield.get_type(i) == CardType::CREATURE) {
+            features[6] += 0.1f;
+            features[7] += battlefield.get_power(i) / 20.0f;
+            features[8] += battlefield.get_health(i) / 20.0f;
+            if (!battlefield.is_tapped(i) && !battlefield.has_summoning_sickness(i)) features[9] += battlefield.get_power(i) / 20.0f;
+        }
+    }
+    mana pool = encoded.get_mana_pool();
+    for (size_t i = 0; i < N_OF_COLORS; i++) {
+        features[10 + i] = pool.get(static_cast<color>(i)) / 10.0f;
+    }
+    features[15] = encoded.has_played_land() ? 1.0f : 0.0f;
+    if (!sees_hand) return;
+    for (auto&& id : encoded.get_hand()) {
+        const card& definition = card_definition(id);
+        if (definition.get_type() == CardType::LAND) {
+            features[16] += 1.0f / 7.0f;
+        } else {
+            features[17] += static_cast<const spell&>(definition).get_mana_cost().total() / 20.0f;
+        }
+    }
+}
+
+void state_encoder::encode_option(DecisionType decision, const move& option, player& me, player& opponent, float* row) {
+    std::fill(row, row + OPTION_FEATURES, 0.0f);
+    row[MOVE_TYPE + static_cast<size_t>(option.type)] = 1.0f;
+    row[TARGET + static_cast<size_t>(option.target)] = 1.0f;
+    switch (decision) {
+        case DecisionType::MULLIGAN:
+            row[MULLIGAN_FLAG] = static_cast<float>(option.index);
+            return;
+        case DecisionType::DISCARD:
+            row[DISCARD_FLAG] = 1.0f;
+            if (option.index < me.get_hand().size()) encode_card(me.get_hand()[option.index], row + CARD);
+            return;
+        case DecisionType::TARGET:
+            row[EFFECT] = effect_for_caster(*me.get_effect_to_target(), option.target);
+            if (option.target == MoveTarget::MY_CREATURE) encode_other(me.get_battlefield(), option.target_index, row + OTHER);
+            if (option.target == MoveTarget::OPPONENT_CREATURE) encode_other(opponent.get_battlefield(), option.target_index, row + OTHER);
+            return;
+        default:
+            break;
+    }
+    switch (option.type) {
+        case MoveType::PLAY_LAND:
+            encode_card(me.get_hand()[option.index], row + CARD);
+            break;
+        case MoveType::CAST_SPELL: {
+            encode_card(me.get_hand()[option.index], row + CARD);
+            const auto& cast = static_cast<const spell&>(card_definition(me.get_hand()[option.index]));
+            row[MANA + 1] = (me.get_mana_pool().total() - cast.get_mana_cost().total()) / 10.0f;
+            row[EFFECT] = effect_for_caster(cast, option.target);
+            if (option.target == MoveTarget::MY_CREATURE) encode_other(me.get_battlefield(), option.target_index, row + OTHER);
+            if (option.target == MoveTarget::OPPONENT_CREATURE) encode_other(opponent.get_battlefield(), option.target_index, row + OTHER);
+            break;
+        }
+        case MoveType::TAP_LAND:
+            encode_permanent(me.get_battlefield(), option.index, row + CARD);
+            row[MANA] = adds_missing_mana(me, option.mana_color) ? 1.0f : 0.0f;
+            break;
+        case MoveType::ATTACK:
+            encode_permanent(me.get_battlefield(), option.index, row + CARD);
+            break;
+        case MoveType::BLOCK:
+            encode_permanent(me.get_battlefield(), option.index, row + CARD);
+            encode_other(opponent.get_battlefield(), option.attacker, row + OTHER);
+            break;
+        case MoveType::ORDER_BLOCKER:
+            encode_permanent(opponent.get_battlefield(), option.index, row + CARD);
+            encode_other(me.get_battlefield(), option.attacker, row + OTHER);
+            break;
+        default:
+            break;
+    }
+}
+
+linear_evaluator::linear_evaluator(std::vector<float> weights) : weights(std::move(weights)) {
+    if (!this->weights.empty()) {
+        this->weights.resize(WEIGHTS, 0.0f);
+        return;
+    }
+    this->weights.assign(WEIGHTS, 0.0f);
+    this->weights[MOVE_TYPE + static_cast<size_t>(MoveType::PLAY_LAND)] = 2.0f;
+    this->weights[MOVE_TYPE + static_cast<size_t>(MoveType::CAST_SPELL)] = 1.0f;
+    this->weights[MULLIGAN_FLAG] = -1.0f;
+    this->weights[TARGET + static_cast<size_t>(MoveTarget::OPPONENT_CREATURE)] = 0.3f;
+    this->weights[CARD] = 1.0f;
+    this->weights[CARD + 1] = 1.0f;
+    this->weights[OTHER + 1] = 1.0f;
+    this->weights[OTHER + 2] = -0.5f;
+    this->weights[MANA] = 3.0f;
+    this->weights[MANA + 1] = -2.0f;
+    this->weights[EFFECT] = 2.0f;
+}
+
+void linear_evaluator::evaluate(inference_batch& batch) {
+    constexpr size_t OPTION_FEATURES = state_encoder::OPTION_FEATURES;
+    constexpr size_t STATE_FEATURES = state_encoder::STATE_FEATURES;
+    const float* option_weights = weights.data();
+    const float* state_weights = option_weights + OPTION_FEATURES;
+    float bias = weights.back();
+    for (size_t i = 0; i < batch.size; i++) {
+        const float* state = batch.states + i * STATE_FEATURES;
+        float state_score = std::inner_product(state, state + STATE_FEATURES, state_weights, bias);
+        for (size_t option = batch.option_offsets[i]; option < batch.option_offsets[i + 1]; option++) {
+            const float* row = batch.options + option * OPTION_FEATURES;
+            batch.scores[option] = std::inner_product(row, row + OPTION_FEATURES, option_weights, state_score);
+        }
+    }
+    decisions += batch.size;
+}
+
+void batched_source::batch::clear() {
+    decisions.clear();
+    states.clear();
+    options.clear();
+    option_offsets.assign(1, 0);
+    scores.clear();
+}
+
+bool batched_source::decides(game& current) {
+    return network == nullptr || &current.get_deciding_player()->get_agent() == network;
+}
+
+bool batched_source::request(game& current, decision_reply& reply, std::coroutine_handle<> waiting) {
+    thread_local state_encoder encoder;
+    thread_local std::vector<float> state;
+    thread_local std::vector<float> rows;
+
+    waiting_decision decision{ &current, &reply, waiting, current.get_decision(), {} };
+    encoder.list_options(current, decision.options);
+    // nothing to choose from, e.g. no creature can attack
+    if (decision.options.empty()) {
+        reply_from_scores(decision, nullptr);
+        return true;
+    }
+    state.resize(state_encoder::STATE_FEATURES);
+    rows.resize(decision.options.size() * state_encoder::OPTION_FEATURES);
+    state_encoder::encode(current, decision.options, state.data(), rows.data());
+
+    bool full = false;
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        if (filling.decisions.empty()) {
+            filling.clear();
+            filling.first_queued = std::chrono::steady_clock::now();
+        }
+        filling.states.insert(filling.states.end(), state.begin(), state.end());
+        filling.options.insert(filling.options.end(), rows.begin(), rows.end());
+        filling.option_offsets.push_back(filling.option_offsets.back() + decision.options.size());
+        filling.decisions.push_back(std::move(decision));
+        full = filling.decisions.size() >= settings.max_batch;
+    }
+    if (full) flush();
+    return false;
+}
+
+bool batched_source::poll() {
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        if (filling.decisions.empty() || std::chrono::steady_clock::now() - filling.first_queued < settings.max_wait) return false;
+    }
+    return flush();
+}
+
+bool batched_source::flush() {
+    std::lock_guard<std::mutex> evaluating_guard(evaluating_lock);
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        // another thread may have taken the batch while this one waited for the model
+        if (filling.decisions.empty()) return false;
+        std::swap(filling, evaluating);
+    }
+
+    evaluating.scores.resize(evaluating.option_offsets.back());
+    inference_batch view;
+    view.size = evaluating.decisions.size();
+    view.states = evaluating.states.data();
+    view.options = evaluating.options.data();
+    view.option_offsets = evaluating.option_offsets.data();
+    view.scores = evaluating.scores.data();
+    evaluator.evaluate(view);
+    batches++;
+
+    for (size_t i = 0; i < evaluating.decisions.size(); i++) {
+        reply_from_scores(evaluating.decisions[i], evaluating.scores.data() + evaluating.option_offsets[i]);
+        scheduler.schedule(evaluating.decisions[i].waiting);
+    }
+    evaluating.clear();
+    return true;
+}
+
+size_t batched_source::size() const {
+    std::lock_guard<std::mutex> guard(lock);
+    return filling.decisions.size();
+}
+
+size_t batched_source::get_batches() const {
+    return batches;
+}
+
+void batched_source::reply_from_scores(waiting_decision& decision, const float* scores) {
+    decision_reply& reply = *decision.reply;
+    const std::vector<move>& options = decision.options;
+    size_t best = options.empty() ? 0 : static_cast<size_t>(std::max_element(scores, scores + options.size()) - scores);
+    switch (decision.decision) {
+        case DecisionType::MULLIGAN:
+            reply.mulligan = (best == 1);
+            break;
+        case DecisionType::MAIN_PHASE:
+            reply.chosen_move = options[best];
+            break;
+        case DecisionType::ATTACKERS:
+            reply.creatures.clear();
+            for (size_t i = 0; i < options.size(); i++) {
+                if (scores[i] > 0.0f) reply.creatures.push_back(options[i].index);
+            }
+            break;
+        case DecisionType::BLOCKERS: {
+            reply.blocks.clear();
+            // the blocks of a blocker are next to each other, it blocks the attacker it scores best against
+            for (size_t first = 0; first < options.size();) {
+                size_t last = first;
+                size_t chosen = first;
+                while (last < options.size() && options[last].index == options[first].index) {
+                    if (scores[last] > scores[chosen]) chosen = last;
+                    last++;
+                }
+                if (scores[chosen] > 0.0f) reply.blocks[options[chosen].attacker].push_back(options[chosen].index);
+                first = last;
+            }
+            break;
+        }
+        case DecisionType::ORDER_BLOCKERS: {
+            std::vector<size_t> order(options.size());
+            std::iota(order.begin(), order.end(), 0);
+            std::stable_sort(order.begin(), order.end(), [scores](size_t a, size_t b) { return scores[a] > scores[b]; });
+            reply.creatures.clear();
+            for (auto&& i : order) reply.creatures.push_back(options[i].index);
+            break;
+        }
+        case DecisionType::DISCARD:
+            reply.card = options[best].index;
+            break;
+        case DecisionType::TARGET:
+            reply.target = target_name(*decision.current, options.empty() ? move::pass() : options[best]);
+            break;
+        default:
+            break;
+    }
+}
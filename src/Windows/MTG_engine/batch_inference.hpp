@@ -0,0 +1,206 @@
+#ifndef MTG_ENGINE_BATCH_INFERENCE_H
+#define MTG_ENGINE_BATCH_INFERENCE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+#include <vector>
+#include "game_task.hpp"
+#include "move_generator.hpp"
+
+// encodes a decision for a model: the position as the deciding player sees it into STATE_FEATURES floats and every
+// option of the decision into OPTION_FEATURES floats, the model scores every option
+// the options of a decision (see list_options):
+// MULLIGAN: keeping the hand (PASS) and taking a mulligan (PASS with index 1)
+// MAIN_PHASE: the legal moves (see move_generator::main_phase)
+// ATTACKERS: an ATTACK move for every creature that can attack
+// BLOCKERS: a BLOCK move for every creature that can block and every attacker
+// ORDER_BLOCKERS: an ORDER_BLOCKER move for every blocker of the attacker
+// DISCARD: a PASS move for every card in the hand, index is the card
+// TARGET: a PASS move for every target the effect can have, with target and target_index set as in a CAST_SPELL move
+class state_encoder
+{
+public:
+	static constexpr size_t PLAYER_FEATURES = 18;
+	static constexpr size_t STATE_FEATURES = 7 + 7 + 1 + 3 + 2 * PLAYER_FEATURES;
+	static constexpr size_t OPTION_FEATURES = 7 + 2 + 5 + 5 + 4 + 2 + 1;
+
+	/**
+	* list the options of the pending decision of a game
+	* @param current the game
+	* @param options the options, replaced
+	**/
+	void list_options(game& current, std::vector<move>& options);
+
+	/**
+	* encode the pending decision of a game
+	* @param current the game
+	* @param options its options (see list_options)
+	* @param state STATE_FEATURES floats
+	* @param rows OPTION_FEATURES floats per option
+	**/
+	static void encode(game& current, const std::vector<move>& options, float* state, float* rows);
+
+private:
+	move_generator generator;
+
+	static void list_targets(const effect& eff, player& me, player& opponent, std::vector<move>& options);
+	static void encode_player(player& encoded, bool sees_hand, float* features);
+	static void encode_option(DecisionType decision, const move& option, player& me, player& opponent, float* row);
+};
+
+// the decisions of one flush: decision i has the state at states + i * STATE_FEATURES and the options
+// option_offsets[i] to option_offsets[i + 1], their rows are at options + option * OPTION_FEATURES
+struct inference_batch
+{
+	size_t size = 0;
+	const float* states = nullptr;
+	const float* options = nullptr;
+	const size_t* option_offsets = nullptr;
+	float* scores = nullptr;	// one per option, written by the evaluator
+};
+
+// the model behind a batched_source, e.g. a network on a GPU
+// evaluate is called by one thread at a time
+class batch_evaluator
+{
+public:
+	virtual ~batch_evaluator() = default;
+
+	/**
+	* score every option of a batch of decisions, the higher the better
+	* options that are chosen on their own (attackers, blocks) are taken if their score is above 0
+	* @param batch the decisions
+	**/
+	virtual void evaluate(inference_batch& batch) = 0;
+};
+
+// a CPU stand-in for a model: every score is the dot product of the option row and the state with a weight vector,
+// the default weights play a land, tap lands while a spell in the hand lacks their mana and cast the most expensive spells
+// (paying empties the mana pool), attack and block with every creature
+class linear_evaluator : public batch_evaluator
+{
+public:
+	static constexpr size_t WEIGHTS = state_encoder::OPTION_FEATURES + state_encoder::STATE_FEATURES + 1;
+
+	/**
+	* linear evaluator constructor
+	* @param weights option weights, then state weights, then the bias, the default weights if empty
+	**/
+	explicit linear_evaluator(std::vector<float> weights = {});
+
+	void evaluate(inference_batch& batch) override;
+
+	/**
+	* get the number of decisions scored so far
+	*
+	* @returns number of decisions
+	**/
+	size_t get_decisions() const {
+		return decisions;
+	}
+
+private:
+	std::vector<float> weights;
+	size_t decisions = 0;
+};
+
+struct batch_settings
+{
+	size_t max_batch = 256;							// a full batch is evaluated right away
+	std::chrono::microseconds max_wait{ 2000 };		// poll evaluates a batch whose first decision waited this long
+};
+
+// a decision source that collects the decisions of many games (see play_game) into batches for a model
+// a decision is encoded and queued, its game suspends, once the batch is full (or it waited long enough, see poll)
+// the model scores the whole batch at once and every game gets the reply of its best options and is scheduled again
+// request and poll can be called from the threads running the scheduler
+class batched_source : public decision_source
+{
+public:
+	/**
+	* batched source constructor
+	* @param evaluator the model
+	* @param scheduler where the games are scheduled once their decision is made
+	* @param network the agent of the players the model decides for, the agents of the other players decide for them,
+	* nullptr for every player, targets of effects are always asked from the agents
+	* @param settings size and deadline of the batches
+	**/
+	batched_source(batch_evaluator& evaluator, game_scheduler& scheduler, agent* network = nullptr, const batch_settings& settings = batch_settings())
+		: evaluator(evaluator), scheduler(scheduler), network(network), settings(settings) {}
+
+	bool decides(game& current) override;
+	bool request(game& current, decision_reply& reply, std::coroutine_handle<> waiting) override;
+
+	/**
+	* evaluate the queued decisions if the first of them waited for max_wait
+	*
+	* @returns true if a batch was evaluated
+	**/
+	bool poll();
+
+	/**
+	* evaluate the queued decisions now, e.g. when no game is left to fill the batch
+	*
+	* @returns true if a batch was evaluated
+	**/
+	bool flush();
+
+	/**
+	* get the number of queued decisions
+	*
+	* @returns number of decisions
+	**/
+	size_t size() const;
+
+	/**
+	* get the number of batches evaluated so far
+	*
+	* @returns number of batches
+	**/
+	size_t get_batches() const;
+
+private:
+	// a suspended game and where its reply goes
+	struct waiting_decision {
+		game* current = nullptr;
+		decision_reply* reply = nullptr;
+		std::coroutine_handle<> waiting;
+		DecisionType decision = DecisionType::NONE;
+		std::vector<move> options;
+	};
+
+	// the queued decisions, encoded
+	struct batch {
+		std::vector<waiting_decision> decisions;
+		std::vector<float> states;
+		std::vector<float> options;
+		std::vector<size_t> option_offsets;
+		std::vector<float> scores;
+		std::chrono::steady_clock::time_point first_queued;
+
+		void clear();
+	};
+
+	batch_evaluator& evaluator;
+	game_scheduler& scheduler;
+	agent* network;
+	batch_settings settings;
+
+	// filling is guarded by lock, evaluating by evaluating_lock, which is held while the model runs
+	mutable std::mutex lock;
+	batch filling;
+	std::mutex evaluating_lock;
+	batch evaluating;
+	std::atomic<size_t> batches = 0;
+
+	/**
+	* turn the scores of the options of a decision into a reply
+	* @param decision the decision
+	* @param scores one per option
+	**/
+	static void reply_from_scores(waiting_decision& decision, const float* scores);
+};
+
+#endif //MTG_ENGINE_BATCH_INFERENCE_H
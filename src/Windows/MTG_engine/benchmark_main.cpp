@@ -0,0 +1,403 @@
+// benchmark_main.cpp : times the hot paths of the engine and compares them with a checked-in baseline
+//
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "simulator.hpp"
+#include "binary_deck.hpp"
+#include "arena.hpp"
+#include "game.hpp"
+
+namespace {
+
+struct benchmark_result {
+    std::string name;
+    double ns_per_op = 0.0;
+    size_t iterations = 0;     // per repetition
+};
+
+struct benchmark_settings {
+    double min_seconds = 0.05;  // of one repetition
+    size_t repetitions = 7;
+    std::string filter;
+};
+
+// runs the operation of a benchmark n times
+using benchmark_body = std::function<void(size_t)>;
+
+// keeps the compiler from removing work whose result is never read
+template <typename T>
+void keep(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+/**
+* wrap an operation into a loop, the loop calls it directly so the timing has no call through std::function per operation
+* @param op the operation
+*
+* @returns the body of the benchmark
+**/
+template <typename Op>
+benchmark_body repeat(Op op) {
+    return [op](size_t n) mutable {
+        for (size_t i = 0; i < n; i++) {
+            op();
+        }
+    };
+}
+
+double seconds_of(const benchmark_body& body, size_t n) {
+    auto start = std::chrono::steady_clock::now();
+    body(n);
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+/**
+* time a benchmark: find a number of operations that takes at least min_seconds, then time that many repetitions times
+* the fastest repetition counts, other programs and frequency changes only ever make a repetition slower
+* @param name name of the benchmark
+* @param body the benchmark
+* @param settings how long and how often
+*
+* @returns the time of an operation in the fastest repetition
+**/
+benchmark_result measure(const std::string& name, const benchmark_body& body, const benchmark_settings& settings) {
+    size_t n = 1;
+    double seconds = seconds_of(body, n);
+    while (seconds < settings.min_seconds) {
+        // aim a bit over the minimum, at most 10 times more operations a round
+        double factor = seconds > 0.0 ? std::min(10.0, 1.2 * settings.min_seconds / seconds) : 10.0;
+        n = std::max(n + 1, static_cast<size_t>(n * factor));
+        seconds = seconds_of(body, n);
+    }
+
+    double fastest = seconds;
+    for (size_t i = 0; i < settings.repetitions; i++) {
+        fastest = std::min(fastest, seconds_of(body, n));
+    }
+    return { name, fastest * 1e9 / n, n };
+}
+
+void write_json(std::ostream& out, const std::vector<benchmark_result>& results) {
+    out << "{\n  \"benchmarks\": [\n";
+    for (size_t i = 0; i < results.size(); i++) {
+        out << "    {\"name\": \"" << results[i].name << "\", \"ns_per_op\": " << std::fixed << std::setprecision(1) << results[i].ns_per_op
+            << ", \"iterations\": " << results[i].iterations << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+}
+
+/**
+* read the times of a baseline written by write_json, only the names and times are read
+* throws std::runtime_error if the file can not be read
+* @param filename path to the baseline
+*
+* @returns time of an operation by name of the benchmark
+**/
+std::map<std::string, double> read_baseline(const std::string& filename) {
+    std::ifstream in(filename);
+    if (!in) {
+        throw std::runtime_error("can't read baseline: " + filename);
+    }
+    std::stringstream buffer;
+    buffer << in.rdbuf();
+    const std::string text = buffer.str();
+
+    std::map<std::string, double> ret;
+    const std::string name_key = "\"name\"";
+    const std::string time_key = "\"ns_per_op\"";
+    for (size_t at = text.find(name_key); at != std::string::npos; at = text.find(name_key, at)) {
+        size_t name_start = text.find('"', text.find(':', at) + 1) + 1;
+        size_t name_end = text.find('"', name_start);
+        size_t time_at = text.find(time_key, name_end);
+        if (name_start == 0 || name_end == std::string::npos || time_at == std::string::npos) {
+            throw std::runtime_error("damaged baseline: " + filename);
+        }
+        ret[text.substr(name_start, name_end - name_start)] = std::stod(text.substr(text.find(':', time_at) + 1));
+        at = time_at;
+    }
+    return ret;
+}
+
+/**
+* print the results next to the baseline
+* @param results the results
+* @param baseline time of an operation by name
+* @param tolerance how much slower than the baseline a benchmark may be, 0.2 for 20 %
+*
+* @returns number of benchmarks slower than the tolerance allows
+**/
+size_t compare(const std::vector<benchmark_result>& results, const std::map<std::string, double>& baseline, double tolerance) {
+    size_t regressions = 0;
+    std::cout << "\n" << std::left << std::setw(24) << "benchmark" << std::right << std::setw(14) << "baseline ns" << std::setw(14) << "ns"
+        << std::setw(10) << "ratio" << "\n";
+    for (auto&& result : results) {
+        std::cout << std::left << std::setw(24) << result.name << std::right << std::fixed << std::setprecision(1);
+        auto found = baseline.find(result.name);
+        if (found == baseline.end()) {
+            std::cout << std::setw(14) << "-" << std::setw(14) << result.ns_per_op << std::setw(10) << "-" << "  new\n";
+            continue;
+        }
+        double ratio = result.ns_per_op / found->second;
+        bool slower = ratio > 1.0 + tolerance;
+        if (slower) regressions++;
+        std::cout << std::setw(14) << found->second << std::setw(14) << result.ns_per_op << std::setw(10) << std::setprecision(3) << ratio
+            << (slower ? "  SLOWER" : "") << "\n";
+    }
+    return regressions;
+}
+
+// the states the benchmarks start from, built once from the deck
+struct fixtures {
+    std::string deck_file;
+    compiled_deck deck;
+    random_agent agent1{ 1 };
+    random_agent agent2{ 2 };
+    std::vector<card_id> creatures;     // of the deck, in the order of the deck
+    std::unique_ptr<game> board;        // main phase of the first turn, both players with untapped creatures
+    std::unique_ptr<game> middle;       // between two turns a few turns into a game
+
+    explicit fixtures(const std::string& deck_file) : deck_file(deck_file), deck(load_deck(deck_file)) {
+        for (auto&& id : deck.get_cards()) {
+            if (card_definition(id).get_type() == CardType::CREATURE) creatures.push_back(id);
+        }
+        if (creatures.empty()) {
+            throw std::runtime_error("the benchmarks need a deck with creatures: " + deck_file);
+        }
+
+        board = std::make_unique<game>("Player 1", "Player 2", deck.instantiate(), deck.instantiate(), &agent1, &agent2, 7);
+        board->start_game();
+        board->step();
+        if (board->get_decision() != DecisionType::MAIN_PHASE) {
+            throw std::runtime_error("the first turn of the benchmark game didn't reach its main phase");
+        }
+        for (player* owner : { board->get_active_player(), board->get_non_active_player() }) {
+            for (size_t i = 0; i < BOARD_CREATURES; i++) {
+                owner->get_battlefield().add(creatures[i % creatures.size()]);
+            }
+            owner->get_battlefield().untap_all();
+        }
+
+        middle = std::make_unique<game>("Player 1", "Player 2", deck.instantiate(), deck.instantiate(), &agent1, &agent2, 11);
+        middle->start_game();
+        for (size_t i = 0; i < MIDDLE_TURNS && !middle->is_ended(); i++) {
+            middle->turn();
+        }
+        if (middle->is_ended()) {
+            throw std::runtime_error("the benchmark game ended too soon");
+        }
+    }
+
+    static constexpr size_t BOARD_CREATURES = 6;
+    static constexpr size_t MIDDLE_TURNS = 6;
+};
+
+/**
+* build the benchmarks, the names are the keys of the baseline
+* @param data the states they start from
+*
+* @returns the benchmarks by name, in the order they run
+**/
+std::vector<std::pair<std::string, benchmark_body>> make_benchmarks(fixtures& data) {
+    std::vector<std::pair<std::string, benchmark_body>> ret;
+
+    // a deck file read with the parser of IniParser::IniData and with the one load_deck uses
+    ret.emplace_back("ini_parse", repeat([&data]() {
+        IniParser parser;
+        IniParser::IniData parsed = parser.parseIniFile(data.deck_file);
+        keep(parsed.size());
+    }));
+    ret.emplace_back("ini_document", repeat([&data]() {
+        IniDocument document = IniDocument::fromFile(data.deck_file);
+        keep(document.empty());
+    }));
+
+    // a deck loaded into the catalog and a game-ready copy of it
+    ret.emplace_back("load_deck", repeat([&data]() {
+        compiled_deck loaded = load_deck(data.deck_file);
+        keep(loaded.get_cards().size());
+    }));
+    ret.emplace_back("deck_instantiate", repeat([&data, arena = std::make_shared<game_arena>()]() {
+        deck instance = data.deck.instantiate(arena->get_resource());
+        keep(instance.library.data());
+        arena->reset();
+    }));
+
+    // every spell of the deck against pools from empty to plenty
+    std::vector<std::pair<mana, mana_cost>> payments;
+    for (unsigned lands = 0; lands < 8; lands++) {
+        for (auto&& id : data.deck.get_cards()) {
+            const card& definition = card_definition(id);
+            if (definition.get_type() == CardType::LAND) continue;
+            mana pool;
+            pool.add(color::R, lands / 2 + lands % 2);
+            pool.add(color::G, lands / 2);
+            payments.emplace_back(pool, static_cast<const spell&>(definition).get_mana_cost());
+        }
+    }
+    ret.emplace_back("can_pay", repeat([payments, i = size_t{0}]() mutable {
+        const auto& [pool, cost] = payments[i];
+        keep(can_pay(pool, cost));
+        if (++i == payments.size()) i = 0;
+    }));
+
+    // the library of a player after the starting hand
+    ret.emplace_back("shuffle", repeat([owner = std::make_shared<player>(*data.middle->get_active_player(), std::pmr::get_default_resource()),
+        gen = game_rng(5)]() mutable {
+        owner->shuffle(gen);
+        keep(owner->get_library().data());
+    }));
+
+    // what a search pays for every copy it plays from
+    ret.emplace_back("game_copy", repeat([&data, arena = std::make_shared<game_arena>()]() {
+        {
+            game copy(*data.board, arena->get_resource());
+            keep(copy.get_turn_number());
+        }
+        arena->reset();
+    }));
+
+    // every creature attacks and is blocked by one, both die (game::resolve_blocks, game::check_deaths), includes game_copy
+    std::vector<size_t> attackers;
+    std::map<size_t, std::vector<size_t>> blocks;
+    for (size_t i = 0; i < fixtures::BOARD_CREATURES; i++) {
+        attackers.push_back(i);
+        blocks[i] = { i };
+    }
+    {
+        game trial(*data.board, std::pmr::get_default_resource());
+        trial.step(move::pass());
+        bool attacked = trial.get_decision() == DecisionType::ATTACKERS && trial.step(attackers);
+        if (!attacked || !trial.step(blocks) || trial.get_active_player()->get_graveyard().size() != fixtures::BOARD_CREATURES) {
+            throw std::runtime_error("the creatures of the benchmark deck don't trade in combat");
+        }
+    }
+    ret.emplace_back("combat", repeat([&data, attackers, blocks, arena = std::make_shared<game_arena>()]() {
+        {
+            game copy(*data.board, arena->get_resource());
+            copy.step(move::pass());
+            copy.step(attackers);
+            copy.step(blocks);
+            keep(copy.get_active_player()->get_graveyard().size());
+        }
+        arena->reset();
+    }));
+
+    // half of the creatures of a player die (player::send_dead_to_graveyard), includes a copy of the player
+    ret.emplace_back("check_deaths", repeat([&data, arena = std::make_shared<game_arena>()]() {
+        {
+            player copy(*data.board->get_active_player(), arena->get_resource());
+            for (size_t i = 0; i < fixtures::BOARD_CREATURES; i += 2) {
+                copy.damage_creature(i, copy.get_battlefield().get_health(i));
+            }
+            copy.send_dead_to_graveyard();
+            keep(copy.get_graveyard().size());
+        }
+        arena->reset();
+    }));
+
+    // the same turn of the middle of a game, the agents make the same decisions every time, includes game_copy
+    ret.emplace_back("scripted_turn", repeat([&data, arena = std::make_shared<game_arena>()]() {
+        {
+            game copy(*data.middle, arena->get_resource());
+            data.agent1.reseed(3);
+            data.agent2.reseed(4);
+            copy.turn();
+            keep(copy.get_turn_number());
+        }
+        arena->reset();
+    }));
+
+    // whole games of random agents, the same 16 games over and over
+    ret.emplace_back("full_game", repeat([&data, seed = std::uint64_t{0}]() mutable {
+        simulation_result result;
+        data.agent1.reseed(seed);
+        data.agent2.reseed(seed + 1);
+        simulator::play_game(data.deck, data.deck, data.agent1, data.agent2, 1000 + seed, result);
+        keep(result.turns);
+        seed = (seed + 1) % 16;
+    }));
+
+    return ret;
+}
+
+void print_usage() {
+    std::cout << "usage: MTG_benchmark [--filter TEXT] [--min-time SECONDS] [--repetitions N] [--json FILE] [--baseline FILE] [--tolerance RATIO] [deck.ini|.mtgd]\n";
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+    benchmark_settings settings;
+    std::string json_file;
+    std::string baseline_file;
+    double tolerance = 0.2;
+    std::string deck_file = "decks/red.ini";
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--filter" && i + 1 < argc) {
+            settings.filter = argv[++i];
+        } else if (arg == "--min-time" && i + 1 < argc) {
+            settings.min_seconds = std::stod(argv[++i]);
+        } else if (arg == "--repetitions" && i + 1 < argc) {
+            settings.repetitions = std::stoul(argv[++i]);
+        } else if (arg == "--json" && i + 1 < argc) {
+            json_file = argv[++i];
+        } else if (arg == "--baseline" && i + 1 < argc) {
+            baseline_file = argv[++i];
+        } else if (arg == "--tolerance" && i + 1 < argc) {
+            tolerance = std::stod(argv[++i]);
+        } else if (arg.rfind("--", 0) == 0) {
+            print_usage();
+            return 1;
+        } else {
+            deck_file = arg;
+        }
+    }
+
+    try {
+        set_game_log(nullptr);
+        fixtures data(deck_file);
+        std::vector<benchmark_result> results;
+        for (auto&& [name, body] : make_benchmarks(data)) {
+            if (name.find(settings.filter) == std::string::npos) continue;
+            results.push_back(measure(name, body, settings));
+            std::cerr << name << ": " << std::fixed << std::setprecision(1) << results.back().ns_per_op << " ns\n";
+        }
+
+        if (!json_file.empty()) {
+            std::ofstream out(json_file);
+            if (!out) {
+                throw std::runtime_error("can't write results: " + json_file);
+            }
+            write_json(out, results);
+        } else if (baseline_file.empty()) {
+            write_json(std::cout, results);
+        }
+
+        if (!baseline_file.empty()) {
+            size_t regressions = compare(results, read_baseline(baseline_file), tolerance);
+            std::cout << "slower than the baseline by more than " << std::setprecision(0) << tolerance * 100 << " %: " << regressions << "\n";
+            return regressions == 0 ? 0 : 2;
+        }
+        return 0;
+    } catch (const std::exception& e) {
+        std::cout << e.what() << "\n";
+        return 1;
+    }
+}
@@ -0,0 +1,195 @@
+#include "binary_deck.hpp"
+#include "card_catalog.hpp"
+
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace {
+
+constexpr char MAGIC[4] = { 'M', 'T', 'G', 'D' };
+constexpr size_t HEADER_SIZE = 8 * 4;
+constexpr size_t N_OF_STRINGS = 6;
+constexpr size_t CARD_SIZE = 3 * 4 + N_OF_STRINGS * 2 * 4;
+
+std::uint32_t read_u32(const std::byte* bytes) {
+    return static_cast<std::uint32_t>(bytes[0])
+        | (static_cast<std::uint32_t>(bytes[1]) << 8)
+        | (static_cast<std::uint32_t>(bytes[2]) << 16)
+        | (static_cast<std::uint32_t>(bytes[3]) << 24);
+}
+
+void write_u32(std::ostream& out, std::uint32_t value) {
+    const char bytes[4] = {
+        static_cast<char>(value & 0xFF), static_cast<char>((value >> 8) & 0xFF),
+        static_cast<char>((value >> 16) & 0xFF), static_cast<char>((value >> 24) & 0xFF)
+    };
+    out.write(bytes, 4);
+}
+
+}
+
+binary_deck::binary_deck(const std::string& filename) : file(filename) {
+    const std::byte* data = file.data();
+    const size_t size = file.size();
+    if (size < HEADER_SIZE || std::memcmp(data, MAGIC, 4) != 0) {
+        throw std::runtime_error("not a binary deck: " + filename);
+    }
+    if (read_u32(data + 4) != BINARY_DECK_VERSION) {
+        throw std::runtime_error("unsupported binary deck version: " + filename);
+    }
+    n_of_cards = read_u32(data + 8);
+    n_of_library = read_u32(data + 12);
+    const std::uint64_t cards_offset = read_u32(data + 16);
+    const std::uint64_t library_offset = read_u32(data + 20);
+    const std::uint64_t strings_offset = read_u32(data + 24);
+    const std::uint64_t strings_size = read_u32(data + 28);
+    if (cards_offset + n_of_cards * CARD_SIZE > size
+        || library_offset + n_of_library * 4 > size
+        || strings_offset + strings_size > size) {
+        throw std::runtime_error("damaged binary deck: " + filename);
+    }
+    cards = data + cards_offset;
+    library = data + library_offset;
+    strings = reinterpret_cast<const char*>(data + strings_offset);
+
+    // check every reference once, card() and library_card() trust them afterwards
+    for (size_t i = 0; i < n_of_cards; i++) {
+        const std::byte* record = cards + i * CARD_SIZE;
+        if (read_u32(record) > static_cast<std::uint32_t>(CardType::SORCERY)) {
+            throw std::runtime_error("damaged binary deck: " + filename);
+        }
+        for (size_t j = 0; j < N_OF_STRINGS; j++) {
+            const std::uint64_t offset = read_u32(record + 12 + j * 8);
+            const std::uint64_t length = read_u32(record + 16 + j * 8);
+            if (offset + length > strings_size) {
+                throw std::runtime_error("damaged binary deck: " + filename);
+            }
+        }
+    }
+    for (size_t i = 0; i < n_of_library; i++) {
+        if (library_card(i) >= n_of_cards) {
+            throw std::runtime_error("damaged binary deck: " + filename);
+        }
+    }
+}
+
+card_record binary_deck::card(size_t index) const {
+    const std::byte* record = cards + index * CARD_SIZE;
+    auto string_at = [this, record](size_t field) {
+        return std::string_view(strings + read_u32(record + 12 + field * 8), read_u32(record + 16 + field * 8));
+    };
+
+    card_record ret;
+    ret.type = static_cast<CardType>(read_u32(record));
+    ret.power = static_cast<std::int32_t>(read_u32(record + 4));
+    ret.toughness = static_cast<std::int32_t>(read_u32(record + 8));
+    ret.name = string_at(0);
+    ret.subtype = string_at(1);
+    ret.cost = string_at(2);
+    ret.colors = string_at(3);
+    ret.ability = string_at(4);
+    ret.effect = string_at(5);
+    return ret;
+}
+
+std::uint32_t binary_deck::library_card(size_t index) const {
+    return read_u32(library + index * 4);
+}
+
+bool binary_deck::is_binary_deck(const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary);
+    char magic[4] = {};
+    return file.read(magic, 4) && std::memcmp(magic, MAGIC, 4) == 0;
+}
+
+void binary_deck::write(const IniParser::IniData& deck_data, std::ostream& out) {
+    std::vector<card_record> unique_cards;
+    std::unordered_map<std::string_view, std::uint32_t> card_indices;
+    std::vector<std::uint32_t> library_cards;
+    for (auto&& [section, args] : deck_data) {
+        card_record record = card_factory::to_card_record(args);
+        auto [it, inserted] = card_indices.emplace(record.name, static_cast<std::uint32_t>(unique_cards.size()));
+        if (inserted) {
+            unique_cards.push_back(record);
+        }
+        library_cards.push_back(it->second);
+    }
+
+    std::string strings;
+    std::unordered_map<std::string_view, std::uint32_t> string_offsets;
+    auto add_string = [&strings, &string_offsets](std::string_view text) {
+        auto it = string_offsets.find(text);
+        if (it != string_offsets.end()) {
+            return it->second;
+        }
+        std::uint32_t offset = static_cast<std::uint32_t>(strings.size());
+        strings += text;
+        string_offsets.emplace(text, offset);
+        return offset;
+    };
+
+    const std::uint32_t cards_offset = static_cast<std::uint32_t>(HEADER_SIZE);
+    const std::uint32_t library_offset = cards_offset + static_cast<std::uint32_t>(unique_cards.size() * CARD_SIZE);
+    const std::uint32_t strings_offset = library_offset + static_cast<std::uint32_t>(library_cards.size() * 4);
+
+    std::vector<std::array<std::uint32_t, N_OF_STRINGS>> string_refs;
+    for (auto&& record : unique_cards) {
+        string_refs.push_back({ add_string(record.name), add_string(record.subtype), add_string(record.cost),
+            add_string(record.colors), add_string(record.ability), add_string(record.effect) });
+    }
+
+    out.write(MAGIC, 4);
+    write_u32(out, BINARY_DECK_VERSION);
+    write_u32(out, static_cast<std::uint32_t>(unique_cards.size()));
+    write_u32(out, static_cast<std::uint32_t>(library_cards.size()));
+    write_u32(out, cards_offset);
+    write_u32(out, library_offset);
+    write_u32(out, strings_offset);
+    write_u32(out, static_cast<std::uint32_t>(strings.size()));
+
+    for (size_t i = 0; i < unique_cards.size(); i++) {
+        const card_record& record = unique_cards[i];
+        const std::string_view fields[N_OF_STRINGS] = { record.name, record.subtype, record.cost, record.colors, record.ability, record.effect };
+        write_u32(out, static_cast<std::uint32_t>(record.type));
+        write_u32(out, static_cast<std::uint32_t>(record.power));
+        write_u32(out, static_cast<std::uint32_t>(record.toughness));
+        for (size_t j = 0; j < N_OF_STRINGS; j++) {
+            write_u32(out, string_refs[i][j]);
+            write_u32(out, static_cast<std::uint32_t>(fields[j].size()));
+        }
+    }
+    for (auto&& index : library_cards) {
+        write_u32(out, index);
+    }
+    out.write(strings.data(), static_cast<std::streamsize>(strings.size()));
+}
+
+compiled_deck load_deck(const std::string& filename) {
+    if (binary_deck::is_binary_deck(filename)) {
+        binary_deck binary(filename);
+        card_catalog& catalog = card_catalog::global();
+        std::vector<card_id> ids(binary.card_count());
+        for (size_t i = 0; i < binary.card_count(); i++) {
+            ids[i] = catalog.intern(binary.card(i));
+        }
+
+        std::vector<card_id> cards;
+        cards.reserve(binary.library_size());
+        for (size_t i = 0; i < binary.library_size(); i++) {
+            cards.push_back(ids[binary.library_card(i)]);
+        }
+        if (cards.empty()) {
+            throw std::runtime_error("empty or missing deck: " + filename);
+        }
+        return compiled_deck(std::move(cards));
+    }
+
+    IniDocument document = IniDocument::fromFile(filename);
+    if (document.empty()) {
+        throw std::runtime_error("empty or missing deck: " + filename);
+    }
+    return compiled_deck(document);
+}
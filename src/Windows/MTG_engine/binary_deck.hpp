@@ -0,0 +1,99 @@
+#ifndef MTG_ENGINE_BINARY_DECK_H
+#define MTG_ENGINE_BINARY_DECK_H
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include "INI_parser.hpp"
+#include "card_factory.hpp"
+#include "deck.hpp"
+#include "mapped_file.hpp"
+
+/**
+* version of the binary deck format written by binary_deck::write, files of other versions are rejected
+**/
+constexpr std::uint32_t BINARY_DECK_VERSION = 1;
+
+// a deck (or a pool of cards) compiled by MTG_deck_compiler and read in place from a memory mapped file
+//
+// all numbers are little endian 32 bit
+//   header:  "MTGD", version, card count, library size, offset of cards, offset of library, offset of strings, size of strings
+//   cards:   every different card once, type, power, toughness and the name, subtype, cost, colors, ability and effect
+//            as an offset into the strings and a length
+//   library: index into the cards for every card of the deck, in the order of the deck file
+//   strings: the text of all cards, without separators
+class binary_deck
+{
+public:
+	/**
+	* maps a binary deck file and checks that it is valid
+	* throws std::runtime_error if the file can not be read, is not a binary deck, has another version or is damaged
+	* @param filename path to the file
+	**/
+	explicit binary_deck(const std::string& filename);
+
+	/**
+	* get the number of different cards in the file
+	*
+	* @returns number of cards
+	**/
+	size_t card_count() const { return n_of_cards; }
+
+	/**
+	* get the fields of a card, the views point into the mapped file and are valid while the binary_deck lives
+	* @param index index of the card, less than card_count()
+	*
+	* @returns the fields of the card
+	**/
+	card_record card(size_t index) const;
+
+	/**
+	* get the number of cards in the deck
+	*
+	* @returns number of cards
+	**/
+	size_t library_size() const { return n_of_library; }
+
+	/**
+	* get a card of the deck
+	* @param index position in the deck, less than library_size()
+	*
+	* @returns index of the card for card()
+	**/
+	std::uint32_t library_card(size_t index) const;
+
+	/**
+	* checks if a file starts like a binary deck
+	* @param filename path to the file
+	*
+	* @returns true for binary decks, false for INI files or files that can not be opened
+	**/
+	static bool is_binary_deck(const std::string& filename);
+
+	/**
+	* compiles a parsed INI deck into the binary format
+	* throws std::out_of_range if a card misses a field its type needs
+	* @param deck_data data of the deck
+	* @param out stream to write to, opened in binary mode
+	**/
+	static void write(const IniParser::IniData& deck_data, std::ostream& out);
+
+private:
+	mapped_file file;
+	size_t n_of_cards = 0;
+	size_t n_of_library = 0;
+	const std::byte* cards = nullptr;
+	const std::byte* library = nullptr;
+	const char* strings = nullptr;
+};
+
+/**
+* loads a deck from a binary deck file or an INI file, interning its cards into the global card_catalog
+* throws std::runtime_error if the file is missing, empty or not a valid deck
+* @param filename path to the deck
+*
+* @returns the compiled deck
+**/
+compiled_deck load_deck(const std::string& filename);
+
+#endif //MTG_ENGINE_BINARY_DECK_H
@@ -7,27 +7,16 @@
 #include <map>
 #include "effect.hpp"
 #include "ability.hpp"
-#include "damagable.hpp"
 #include "effect_factory.hpp"
+#include "types.hpp"
+#include "mana.hpp"
 
+// cards are immutable definitions shared by every game (see card_catalog),
+// the state of a card in a game (tapped, health, ...) is in the zones of the player (see battlefield_zone)
 class card
 {
 public:
-	card(std::string name, std::string type) : name(std::move(name)), type(std::move(type)) {}
-
-	/**
-	* taps the card
-	**/
-	void tap() {
-		tapped = true;
-	}
-
-	/**
-	* untaps the card
-	**/
-	void untap() {
-		tapped = false;
-	}
+	card(std::string name, CardType type) : name(std::move(name)), type(type) {}
 
 	/**
 	* checks if two cards are the same
@@ -47,7 +36,7 @@ public:
 	* 
 	* @returns name
 	**/
-	std::string get_name() {
+	const std::string& get_name() const {
 		return name;
 	}
 
@@ -56,57 +45,22 @@ public:
 	* 
 	* @returns type
 	**/
-	std::string get_type() {
+	CardType get_type() const {
 		return type;
 	}
 
-	/**
-	* checks if the card is tapped
-	* 
-	* @returns true if the card is tapped
-	**/
-	bool is_tapped() const {
-		return tapped;
-	}
-
-	/**
-	* set the tapped state of the card
-	* 
-	* @param set_to
-	**/
-	void set_tapped(bool set_to) {
-		tapped = set_to;
-	}
-
-	/**
-	* get the owner of the card
-	* 
-	* @returns owner
-	**/
-	player* get_owner() {
-		return owner;
-	}
-
-	/**
-	* set the owner of the card
-	* @param this_owner
-	**/
-	void set_owner(player* this_owner) {
-		owner = this_owner;
-	}
-
 private:
 	std::string name;
-	std::string type;
-	bool tapped = false;
-	player* owner;
+	CardType type;
 };
 
 class land : public card
 {
 public:
-	land(const std::string& name, const std::string& type, const std::string& subtype, std::string color_string) : card(name, type) {
-		taps_for = string_to_color_map(color_string);
+	land(const std::string& name, const std::string& subtype, std::string_view colors_string) : card(name, CardType::LAND), subtype(subtype), taps_for(color_set::parse(colors_string)) {
+		if (taps_for.empty()) {
+			throw ("land without a color");
+		}
 	}
 	
 	/**
@@ -114,16 +68,16 @@ public:
 	* 
 	* @returns subtype
 	**/
-	std::string get_subtype() {
+	const std::string& get_subtype() const {
 		return subtype;
 	}
 
 	/**
-	* get the color of the land
+	* get the colors the land can tap for, one of them per tap
 	* 
-	* @returns color
+	* @returns colors
 	**/
-	color get_taps_for() const {
+	color_set get_taps_for() const {
 		return taps_for;
 	}
 
@@ -131,7 +85,7 @@ public:
 
 private:
 	std::string subtype;
-	color taps_for;
+	color_set taps_for;
 };
 
 class spell : public card
@@ -147,23 +101,32 @@ public:
 	spell(const spell&) = delete;
 	spell& operator=(const spell&) = delete;
 
-	spell(const std::string&  name, const std::string&  type, std::string cost) : card(name, type), cost(std::move(cost)){}
+	spell(const std::string&  name, CardType type, std::string cost) : card(name, type), cost(std::move(cost)), compiled_cost(mana_cost::parse(this->cost)) {}
 
 	/**
 	* get the cost of the spell
 	* 
 	* @returns cost
 	**/
-	std::string get_cost() {
+	const std::string& get_cost() const {
 		return cost;
 	}
 
+	/**
+	* get the cost of the spell compiled when the card was loaded
+	* 
+	* @returns cost
+	**/
+	const mana_cost& get_mana_cost() const {
+		return compiled_cost;
+	}
+
 	/**
 	* get the effects of the spell
 	* 
 	* @returns effects
 	**/
-	std::vector<std::unique_ptr<effect>>& get_effects() {
+	const std::vector<std::unique_ptr<effect>>& get_effects() const {
 		return my_effects;
 	}
 
@@ -173,12 +136,13 @@ protected:
 
 private:
 	std::string cost;
+	mana_cost compiled_cost;
 };
 
 class instant : public spell
 {
 public:
-	instant(const std::string& name, const std::string& type, std::string cost, std::string effects) : spell(name, type, cost) {
+	instant(const std::string& name, std::string cost, std::string effects) : spell(name, CardType::INSTANT, cost) {
 		my_effects.push_back(std::move(effect_factory::create_effect(effects)));
 	}
 
@@ -188,7 +152,7 @@ public:
 class sorcery : public spell
 {
 public:
-	sorcery(const std::string& name, const std::string& type, std::string cost, std::string effects) : spell(name, type, cost) {
+	sorcery(const std::string& name, std::string cost, std::string effects) : spell(name, CardType::SORCERY, cost) {
 		my_effects.push_back(std::move(effect_factory::create_effect(effects)));
 	}
 
@@ -198,41 +162,19 @@ public:
 class permanent : public spell
 {
 public:
-    permanent(const std::string& type, const std::string&  name, const std::string&  cost) : spell(name,type,cost) {}
+    permanent(const std::string&  name, CardType type, const std::string&  cost) : spell(name,type,cost) {}
 };
 
-class creature : public permanent, public damagable
+class creature : public permanent
 {
 public:
-    creature(const std::string &name, const std::string &type,
+    creature(const std::string &name,
 		std::string subtype, const std::string &cost, 
 		const int power, const int toughness, std::string abilities, std::string effects
-		) : permanent(type, name, cost), power(power), toughness(toughness), subtype(std::move(subtype)){
-        health = toughness;
+		) : permanent(name, CardType::CREATURE, cost), power(power), toughness(toughness), subtype(std::move(subtype)){
 		my_effects.push_back(std::move(effect_factory::create_effect(effects)));
     }
 
-	/**
-	* get the name of the creature
-	* 
-	* @returns name
-	**/
-	std::string get_damagable_name() override {
-		return get_name();
-	}
-
-	/**
-	* deals damage to the creature
-	* @param amount
-	**/
-	void deal_damage(int amount) override {
-		health -= amount;
-		if (health <= 0) {
-			dead = true;
-		}
-	}
-
-	
     std::map<std::string, std::function<void(ability*)>> my_ability;
 
 	/**
@@ -240,7 +182,7 @@ public:
 	* 
 	* @returns subtype
 	**/
-	std::string get_subtype() {
+	const std::string& get_subtype() const {
 		return subtype;
 	}
 
@@ -262,58 +204,10 @@ public:
 		return toughness;
 	}
 
-	/**
-	* get the health (different from toughness in that toughness is static and the starting value to which it gets healed) of the creature
-	* 
-	* @returns health
-	**/
-	int get_health() const {
-		return health;
-	}
-
-	/**
-	* get the summoning sickness of the creature
-	* 
-	* @returns true if the creature has summoning sickness
-	**/
-	bool get_summoning_sickness() const {
-		return summoning_sickness;
-	}
-
-	/**
-	* set the summoning sickness of the creature
-	* 
-	* @param set_to
-	**/
-	void set_summoning_sickness(bool set_to) {
-		summoning_sickness = set_to;
-	}
-
-	/**
-	* set the health of the creature
-	* 
-	* @param set_to
-	**/
-	void set_health(int set_to) {
-		health = set_to;
-	}
-
-	/**
-	* get the dead state of the creature
-	* 
-	* @returns true if the creature is dead
-	**/
-	bool get_dead() const {
-		return dead;
-	}
-
 private:
-	bool summoning_sickness = true;
 	int power;
 	int toughness;
-	int health;
 	std::string subtype;
-	bool dead = false;
 };
 
 class enchantment : public permanent
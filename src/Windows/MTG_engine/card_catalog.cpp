@@ -0,0 +1,39 @@
+#include "card_catalog.hpp"
+
+#include <stdexcept>
+
+card_catalog& card_catalog::global() {
+    static card_catalog catalog;
+    return catalog;
+}
+
+card_id card_catalog::intern(const std::map<std::string, std::string>& args) {
+    return intern(card_factory::to_card_record(args));
+}
+
+card_id card_catalog::intern(const card_record& record) {
+    std::lock_guard<std::mutex> lock(intern_lock);
+    auto it = ids.find(record.name);
+    if (it != ids.end()) {
+        return it->second;
+    }
+
+    std::unique_ptr<card> definition = factory.create_card(record);
+    // a record read from a binary deck skips the checks of card_factory::to_card_record
+    if (!definition) {
+        throw std::invalid_argument("can't create a card of this type: " + std::string(record.name));
+    }
+    card_id id = static_cast<card_id>(definitions.size());
+    definitions.push_back(std::move(definition));
+    ids.emplace(std::string(record.name), id);
+    return id;
+}
+
+bool card_catalog::find(std::string_view name, card_id& id) const {
+    auto it = ids.find(name);
+    if (it == ids.end()) {
+        return false;
+    }
+    id = it->second;
+    return true;
+}
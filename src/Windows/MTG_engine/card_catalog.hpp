@@ -0,0 +1,99 @@
+#ifndef MTG_ENGINE_CARD_CATALOG_H
+#define MTG_ENGINE_CARD_CATALOG_H
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "card_factory.hpp"
+
+/**
+* index of a card definition in the card_catalog
+**/
+using card_id = std::uint32_t;
+
+// every card definition loaded from the deck files, each one exactly once, looked up by card_id
+class card_catalog
+{
+public:
+	/**
+	* get the catalog shared by all games
+	*
+	* @returns the catalog
+	**/
+	static card_catalog& global();
+
+	/**
+	* get the id of a card, creates the definition the first time its name is seen
+	* load every deck before starting games on other threads, lookups during games are not locked
+	* @param args key-value pairs of the card from the deck file
+	*
+	* @returns the id
+	**/
+	card_id intern(const std::map<std::string, std::string>& args);
+
+	/**
+	* get the id of a card, creates the definition the first time its name is seen
+	* throws std::invalid_argument if the card_factory can't create cards of its type
+	* @param record fields of the card
+	*
+	* @returns the id
+	**/
+	card_id intern(const card_record& record);
+
+	/**
+	* find the id of a card by name
+	* @param name name of the card
+	* @param id set to the id of the card if it was found
+	*
+	* @returns true if the card is in the catalog
+	**/
+	bool find(std::string_view name, card_id& id) const;
+
+	/**
+	* get the definition of a card
+	* @param id id of the card
+	*
+	* @returns the definition
+	**/
+	const card& get(card_id id) const {
+		return *definitions[id];
+	}
+
+	/**
+	* get the number of definitions
+	*
+	* @returns number of definitions
+	**/
+	size_t size() const {
+		return definitions.size();
+	}
+
+private:
+	std::vector<std::unique_ptr<card>> definitions;
+	// hashes std::string and std::string_view the same, so names can be looked up without a copy
+	struct name_hash {
+		using is_transparent = void;
+		size_t operator()(std::string_view name) const { return std::hash<std::string_view>{}(name); }
+	};
+
+	std::unordered_map<std::string, card_id, name_hash, std::equal_to<>> ids;
+	card_factory factory;
+	std::mutex intern_lock;
+};
+
+/**
+* get the definition of a card from the global catalog
+* @param id id of the card
+*
+* @returns the definition
+**/
+inline const card& card_definition(card_id id) {
+	return card_catalog::global().get(id);
+}
+
+#endif //MTG_ENGINE_CARD_CATALOG_H
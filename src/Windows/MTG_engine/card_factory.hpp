@@ -1,66 +1,167 @@
 #ifndef MTG_ENGINE_CARD_FACTORY_H
 #define MTG_ENGINE_CARD_FACTORY_H
 
+#include <charconv>
 #include <functional>
 #include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
 #include <unordered_map>
 #include "card.hpp"
+#include "INI_parser.hpp"
 
 const std::string PLACEHOLDER = "";
 
+/**
+* the fields of one card as written in a deck file, views into the parsed INI data or a binary deck file
+* fields a card type does not use are empty
+**/
+struct card_record {
+	std::string_view name;
+	CardType type = CardType::LAND;
+	std::string_view subtype;
+	std::string_view cost;
+	std::string_view colors;
+	std::string_view ability;
+	std::string_view effect;
+	int power = 0;
+	int toughness = 0;
+};
+
 class card_factory {
 	using fun_map = const std::map<std::string, std::string>&;
-	using creator_func = std::function<std::unique_ptr<card>(const std::map<std::string, std::string>&)>;
+	using creator_func = std::function<std::unique_ptr<card>(const card_record&)>;
 
 	/**
 	* Registry of card creators for create_card
 	**/
-	std::unordered_map<std::string, creator_func> registry;
+	std::unordered_map<CardType, creator_func> registry;
 
 public:
 	/**
 	* Default constructor
 	**/
 	card_factory() {
-		registry["creature"] = [](const std::map<std::string, std::string>& args) {
-			auto ab_it = args.find("Ability");
-			auto ef_it = args.find("Effect");
-
-			if (ab_it == args.end() && ef_it == args.end()) {
-				return std::make_unique<creature>(args.at("Name"), args.at("Type"), args.at("Subtype"), args.at("ManaCost"), std::stoi(args.at("Power")), std::stoi(args.at("Toughness")), PLACEHOLDER, PLACEHOLDER);
-			} else if (ef_it == args.end()) {
-				return std::make_unique<creature>(args.at("Name"), args.at("Type"), args.at("Subtype"), args.at("ManaCost"), std::stoi(args.at("Power")), std::stoi(args.at("Toughness")), args.at("Ability"), PLACEHOLDER);
-			} else if (ab_it == args.end()) {
-				return std::make_unique<creature>(args.at("Name"), args.at("Type"), args.at("Subtype"), args.at("ManaCost"), std::stoi(args.at("Power")), std::stoi(args.at("Toughness")), PLACEHOLDER, args.at("Effect"));
-			} else {
-				return std::make_unique<creature>(args.at("Name"), args.at("Type"), args.at("Subtype"), args.at("ManaCost"), std::stoi(args.at("Power")), std::stoi(args.at("Toughness")), args.at("Ability"), args.at("Effect"));
-			}
+		registry[CardType::CREATURE] = [](const card_record& args) {
+			return std::make_unique<creature>(std::string(args.name), std::string(args.subtype), std::string(args.cost), args.power, args.toughness, std::string(args.ability), std::string(args.effect));
 		};
-		registry["instant"] = [](const std::map<std::string, std::string>& args) {
-			return std::make_unique<instant>(args.at("Name"), args.at("Type"), args.at("ManaCost"), args.at("Effect"));
+		registry[CardType::INSTANT] = [](const card_record& args) {
+			return std::make_unique<instant>(std::string(args.name), std::string(args.cost), std::string(args.effect));
 		};
-		registry["sorcery"] = [](fun_map args) {
-			return std::make_unique<sorcery>(args.at("Name"), args.at("Type"), args.at("ManaCost"), args.at("Effect"));
+		registry[CardType::SORCERY] = [](const card_record& args) {
+			return std::make_unique<sorcery>(std::string(args.name), std::string(args.cost), std::string(args.effect));
 		};
-		registry["land"] = [](fun_map args) {
-			return std::make_unique<land>(args.at("Name"), args.at("Type"), args.at("Subtype"), args.at("Colors"));
+		registry[CardType::LAND] = [](const card_record& args) {
+			return std::make_unique<land>(std::string(args.name), std::string(args.subtype), args.colors);
 		};
 	}
 
 	/**
-	* Creates a card of the specified type
-	* @param card_type
-	* @param args
+	* Creates a card
+	* @param args fields of the card
 	* 
 	* @returns a unique pointer to the created card
 	**/
-	std::unique_ptr<card> create_card(const std::string& card_type, fun_map args) {
-		auto it = registry.find(card_type);
+	std::unique_ptr<card> create_card(const card_record& args) {
+		auto it = registry.find(args.type);
 		if (it != registry.end()) {
 			return it->second(args);
 		}
 		return nullptr;
 	}
+
+	/**
+	* Creates a card of the specified type
+	* @param card_type
+	* @param args key-value pairs of the card from the deck file
+	* 
+	* @returns a unique pointer to the created card
+	**/
+	std::unique_ptr<card> create_card(CardType card_type, fun_map args) {
+		card_record record = to_card_record(args);
+		record.type = card_type;
+		return create_card(record);
+	}
+
+	/**
+	* reads the fields of a card from the key-value pairs of its section in a deck file
+	* throws std::out_of_range if a field the type of the card needs is missing,
+	* std::invalid_argument if the factory can't create cards of its type
+	* @param args key-value pairs of the card, have to outlive the record
+	*
+	* @returns the record
+	**/
+	static card_record to_card_record(fun_map args) {
+		return to_card_record([&args](const char* key) -> std::optional<std::string_view> {
+			auto it = args.find(key);
+			if (it == args.end()) return std::nullopt;
+			return std::string_view(it->second);
+		});
+	}
+
+	/**
+	* reads the fields of a card from its section in a parsed INI document
+	* throws std::out_of_range if a field the type of the card needs is missing,
+	* std::invalid_argument if the factory can't create cards of its type
+	* @param document the document, has to outlive the record
+	* @param section index of the section of the card
+	*
+	* @returns the record
+	**/
+	static card_record to_card_record(const IniDocument& document, size_t section) {
+		return to_card_record([&document, section](const char* key) -> std::optional<std::string_view> {
+			const std::string_view* value = document.find(section, key);
+			if (value == nullptr) return std::nullopt;
+			return *value;
+		});
+	}
+
+private:
+	template <typename lookup_func>
+	static card_record to_card_record(lookup_func lookup) {
+		auto required = [&lookup](const char* key) {
+			std::optional<std::string_view> value = lookup(key);
+			if (!value) throw std::out_of_range(std::string("card is missing ") + key);
+			return *value;
+		};
+		auto optional = [&lookup](const char* key) {
+			return lookup(key).value_or(std::string_view(PLACEHOLDER));
+		};
+		auto number = [&required](const char* key) {
+			std::string_view text = required(key);
+			int value = 0;
+			auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+			if (error != std::errc()) throw std::invalid_argument(std::string("invalid ") + key);
+			return value;
+		};
+
+		card_record record;
+		record.name = required("Name");
+		record.type = string_to_card_type(required("Type"));
+		switch (record.type) {
+		case CardType::CREATURE:
+			record.subtype = required("Subtype");
+			record.cost = required("ManaCost");
+			record.power = number("Power");
+			record.toughness = number("Toughness");
+			record.ability = optional("Ability");
+			record.effect = optional("Effect");
+			break;
+		case CardType::INSTANT:
+		case CardType::SORCERY:
+			record.cost = required("ManaCost");
+			record.effect = required("Effect");
+			break;
+		case CardType::LAND:
+			record.subtype = required("Subtype");
+			record.colors = required("Colors");
+			break;
+		default:
+			throw std::invalid_argument(std::string("can't create a card of type ") + card_type_to_string(record.type));
+		}
+		return record;
+	}
 };
 
 #endif //MTG_ENGINE_CARD_FACTORY_H
\ No newline at end of file
@@ -0,0 +1,99 @@
+// cast_tests.cpp : card types the factory can't create and the order a cast creature resolves in
+//
+
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "tests.hpp"
+#include "agent.hpp"
+#include "card_catalog.hpp"
+#include "game.hpp"
+
+namespace {
+
+size_t count_on_battlefield(player& owner, card_id id) {
+    size_t ret = 0;
+    for (size_t i = 0; i < owner.get_battlefield().size(); i++) {
+        if (owner.get_battlefield().get_id(i) == id) ret++;
+    }
+    return ret;
+}
+
+// a deck with a type the factory can't create is rejected when it is read
+void test_card_types() {
+    std::string path = write_deck("MTG_tests_artifact.ini", { "Name=Test Rock\nType=artifact\nManaCost=1\n" }, 1);
+    bool rejected = false;
+    try {
+        load_deck(path);
+    } catch (const std::invalid_argument&) {
+        rejected = true;
+    }
+    std::remove(path.c_str());
+    check(rejected, "a deck with an artifact is loaded");
+}
+
+// a creature enters the battlefield once its effects resolved, the effects can't target it
+void test_cast_order() {
+    std::string path = write_deck("MTG_tests_cast.ini", {
+        "Name=Mountain\nType=land\nSubtype=Mountain\nColors=R\n",
+        "Name=Test Elemental\nType=creature\nSubtype=Elemental\nManaCost=R\nPower=2\nToughness=2\nEffect=damage_target(3)\n" }, 20);
+    compiled_deck deck = load_deck(path);
+    std::remove(path.c_str());
+    card_id elemental;
+    check(card_catalog::global().find("Test Elemental", elemental), "the creature of the deck is in the catalog");
+
+    random_agent agent1(1);
+    random_agent agent2(2);
+    size_t casts = 0;
+    for (std::uint64_t seed = 0; seed < 50; seed++) {
+        game played("Player 1", "Player 2", deck.instantiate(), deck.instantiate(), &agent1, &agent2, seed);
+        while (!played.is_ended()) {
+            if (played.get_decision() != DecisionType::MAIN_PHASE) {
+                played.step();
+                continue;
+            }
+            player& me = *played.get_active_player();
+            size_t hand_index = me.get_hand().size();
+            for (size_t i = 0; i < me.get_hand().size(); i++) {
+                if (me.get_hand()[i] == elemental && me.is_legal_move(move::cast(i), *played.get_non_active_player())) {
+                    hand_index = i;
+                    break;
+                }
+            }
+            if (hand_index == me.get_hand().size()) {
+                played.step();
+                continue;
+            }
+
+            std::string name = "game " + std::to_string(seed) + ", turn " + std::to_string(played.get_turn_number());
+            size_t on_battlefield = count_on_battlefield(me, elemental);
+            size_t in_hand = me.get_hand().size();
+            played.step(move::cast(hand_index));
+            check(played.get_decision() == DecisionType::TARGET, name + ": the effect doesn't ask for its target");
+            check(count_on_battlefield(me, elemental) == on_battlefield && me.get_hand().size() == in_hand - 1,
+                name + ": the creature isn't between the hand and the battlefield while its effect resolves");
+            decision_reply reply;
+            reply.target = "me-Test Elemental";
+            if (on_battlefield == 0) {
+                check(!played.step(reply), name + ": the effect of the creature targets the creature");
+            }
+            reply.target = "opp";
+            check(played.step(reply), name + ": the effect doesn't target the opponent");
+            check(!played.is_resolving() && count_on_battlefield(me, elemental) == on_battlefield + 1,
+                name + ": the creature isn't on the battlefield once its effect resolved");
+            casts++;
+            if (!played.is_ended()) played.finish_turn();
+        }
+    }
+    check(casts > 0, "no creature was cast");
+}
+
+void test_cast(const compiled_deck&) {
+    test_card_types();
+    test_cast_order();
+}
+
+const test_registration cast_test("cast", test_cast);
+
+}
@@ -1,8 +1,10 @@
 #ifndef MTG_ENGINE_COLOR_H
 #define MTG_ENGINE_COLOR_H
 
-#include <unordered_map>
-#include <string>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <string_view>
 
 /**
 * enum class color
@@ -10,64 +12,147 @@
 enum class color {W,U,B,R,G};
 //white, blue, black, red, green, names are like this because MTG calls them this way
 
+constexpr size_t N_OF_COLORS = 5;
+
+// indexed by the color enum
+constexpr std::array<char, N_OF_COLORS> COLOR_CHARS = { 'W', 'U', 'B', 'R', 'G' };
+constexpr std::array<std::string_view, N_OF_COLORS> COLOR_NAMES = { "white", "Blue", "Black", "Red", "Green" };
 
 /**
-* converts a string to a color
-* 
-* @param color_string the string to convert
-* 
-* @returns the color
+* looks up the color of a char
+*
+* @param color_char the char to convert
+* @param color_of_mana set to the color if the char is one
+*
+* @returns true if the char is a color
 **/
-inline color string_to_color_map(const std::string& color_string) {
-	const std::unordered_map<std::string, color> color_map = {
-		{"W", color::W},
-		{"U", color::U},
-		{"B", color::B},
-		{"R", color::R},
-		{"G", color::G}
-	};
-
-	auto it = color_map.find(color_string);
-	if (it != color_map.end()) {
-		return it->second;
+constexpr bool try_char_to_color(char color_char, color& color_of_mana) {
+	for (size_t i = 0; i < N_OF_COLORS; i++) {
+		if (COLOR_CHARS[i] == color_char) {
+			color_of_mana = static_cast<color>(i);
+			return true;
+		}
 	}
-	throw ("invalid color string");
+	return false;
 }
 
 /**
 * converts a char to a color
-* 
+*
 * @param color_char the char to convert
-* 
+*
 * @returns the color
 **/
-inline color char_to_color_map(const char& color_char) {
-	std::string color_string = std::string(1, color_char);
-	return string_to_color_map(color_string);
+constexpr color char_to_color_map(char color_char) {
+	color ret = color::W;
+	if (!try_char_to_color(color_char, ret)) {
+		throw ("invalid color string");
+	}
+	return ret;
+}
+
+/**
+* converts a string to a color
+*
+* @param color_string the string to convert, one char
+*
+* @returns the color
+**/
+constexpr color string_to_color_map(std::string_view color_string) {
+	if (color_string.size() != 1) {
+		throw ("invalid color string");
+	}
+	return char_to_color_map(color_string[0]);
 }
 
 /**
 * converts a color to a string
-* 
+*
 * @param color_of_mana the color to convert
-* 
+*
 * @returns the string
 **/
-inline std::string color_to_string(color color_of_mana) {
-	switch (color_of_mana) {
-		case color::W: 
-			return "white";
-		case color::U:
-			return "Blue";
-		case color::B:
-			return "Black";
-		case color::R:
-			return "Red";
-		case color::G:
-			return "Green";
-		default:
-			throw "NOT A VALID COLOR, START AGAIN";
+constexpr std::string_view color_to_string(color color_of_mana) {
+	if (static_cast<size_t>(color_of_mana) >= N_OF_COLORS) {
+		throw "NOT A VALID COLOR, START AGAIN";
 	}
+	return COLOR_NAMES[static_cast<size_t>(color_of_mana)];
 }
 
+// a set of colors as one bit per color in the order of the color enum
+class color_set
+{
+public:
+	constexpr color_set() = default;
+	constexpr color_set(color color_of_mana) : bits(bit(color_of_mana)) {}
+
+	/**
+	* parses a set of colors written as their chars (e.g. "RG")
+	* @param colors_string the chars of the colors
+	*
+	* @returns the set
+	**/
+	static constexpr color_set parse(std::string_view colors_string) {
+		color_set ret;
+		for (auto&& ch : colors_string) {
+			ret.bits |= bit(char_to_color_map(ch));
+		}
+		return ret;
+	}
+
+	/**
+	* checks if a color is in the set
+	* @param color_of_mana the color
+	*
+	* @returns true if it is
+	**/
+	constexpr bool contains(color color_of_mana) const {
+		return (bits & bit(color_of_mana)) != 0;
+	}
+
+	/**
+	* get the number of colors in the set
+	*
+	* @returns number of colors
+	**/
+	constexpr int size() const {
+		return std::popcount(bits);
+	}
+
+	constexpr bool empty() const {
+		return bits == 0;
+	}
+
+	/**
+	* get the first color of the set in the order of the color enum, the set can't be empty
+	*
+	* @returns color
+	**/
+	constexpr color first() const {
+		return static_cast<color>(std::countr_zero(bits));
+	}
+
+	constexpr color_set operator|(color_set other) const { return from_bits(bits | other.bits); }
+	constexpr color_set operator&(color_set other) const { return from_bits(bits & other.bits); }
+	constexpr color_set& operator|=(color_set other) { bits |= other.bits; return *this; }
+	constexpr color_set& operator&=(color_set other) { bits &= other.bits; return *this; }
+	constexpr bool operator==(const color_set&) const = default;
+
+private:
+	std::uint8_t bits = 0;
+
+	static constexpr std::uint8_t bit(color color_of_mana) {
+		return static_cast<std::uint8_t>(1u << static_cast<unsigned>(color_of_mana));
+	}
+
+	static constexpr color_set from_bits(unsigned bits) {
+		color_set ret;
+		ret.bits = static_cast<std::uint8_t>(bits);
+		return ret;
+	}
+};
+
+static_assert(char_to_color_map('R') == color::R);
+static_assert(color_set::parse("RG") == (color_set(color::R) | color::G));
+
 #endif //MTG_ENGINE_COLOR_H
@@ -0,0 +1,320 @@
+#include "combat_solver.hpp"
+#include "player.hpp"
+
+#include <algorithm>
+#include <climits>
+#include <numeric>
+
+// memo keys are packed into 64 bits: the attacker, the life left (slack) and the count of every group
+constexpr size_t COUNT_BITS = 4;
+constexpr size_t ATTACKER_BITS = 6;
+constexpr size_t SLACK_BITS = 8;
+constexpr size_t MAX_MEMOIZED_GROUPS = 12;
+constexpr size_t MAX_ATTACKER_CLASSES = 256;
+
+/**
+* run the damage of an attacker through its blockers in an order, as resolve_blocks does
+* @param power power of the attacker
+* @param blockers the blockers
+* @param order the order, indices into blockers
+*
+* @returns value of the blockers that die
+**/
+static int killed_by_order(int power, const std::vector<combat_creature>& blockers, const std::vector<size_t>& order) {
+    int killed = 0;
+    for (auto&& i : order) {
+        if (power == 0) break;
+        if (power >= blockers[i].toughness) {
+            power -= blockers[i].toughness;
+            killed += blockers[i].value();
+        }
+    }
+    return killed;
+}
+
+int combat_solver::solve_blocks(const std::vector<combat_creature>& attackers, const std::vector<combat_creature>& blockers, int life, std::vector<size_t>& blocks) {
+    nodes = 0;
+    outcomes.clear();
+    states.clear();
+
+    groups.clear();
+    for (size_t i = 0; i < blockers.size(); i++) {
+        auto group = std::find_if(groups.begin(), groups.end(), [&](const blocker_group& g) { return g.creature == blockers[i]; });
+        if (group == groups.end()) {
+            groups.push_back(blocker_group{ blockers[i], {} });
+            group = groups.end() - 1;
+        }
+        group->members.push_back(i);
+    }
+
+    attacker_order.resize(attackers.size());
+    std::iota(attacker_order.begin(), attacker_order.end(), 0);
+    std::stable_sort(attacker_order.begin(), attacker_order.end(), [&](size_t a, size_t b) {
+        return attackers[a].value() > attackers[b].value();
+    });
+    sorted_attackers.clear();
+    attacker_class.clear();
+    size_t n_of_classes = 0;
+    for (auto&& i : attacker_order) {
+        auto same = std::find(sorted_attackers.begin(), sorted_attackers.end(), attackers[i]);
+        size_t cls = same == sorted_attackers.end() ? n_of_classes++ : attacker_class[same - sorted_attackers.begin()];
+        sorted_attackers.push_back(attackers[i]);
+        attacker_class.push_back(static_cast<std::uint8_t>(std::min(cls, MAX_ATTACKER_CLASSES - 1)));
+    }
+    power_left.assign(attackers.size() + 1, 0);
+    for (size_t i = attackers.size(); i > 0; i--) {
+        power_left[i - 1] = power_left[i] + sorted_attackers[i - 1].power;
+    }
+
+    remaining.clear();
+    for (auto&& group : groups) {
+        remaining.push_back(static_cast<std::uint8_t>(std::min<size_t>(group.members.size(), UINT8_MAX)));
+    }
+    memoized = groups.size() <= MAX_MEMOIZED_GROUPS && n_of_classes <= MAX_ATTACKER_CLASSES
+        && attackers.size() < (size_t{1} << ATTACKER_BITS) && power_left[0] < (1 << SLACK_BITS) - 1
+        && std::all_of(remaining.begin(), remaining.end(), [](std::uint8_t count) { return count < (1 << COUNT_BITS); });
+    assigned.assign(attackers.size(), std::vector<std::uint8_t>(groups.size(), 0));
+    options_at.resize(attackers.size());
+    option_counts.resize(attackers.size());
+
+    int value = best_from(0, life);
+
+    // walk down the best choices again, every state on the way is memoized
+    int slack = life;
+    for (size_t i = 0; i < attackers.size(); i++) {
+        choose(i, slack);
+        const block_option& option = options_at[i][chosen_option];
+        const std::uint8_t* counts = option_counts[i].data() + option.offset;
+        for (size_t g = 0; g < groups.size(); g++) {
+            assigned[i][g] = counts[g];
+            remaining[g] -= counts[g];
+        }
+        if (!option.blocked) slack -= sorted_attackers[i].power;
+    }
+
+    blocks.assign(blockers.size(), attackers.size());
+    for (size_t g = 0; g < groups.size(); g++) {
+        size_t next = 0;
+        for (size_t i = 0; i < attackers.size(); i++) {
+            for (size_t c = 0; c < assigned[i][g]; c++) {
+                blocks[groups[g].members[next++]] = attacker_order[i];
+            }
+        }
+    }
+    return value;
+}
+
+int combat_solver::best_from(size_t attacker, int slack) {
+    // damage beyond what the attackers left can deal changes nothing, so those states are the same
+    slack = std::clamp(slack, 0, power_left[attacker] + 1);
+    if (attacker == sorted_attackers.size()) return slack == 0 ? -LETHAL : 0;
+
+    std::uint64_t key = 0;
+    if (memoized) {
+        key = attacker | static_cast<std::uint64_t>(slack) << ATTACKER_BITS;
+        for (size_t g = 0; g < groups.size(); g++) {
+            key |= static_cast<std::uint64_t>(remaining[g]) << (ATTACKER_BITS + SLACK_BITS + g * COUNT_BITS);
+        }
+        auto found = states.find(key);
+        if (found != states.end()) return found->second;
+    }
+
+    int best;
+    if (++nodes > max_nodes) {
+        // out of budget, the attackers left are not blocked
+        best = -power_left[attacker] - (slack <= power_left[attacker] ? LETHAL : 0);
+    } else {
+        best = choose(attacker, slack);
+    }
+    if (memoized) states.emplace(key, best);
+    return best;
+}
+
+int combat_solver::choose(size_t attacker, int slack) {
+    std::vector<block_option>& options = options_at[attacker];
+    options.clear();
+    option_counts[attacker].clear();
+    collect(attacker, 0, 0, 0);
+
+    int best = INT_MIN;
+    size_t best_option = 0;
+    const size_t n_of_groups = groups.size();
+    for (size_t o = 0; o < options.size(); o++) {
+        const block_option option = options[o];
+        const std::uint8_t* counts = option_counts[attacker].data() + option.offset;
+        for (size_t g = 0; g < n_of_groups; g++) {
+            remaining[g] -= counts[g];
+        }
+        int value = option.blocked ? option.value + best_from(attacker + 1, slack)
+                                   : option.value + best_from(attacker + 1, slack - sorted_attackers[attacker].power);
+        for (size_t g = 0; g < n_of_groups; g++) {
+            remaining[g] += counts[g];
+        }
+        if (value > best) {
+            best = value;
+            best_option = o;
+        }
+    }
+    chosen_option = best_option;
+    return best;
+}
+
+void combat_solver::collect(size_t attacker, size_t group, int block_power, size_t n_of_blockers) {
+    const combat_creature& a = sorted_attackers[attacker];
+    // a block that kills the attacker gets no more blockers
+    if (group < groups.size() && block_power < a.toughness) {
+        // counted wider than the group, a std::uint8_t would wrap before it passes a group of 255
+        for (unsigned c = 0; c <= remaining[group]; c++) {
+            assigned[attacker][group] = static_cast<std::uint8_t>(c);
+            const int power = block_power + static_cast<int>(c) * groups[group].creature.power;
+            collect(attacker, group + 1, power, n_of_blockers + c);
+            if (power >= a.toughness) break;
+        }
+        assigned[attacker][group] = 0;
+        return;
+    }
+
+    if (n_of_blockers > 1) {
+        // blockers that don't kill the attacker together lose more than the best one of them alone,
+        // and a blocker the kill doesn't need is only one more creature at risk
+        if (block_power < a.toughness) return;
+        int weakest = INT_MAX;
+        for (size_t g = 0; g < groups.size(); g++) {
+            if (assigned[attacker][g] > 0) weakest = std::min(weakest, groups[g].creature.power);
+        }
+        if (block_power - weakest >= a.toughness) return;
+    }
+
+    block_option option;
+    option.blocked = n_of_blockers > 0;
+    option.value = option.blocked ? outcome(attacker) : -a.power;
+    option.offset = option_counts[attacker].size();
+    for (size_t g = 0; g < groups.size(); g++) {
+        option_counts[attacker].push_back(g < group ? assigned[attacker][g] : 0);
+    }
+    options_at[attacker].push_back(option);
+}
+
+int combat_solver::outcome(size_t attacker) {
+    std::uint64_t key = 0;
+    if (memoized) {
+        key = attacker_class[attacker];
+        for (size_t g = 0; g < groups.size(); g++) {
+            key |= static_cast<std::uint64_t>(assigned[attacker][g]) << (8 + g * COUNT_BITS);
+        }
+        auto found = outcomes.find(key);
+        if (found != outcomes.end()) return found->second;
+    }
+
+    const combat_creature& a = sorted_attackers[attacker];
+    int block_power = 0;
+    int block_toughness = 0;
+    int block_value = 0;
+    for (size_t g = 0; g < groups.size(); g++) {
+        block_power += assigned[attacker][g] * groups[g].creature.power;
+        block_toughness += assigned[attacker][g] * groups[g].creature.toughness;
+        block_value += assigned[attacker][g] * groups[g].creature.value();
+    }
+
+    int lost = 0;
+    if (a.power >= block_toughness) {
+        lost = block_value;
+    } else if (a.power > 0) {
+        // the attacker orders its damage to kill the blockers worth the most its power covers (knapsack)
+        knapsack.assign(a.power + 1, 0);
+        for (size_t g = 0; g < groups.size(); g++) {
+            const combat_creature& blocker = groups[g].creature;
+            for (size_t c = 0; c < assigned[attacker][g]; c++) {
+                for (int w = a.power; w >= blocker.toughness; w--) {
+                    knapsack[w] = std::max(knapsack[w], knapsack[w - blocker.toughness] + blocker.value());
+                }
+            }
+        }
+        lost = knapsack[a.power];
+    }
+    int result = (block_power >= a.toughness ? a.value() : 0) - lost;
+    if (memoized) outcomes.emplace(key, result);
+    return result;
+}
+
+std::vector<size_t> combat_solver::best_order(int power, const std::vector<combat_creature>& blockers, int& killed) {
+    std::vector<size_t> order(blockers.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return blockers[a].toughness < blockers[b].toughness;
+    });
+    if (power <= 0) {
+        killed = 0;
+        return order;
+    }
+
+    // knapsack over the blockers with the toughness as the weight, the chosen ones go first
+    std::vector<std::vector<int>> best(blockers.size() + 1, std::vector<int>(power + 1, 0));
+    for (size_t i = 1; i <= blockers.size(); i++) {
+        const combat_creature& blocker = blockers[order[i - 1]];
+        for (int w = 0; w <= power; w++) {
+            best[i][w] = best[i - 1][w];
+            if (w >= blocker.toughness) {
+                best[i][w] = std::max(best[i][w], best[i - 1][w - blocker.toughness] + blocker.value());
+            }
+        }
+    }
+    std::vector<size_t> chosen;
+    std::vector<size_t> rest;
+    int w = power;
+    for (size_t i = blockers.size(); i > 0; i--) {
+        if (best[i][w] != best[i - 1][w]) {
+            chosen.push_back(order[i - 1]);
+            w -= blockers[order[i - 1]].toughness;
+        } else {
+            rest.push_back(order[i - 1]);
+        }
+    }
+    std::reverse(chosen.begin(), chosen.end());
+    std::reverse(rest.begin(), rest.end());
+    chosen.insert(chosen.end(), rest.begin(), rest.end());
+    killed = killed_by_order(power, blockers, chosen);
+    return chosen;
+}
+
+std::map<size_t, std::vector<size_t>> combat_solver::best_blocks(player& defender, player& attacking_player, const std::vector<size_t>& attackers) {
+    std::vector<combat_creature> attacking;
+    battlefield_zone& their_battlefield = attacking_player.get_battlefield();
+    for (auto&& attacker : attackers) {
+        attacking.push_back(combat_creature{ their_battlefield.get_power(attacker), their_battlefield.get_toughness(attacker) });
+    }
+
+    std::vector<size_t> untapped;
+    std::vector<combat_creature> blocking;
+    battlefield_zone& battlefield = defender.get_battlefield();
+    for (size_t i = 0; i < battlefield.size(); i++) {
+        if (battlefield.get_type(i) == CardType::CREATURE && !battlefield.is_tapped(i)) {
+            untapped.push_back(i);
+            blocking.push_back(combat_creature{ battlefield.get_power(i), battlefield.get_toughness(i) });
+        }
+    }
+
+    std::vector<size_t> blocks;
+    solve_blocks(attacking, blocking, defender.get_life(), blocks);
+    std::map<size_t, std::vector<size_t>> ret;
+    for (size_t i = 0; i < blocks.size(); i++) {
+        if (blocks[i] < attackers.size()) {
+            ret[attackers[blocks[i]]].push_back(untapped[i]);
+        }
+    }
+    return ret;
+}
+
+std::vector<size_t> combat_solver::best_order(player& attacking_player, player& defender, size_t attacker, const std::vector<size_t>& blockers) {
+    std::vector<combat_creature> blocking;
+    battlefield_zone& battlefield = defender.get_battlefield();
+    for (auto&& blocker : blockers) {
+        blocking.push_back(combat_creature{ battlefield.get_power(blocker), battlefield.get_toughness(blocker) });
+    }
+    int killed;
+    std::vector<size_t> order = best_order(attacking_player.get_battlefield().get_power(attacker), blocking, killed);
+    for (auto&& i : order) {
+        i = blockers[i];
+    }
+    return order;
+}
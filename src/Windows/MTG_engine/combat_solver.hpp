@@ -0,0 +1,140 @@
+#ifndef MTG_ENGINE_COMBAT_SOLVER_H
+#define MTG_ENGINE_COMBAT_SOLVER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+class player;
+
+// a creature in combat, what resolve_blocks looks at
+struct combat_creature
+{
+	int power = 0;
+	int toughness = 0;
+
+	/**
+	* get what losing the creature costs its controller
+	*
+	* @returns power and toughness
+	**/
+	constexpr int value() const {
+		return power + toughness;
+	}
+
+	constexpr bool operator==(const combat_creature&) const = default;
+};
+
+// finds the blocks and damage orders worth the most, with the damage rule of game::resolve_blocks:
+// an attacker kills all its blockers if its power covers their toughness together, otherwise it kills the ones its
+// damage order reaches, and dies if its blockers have as much power as its toughness
+// a block is worth the creatures of the attacker that die minus the creatures of the defender that die minus the damage
+// taken, damage that kills the defender is worth less than any block that doesn't
+class combat_solver
+{
+public:
+	static constexpr int LETHAL = 1'000'000;
+	static constexpr size_t DEFAULT_MAX_NODES = 200'000;
+
+	/**
+	* combat solver constructor
+	* @param max_nodes board states searched per call, the attackers left are not blocked when they run out
+	**/
+	explicit combat_solver(size_t max_nodes = DEFAULT_MAX_NODES) : max_nodes(max_nodes) {}
+
+	/**
+	* find the best blocks of the defender
+	* @param attackers the attacking creatures
+	* @param blockers the creatures that can block
+	* @param life life of the defender
+	* @param blocks assigned attacker of every blocker (index into attackers), attackers.size() for blockers that don't block
+	*
+	* @returns value of the blocks for the defender
+	**/
+	int solve_blocks(const std::vector<combat_creature>& attackers, const std::vector<combat_creature>& blockers, int life, std::vector<size_t>& blocks);
+
+	/**
+	* find the best blocks of a player on the battlefield
+	* @param defender the blocking player, every untapped creature can block
+	* @param attacking_player the attacking player
+	* @param attackers attackers, indices into the battlefield of attacking_player
+	*
+	* @returns map of attacker to indices into the battlefield of defender, the format of agent::choose_blockers
+	**/
+	std::map<size_t, std::vector<size_t>> best_blocks(player& defender, player& attacking_player, const std::vector<size_t>& attackers);
+
+	/**
+	* find the damage order that kills the blockers worth the most: the blockers the damage can cover first, the rest after
+	* @param power power of the attacker
+	* @param blockers its blockers
+	* @param killed value of the blockers that die
+	*
+	* @returns the order, indices into blockers
+	**/
+	static std::vector<size_t> best_order(int power, const std::vector<combat_creature>& blockers, int& killed);
+
+	/**
+	* find the damage order of an attacker on the battlefield
+	* @param attacking_player the attacking player
+	* @param defender the blocking player
+	* @param attacker index into the battlefield of attacking_player
+	* @param blockers indices into the battlefield of defender
+	*
+	* @returns the blockers in the order, the format of agent::choose_order_of_blockers
+	**/
+	static std::vector<size_t> best_order(player& attacking_player, player& defender, size_t attacker, const std::vector<size_t>& blockers);
+
+	/**
+	* get the number of board states searched by the last call
+	*
+	* @returns number of nodes
+	**/
+	size_t get_nodes() const {
+		return nodes;
+	}
+
+private:
+	// blockers with the same power and toughness are interchangeable, the search only counts how many of a group block
+	struct blocker_group {
+		combat_creature creature;
+		std::vector<size_t> members;
+	};
+
+	// a block of one attacker, its counts per group are at offset in option_counts
+	struct block_option {
+		int value = 0;
+		bool blocked = false;
+		size_t offset = 0;
+	};
+
+	size_t max_nodes;
+	size_t nodes = 0;
+
+	// state of one search, kept for reuse
+	std::vector<blocker_group> groups;
+	std::vector<size_t> attacker_order;
+	std::vector<std::uint8_t> attacker_class;
+	std::vector<combat_creature> sorted_attackers;
+	std::vector<std::uint8_t> remaining;
+	std::vector<std::vector<std::uint8_t>> assigned;
+	std::vector<int> power_left;
+	std::vector<int> knapsack;
+	std::vector<std::vector<block_option>> options_at;
+	std::vector<std::vector<std::uint8_t>> option_counts;
+	size_t chosen_option = 0;
+	bool memoized = false;
+
+	// value of an attacker against the blockers of a group count, keyed by the kind of attacker and the counts
+	std::unordered_map<std::uint64_t, int> outcomes;
+	// best value of the attackers from one on, keyed by the attacker, the life left and the blockers left
+	std::unordered_map<std::uint64_t, int> states;
+
+	int best_from(size_t attacker, int slack);
+	int choose(size_t attacker, int slack);
+	void collect(size_t attacker, size_t group, int block_power, size_t n_of_blockers);
+	int outcome(size_t attacker);
+};
+
+#endif //MTG_ENGINE_COMBAT_SOLVER_H
@@ -0,0 +1,124 @@
+// combat_solver_tests.cpp : the combat solver against a search of every block and damage order
+//
+
+#include <algorithm>
+#include <string>
+#include <vector>
+#include "tests.hpp"
+#include "combat_solver.hpp"
+#include "random.hpp"
+
+namespace {
+
+/**
+* value of blocks for the defender, the rule combat_solver describes, every damage order of the blockers is tried
+* @param attackers the attacking creatures
+* @param blockers the creatures that can block
+* @param life life of the defender
+* @param blocks assigned attacker of every blocker, attackers.size() for blockers that don't block
+*
+* @returns value of the blocks
+**/
+int block_value(const std::vector<combat_creature>& attackers, const std::vector<combat_creature>& blockers, int life, const std::vector<size_t>& blocks) {
+    int value = 0;
+    int damage = 0;
+    for (size_t a = 0; a < attackers.size(); a++) {
+        std::vector<combat_creature> blocking;
+        for (size_t b = 0; b < blockers.size(); b++) {
+            if (blocks[b] == a) blocking.push_back(blockers[b]);
+        }
+        if (blocking.empty()) {
+            damage += attackers[a].power;
+            continue;
+        }
+
+        int toughness = 0;
+        int power = 0;
+        int all = 0;
+        for (const combat_creature& blocker : blocking) {
+            toughness += blocker.toughness;
+            power += blocker.power;
+            all += blocker.value();
+        }
+        int killed = 0;
+        if (attackers[a].power >= toughness) {
+            killed = all;
+        } else {
+            // the damage goes through the order until a blocker it can't kill
+            std::vector<size_t> order(blocking.size());
+            for (size_t i = 0; i < order.size(); i++) order[i] = i;
+            do {
+                int left = attackers[a].power;
+                int in_order = 0;
+                for (size_t i : order) {
+                    if (left < blocking[i].toughness) break;
+                    left -= blocking[i].toughness;
+                    in_order += blocking[i].value();
+                }
+                killed = std::max(killed, in_order);
+            } while (std::next_permutation(order.begin(), order.end()));
+        }
+        value += (power >= attackers[a].toughness ? attackers[a].value() : 0) - killed;
+    }
+    return value - damage - (damage >= life ? combat_solver::LETHAL : 0);
+}
+
+/**
+* best value of blocks, every assignment of the blockers is tried
+* @param attackers the attacking creatures
+* @param blockers the creatures that can block
+* @param life life of the defender
+*
+* @returns value of the best blocks
+**/
+int brute_force_blocks(const std::vector<combat_creature>& attackers, const std::vector<combat_creature>& blockers, int life) {
+    std::vector<size_t> blocks(blockers.size(), 0);
+    int best = block_value(attackers, blockers, life, blocks);
+    while (true) {
+        // the next assignment, counting in base attackers.size() + 1
+        size_t i = 0;
+        while (i < blocks.size() && blocks[i] == attackers.size()) blocks[i++] = 0;
+        if (i == blocks.size()) return best;
+        blocks[i]++;
+        best = std::max(best, block_value(attackers, blockers, life, blocks));
+    }
+}
+
+// random boards small enough to search every assignment, more attackers than blockers and the other way round
+void test_combat_solver(const compiled_deck&) {
+    game_rng rng(7);
+    combat_solver solver;
+    for (size_t board = 0; board < 2000; board++) {
+        std::vector<combat_creature> attackers(1 + rng.below(4));
+        std::vector<combat_creature> blockers(rng.below(6));
+        for (combat_creature& attacker : attackers) attacker = { static_cast<int>(rng.below(6)), static_cast<int>(1 + rng.below(5)) };
+        for (combat_creature& blocker : blockers) blocker = { static_cast<int>(rng.below(5)), static_cast<int>(1 + rng.below(5)) };
+        int life = static_cast<int>(1 + rng.below(20));
+
+        std::vector<size_t> blocks;
+        int value = solver.solve_blocks(attackers, blockers, life, blocks);
+        std::string name = "board " + std::to_string(board);
+        check(value == brute_force_blocks(attackers, blockers, life), name + ": the solver misses the best blocks");
+        check(blocks.size() == blockers.size() && value == block_value(attackers, blockers, life, blocks), name + ": the blocks aren't worth what the solver says");
+
+        for (const combat_creature& attacker : attackers) {
+            int killed = 0;
+            std::vector<size_t> order = combat_solver::best_order(attacker.power, blockers, killed);
+            std::vector<size_t> sorted = order;
+            std::sort(sorted.begin(), sorted.end());
+            bool permutation = sorted.size() == blockers.size();
+            for (size_t i = 0; permutation && i < sorted.size(); i++) permutation = sorted[i] == i;
+            check(permutation, name + ": the damage order isn't an order of the blockers");
+            if (!blockers.empty() && blockers.size() <= 4) {
+                // the order against the attacker blocked by all of them, with power enough for all the order is ignored
+                std::vector<size_t> all(blockers.size(), 0);
+                std::vector<combat_creature> one = { { attacker.power, 1'000 } };
+                check(killed == -block_value(one, blockers, 1'000, all), name + ": the damage order kills less than the best one");
+            }
+        }
+    }
+}
+
+const test_registration combat_solver_test("combat_solver", test_combat_solver);
+
+}
@@ -1,33 +1,83 @@
 #ifndef MTG_ENGINE_DECK_H
 #define MTG_ENGINE_DECK_H
 
+#include <memory_resource>
+#include <vector>
 #include "INI_parser.hpp"
-#include "card_factory.hpp"
+#include "card_catalog.hpp"
 
 class deck {
 public:
 	/**
-	* data of the deck
+	* library of the deck
 	**/
-	IniParser::IniData data;
+	std::pmr::vector<card_id> library;
 
 	/**
-	* library of the deck
+	* deck constructor, decks are built by compiled_deck::instantiate
+	* @param cards library of the deck, its memory resource is used by the players of the game too (see game_arena)
 	**/
-	std::vector<std::unique_ptr<card>> library;
+	explicit deck(std::pmr::vector<card_id> cards) : library(std::move(cards)) {}
+
+	~deck() = default;
+};
 
+// a deck parsed and interned once, every game gets its own copy of the card ids through instantiate()
+class compiled_deck {
+public:
 	/**
-	* deck constructor
+	* compiled deck constructor, adds the cards to the global card_catalog
 	* @param deck_data data of the deck
 	**/
-	deck(IniParser::IniData deck_data) : data(deck_data) {
-		card_factory factory;
+	explicit compiled_deck(const IniParser::IniData& deck_data) {
+		card_catalog& catalog = card_catalog::global();
+		cards.reserve(deck_data.size());
 		for (auto&& card : deck_data) {
-			library.push_back(std::move(factory.create_card(card.second["Type"], card.second)));
+			cards.push_back(catalog.intern(card.second));
 		}
 	}
 
-	~deck() = default;
+	/**
+	* compiled deck constructor, adds the cards to the global card_catalog
+	* the cards are in the same order as in IniParser::IniData of the file
+	* @param document parsed deck file
+	**/
+	explicit compiled_deck(const IniDocument& document) {
+		card_catalog& catalog = card_catalog::global();
+		std::vector<size_t> sections = document.sectionsByName();
+		cards.reserve(sections.size());
+		for (auto&& section : sections) {
+			cards.push_back(catalog.intern(card_factory::to_card_record(document, section)));
+		}
+	}
+
+	/**
+	* compiled deck constructor from cards that are already in the card_catalog (see load_deck)
+	* @param cards cards of the deck in the order of the deck file
+	**/
+	explicit compiled_deck(std::vector<card_id> cards) : cards(std::move(cards)) {}
+
+	/**
+	* build a game-ready deck, copies the card ids and does nothing else
+	* @param resource memory of the game the deck is built for
+	*
+	* @returns the deck
+	**/
+	deck instantiate(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) const {
+		return deck(std::pmr::vector<card_id>(cards.begin(), cards.end(), resource));
+	}
+
+	/**
+	* get the cards of the deck in the order of the deck file
+	*
+	* @returns the cards
+	**/
+	const std::vector<card_id>& get_cards() const {
+		return cards;
+	}
+
+private:
+	std::vector<card_id> cards;
 };
 
 #endif //MTG_ENGINE_DECK_H
\ No newline at end of file
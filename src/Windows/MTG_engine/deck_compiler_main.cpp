@@ -0,0 +1,41 @@
+// deck_compiler_main.cpp : compiles INI deck files into the binary deck format read by load_deck
+//
+
+#include <fstream>
+#include <iostream>
+#include <string>
+#include "binary_deck.hpp"
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2 || argc > 3) {
+        std::cout << "usage: MTG_deck_compiler <deck.ini> [deck.mtgd]\n";
+        return 1;
+    }
+    std::string input = argv[1];
+    std::string output = (argc > 2) ? argv[2] : input.substr(0, input.rfind('.')) + ".mtgd";
+
+    IniParser parser;
+    IniParser::IniData data = parser.parseIniFile(input);
+    if (data.empty()) {
+        std::cout << "empty or missing deck: " << input << "\n";
+        return 1;
+    }
+
+    std::ofstream file(output, std::ios::binary);
+    if (!file.is_open()) {
+        std::cout << "Failed to open file: " << output << "\n";
+        return 1;
+    }
+    try {
+        binary_deck::write(data, file);
+    } catch (const std::exception& e) {
+        std::cout << "invalid deck " << input << ": " << e.what() << "\n";
+        return 1;
+    } catch (const char* e) {
+        std::cout << "invalid deck " << input << ": " << e << "\n";
+        return 1;
+    }
+    std::cout << "compiled " << data.size() << " cards into " << output << "\n";
+    return 0;
+}
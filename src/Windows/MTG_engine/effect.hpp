@@ -20,6 +20,9 @@ class creature;
 class permanent;
 class damagable;
 
+// what an effect can be used on
+enum class EffectTarget { NONE, PLAYER, CREATURE, ANY };
+
 // effects are things that happen when a card is played
 class effect
 {
@@ -30,27 +33,38 @@ public:
 	* 
 	* @param target the target of the effect
 	**/
-	virtual void execute(damagable& target) = 0;
+	virtual void execute(damagable& target) const = 0;
 
 	/**
 	* returns the name of the effect
 	*
 	* @returns name
 	**/
-	std::string get_name() {return name;}
+	const std::string& get_name() const {return name;}
+
+	/**
+	* returns what the effect can target
+	*
+	* @returns target
+	**/
+	EffectTarget get_target() const {return target;}
 protected:
 	/**
 	* name of the effect
 	**/
 	std::string name = " ";
+	/**
+	* what the effect can target
+	**/
+	EffectTarget target = EffectTarget::ANY;
 };
 
 class destroy_permanent : public effect {
 public:
 	~destroy_permanent() = default;
-	destroy_permanent() {name = "destroy permanent";};
+	destroy_permanent() {name = "destroy permanent"; target = EffectTarget::CREATURE;};
 
-	void execute(damagable& target) override;
+	void execute(damagable& target) const override;
 };
 
 class deal_damage : public effect {
@@ -60,7 +74,7 @@ public:
 	~deal_damage() = default;
 	deal_damage(int amount) : amount(amount) {name = "deal damage";};
 
-	void execute(damagable& target) override;
+	void execute(damagable& target) const override;
 };
 
 class heal : public effect {
@@ -70,7 +84,7 @@ public:
 	~heal() = default;
 	heal(int amount) : amount(amount) {name = "heal";};
 
-	void execute(damagable& target) override;
+	void execute(damagable& target) const override;
 };
 
 class draw_card : public effect {
@@ -78,9 +92,9 @@ private:
 	int amount;
 public:
 	~draw_card() = default;
-	draw_card(int amount) : amount(amount) {name = "draw card";};
+	draw_card(int amount) : amount(amount) {name = "draw card"; target = EffectTarget::PLAYER;};
 
-	void execute(damagable& target) override;
+	void execute(damagable& target) const override;
 };
 
 class discard : public effect {
@@ -88,17 +102,17 @@ private:
 	int amount;
 public:
 	~discard() = default;
-	discard(int amount) : amount(amount) {name = "discard card";};
+	discard(int amount) : amount(amount) {name = "discard card"; target = EffectTarget::PLAYER;};
 
-	void execute(damagable& target) override;
+	void execute(damagable& target) const override;
 };
 
 class nothing : public effect {
 public:
 	~nothing() = default;
-	nothing() {name = "nothing";};
+	nothing() {name = "nothing"; target = EffectTarget::NONE;};
 
-	void execute(damagable& target) override {};
+	void execute(damagable&) const override {}
 };
 
 /*
@@ -110,7 +124,7 @@ public:
 	~add_mana_into_pool() = default;
 	add_mana_into_pool() {}
 
-	void execute(damagable& target) override;
+	void execute(damagable& target) const override;
 };*/
 
 #endif
@@ -1,132 +1,429 @@
 #include "game.hpp"
-#include <random>
 
-constexpr size_t STARTING_HAND_SIZE = 7;
+#include <algorithm>
 
 /**
 * roll dice to see who goes first
 * @param name1 name of player 1
 * @param name2 name of player 2
+* @param gen random generator of the game
 * 
 * @returns true if player 1 wins
 **/
-bool roll_for_high(const std::string& name1, const std::string& name2)
+bool roll_for_high(const std::string& name1, const std::string& name2, game_rng& gen)
 {
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<> dis(1, 6);
-
-    const int p1_roll1 = dis(gen);
-    const int p1_roll2 = dis(gen);
-    std::cout << name1 << " roll: " << p1_roll1 << "+" << p1_roll2 << "=" << (p1_roll1 + p1_roll2) << "\n";
-    const int p2_roll1 = dis(gen);
-    const int p2_roll2 = dis(gen);
-    std::cout << name2 << " roll: " << p2_roll1 << "+" << p2_roll2 << "=" << (p2_roll1 + p2_roll2) << "\n\n";
+    auto dis = [&gen]() { return static_cast<int>(gen.below(6)) + 1; };
+
+    const int p1_roll1 = dis();
+    const int p1_roll2 = dis();
+    game_log() << name1 << " roll: " << p1_roll1 << "+" << p1_roll2 << "=" << (p1_roll1 + p1_roll2) << "\n";
+    const int p2_roll1 = dis();
+    const int p2_roll2 = dis();
+    game_log() << name2 << " roll: " << p2_roll1 << "+" << p2_roll2 << "=" << (p2_roll1 + p2_roll2) << "\n\n";
     return (p1_roll1 + p1_roll2) > (p2_roll1 + p2_roll2);
 }
 
 /**
-* resolve blocks
-* @param attackers attackers in the form of vector
-* @param blocks blocks in the form of map<attacker, vector<blockers>>
+* checks if the damage of an attacker doesn't cover all its blockers, then its controller orders them
+* @param attacker the attacker
+* @param blockers its blockers
 * 
-* @returns damage
-**/
-int game::resolve_blocks(const std::vector<size_t>& attackers, const std::map<size_t, std::vector<size_t>>& blocks) {
-    int damage = 0; //int because of healing in the future
-    std::vector<size_t> order_of_blocks;
-    for (auto&& [attacker, blockers] : blocks) {
-        order_of_blocks.clear();
-        if (blockers.size() == 0) {
-		    damage += static_cast<creature*>(game::get_active_player()->get_battlefield()[attacker].get())->get_power();
-        } else if (blockers.size() >= 1) {
-            int toughness = static_cast<creature*>(game::get_active_player()->get_battlefield()[attacker].get())->get_toughness();
-            int power = static_cast<creature*>(game::get_active_player()->get_battlefield()[attacker].get())->get_power();
-            int block_toughness = 0;
-            int block_power = 0;
-            for (auto&& blocker : blockers) {
-                block_toughness += static_cast<creature*>(game::get_non_active_player()->get_battlefield()[blocker].get())->get_toughness();
-                block_power += static_cast<creature*>(game::get_non_active_player()->get_battlefield()[blocker].get())->get_power();
-            }
-
-            if (power >= block_toughness) {
-				for (auto&& blocker : blockers) {
-                    static_cast<creature*>(game::get_non_active_player()->get_battlefield()[blocker].get())->deal_damage(power);
-				}
-			} else if ((power < block_toughness) && (blockers.size() > 1)) {
-                order_of_blocks = game::get_active_player()->select_order_of_blockers(attacker, blockers);
-                for (auto&& blocker : order_of_blocks) {
-                    if (power == 0) {
-                        break;
-                    }
-                    int single_toughness = static_cast<creature*>(game::get_non_active_player()->get_battlefield()[blocker].get())->get_toughness();
-                    if (power >= single_toughness) {
-                        static_cast<creature*>(game::get_non_active_player()->get_battlefield()[blocker].get())->deal_damage(single_toughness);
-                        power -= single_toughness;
-                    }
-                }
-			} // else, blockers survive
-
-            if (toughness <= block_power) {
-                static_cast<creature*>(game::get_active_player()->get_battlefield()[attacker].get())->deal_damage(block_power);
-			} // else, attacker survives
-        }
+* @returns true if the blockers need an order
+**/
+bool game::needs_order(size_t attacker, const std::vector<size_t>& blockers) {
+    if (blockers.size() <= 1) return false;
+    int block_toughness = 0;
+    for (auto&& blocker : blockers) {
+        block_toughness += non_active_player->get_battlefield().get_toughness(blocker);
     }
-    return 0;
+    return active_player->get_battlefield().get_power(attacker) < block_toughness;
 }
 
 /**
-* check for deaths of creatures on the battlefield
+* resolve the block of one attacker
+* @param attacker the attacker
+* @param blockers its blockers
+* @param order its blockers in damage order if they need one
 **/
-void game::check_deaths() {
+void game::resolve_block(size_t attacker, const std::vector<size_t>& blockers, const std::vector<size_t>& order) {
+    if (blockers.size() == 0) {
+        unblocked_damage += game::get_active_player()->get_battlefield().get_power(attacker);
+        return;
+    }
+    int toughness = game::get_active_player()->get_battlefield().get_toughness(attacker);
+    int power = game::get_active_player()->get_battlefield().get_power(attacker);
+    int block_toughness = 0;
+    int block_power = 0;
+    for (auto&& blocker : blockers) {
+        block_toughness += game::get_non_active_player()->get_battlefield().get_toughness(blocker);
+        block_power += game::get_non_active_player()->get_battlefield().get_power(blocker);
+    }
 
-    for (size_t i = 0; i < active_player->get_battlefield().size(); i++) {
-        auto& card = active_player->get_battlefield()[i];
-        if (card->get_type() == "creature" && static_cast<creature*>(card.get())->get_dead()) {
-            active_player->send_to_graveyard(card.get());
-            i--;
+    if (power >= block_toughness) {
+        for (auto&& blocker : blockers) {
+            game::get_non_active_player()->damage_creature(blocker, power);
         }
-    }
+    } else if ((power < block_toughness) && (blockers.size() > 1)) {
+        for (auto&& blocker : order) {
+            if (power == 0) {
+                break;
+            }
+            int single_toughness = game::get_non_active_player()->get_battlefield().get_toughness(blocker);
+            if (power >= single_toughness) {
+                game::get_non_active_player()->damage_creature(blocker, single_toughness);
+                power -= single_toughness;
+            }
+        }
+    } // else, blockers survive
 
-    for (size_t i = 0; i < non_active_player->get_battlefield().size(); i++) {
-        auto& card = non_active_player->get_battlefield()[i];
-        if (card->get_type() == "creature" && static_cast<creature*>(card.get())->get_dead()) {
-            non_active_player->send_to_graveyard(card.get());
-            i--;
+    if (toughness <= block_power) {
+        game::get_active_player()->damage_creature(attacker, block_power);
+    } // else, attacker survives
+}
+
+/**
+* resolve the blocks from ordered_attacker on, stops at an attacker that needs the order of its blockers
+**/
+void game::resolve_blocks() {
+    static const std::vector<size_t> no_order;
+    for (auto it = declared_blocks.lower_bound(ordered_attacker); it != declared_blocks.end(); ++it) {
+        if (needs_order(it->first, it->second)) {
+            ordered_attacker = it->first;
+            pending = DecisionType::ORDER_BLOCKERS;
+            return;
         }
+        resolve_block(it->first, it->second, no_order);
     }
+    end_combat();
+}
+
+/**
+* check for deaths of creatures on the battlefield
+**/
+void game::check_deaths() {
+    active_player->send_dead_to_graveyard();
+    non_active_player->send_dead_to_graveyard();
 }
 
 /**
 * game starter - shuffles decks, gives cards and opportunity to mulligan
 **/
 void game::start_game() {
-    p1.shuffle();
-    p2.shuffle();
-    std::string p1_mulligan, p2_mulligan;
+    if (!started) step();
+    while (pending == DecisionType::MULLIGAN) {
+        step();
+    }
+}
+
+/**
+* shuffle the decks and draw the starting hands, then the players decide about mulligans
+**/
+void game::deal() {
+    started = true;
+    p1.shuffle(rng);
+    p2.shuffle(rng);
     p1.draw_card(STARTING_HAND_SIZE);
     p2.draw_card(STARTING_HAND_SIZE);
-    p1.display_hand();
-    std::cout << p1.get_damagable_name() << " mulligan? y/N\n";
-    std::getline(std::cin, p1_mulligan);
-    if (p1_mulligan == "Y" || p1_mulligan == "y") p1.mulligan(STARTING_HAND_SIZE-1);
-    p2.display_hand();
-    std::cout << p2.get_damagable_name() << " mulligan? y/N\n";
-    std::getline(std::cin, p2_mulligan);
-    if (p2_mulligan == "Y" || p2_mulligan == "y") p2.mulligan(STARTING_HAND_SIZE-1);
+    p1_kept_hand = false;
+    pending = DecisionType::MULLIGAN;
+    publish(GameEventType::GAME_STARTED, active_player);
 }
 
 /**
-* main game loop
+* a player mulligans and is asked again, or keeps the hand and the next player decides
+* mulligans repeat until the player keeps a hand or has one card left, as the console prompt of player::mulligan did
+* 
+* @param take true for a mulligan
+**/
+void game::decide_mulligan(bool take) {
+    if (actions != nullptr) actions->add_flag(take);
+    player& deciding = p1_kept_hand ? p2 : p1;
+    if (take) {
+        size_t n_of_cards = deciding.get_hand().size() - 1;
+        deciding.mulligan(n_of_cards, rng);
+        if (n_of_cards > 1) return;
+        game_log() << "You can't mulligan anymore, you have 1 card in your hand\n\n";
+    }
+    if (!p1_kept_hand) {
+        p1_kept_hand = true;
+    } else {
+        pending = DecisionType::NONE;
+    }
+}
+
+/**
+* main game loop - plays until the end of the turn, starts the next turn first if the game is between turns
 **/
 void game::turn() {
+    if (pending == DecisionType::NONE) step();
+    finish_turn();
+}
+
+/**
+* play the rest of the current turn
+**/
+void game::finish_turn() {
+    while (pending != DecisionType::NONE) {
+        step();
+    }
+}
+
+/**
+* play the rest of the current turn after the attackers were declared and tapped
+* 
+* @param attackers the attackers
+**/
+void game::finish_turn_after_attackers(const std::vector<size_t>& attackers) {
+    record_counters();
+    current_phase = phase::combat;
+    if (this->ended) {
+        pending = DecisionType::NONE;
+        return;
+    }
+    declared_attackers = attackers;
+    if (attackers.empty()) {
+        combat_damage({});
+    } else {
+        pending = DecisionType::BLOCKERS;
+    }
+    finish_turn();
+}
+
+/**
+* the deciding player's agent makes the pending decision, or the next turn starts if there is none
+**/
+void game::step() {
+    record_counters();
+    switch (pending) {
+        case DecisionType::NONE:
+            if (!started) {
+                deal();
+            } else if (!this->ended) {
+                begin_turn();
+            }
+            break;
+        case DecisionType::MULLIGAN:
+            decide_mulligan(get_deciding_player()->wants_mulligan());
+            break;
+        case DecisionType::MAIN_PHASE:
+            continue_main_phase(active_player->play(*non_active_player));
+            break;
+        case DecisionType::ATTACKERS:
+            declare_attackers(active_player->select_attackers(non_active_player));
+            break;
+        case DecisionType::BLOCKERS:
+            declare_blockers(non_active_player->select_blockers(declared_attackers, active_player));
+            break;
+        case DecisionType::ORDER_BLOCKERS:
+            order_blockers(active_player->select_order_of_blockers(ordered_attacker, get_blockers_to_order(), non_active_player));
+            break;
+        case DecisionType::DISCARD:
+            discard(get_deciding_player()->get_agent().choose_discard(*get_deciding_player()));
+            break;
+        case DecisionType::TARGET:
+            target_effect(active_player->get_agent().choose_target(*active_player, *non_active_player, *active_player->get_effect_to_target()));
+            break;
+    }
+}
+
+/**
+* make the pending decision
+* 
+* @param reply the decision
+* 
+* @returns false if there is no decision or the reply is illegal
+**/
+bool game::step(const decision_reply& reply) {
+    switch (pending) {
+        case DecisionType::MULLIGAN:
+            record_counters();
+            decide_mulligan(reply.mulligan);
+            return true;
+        case DecisionType::MAIN_PHASE:
+            return step(reply.chosen_move);
+        case DecisionType::ATTACKERS:
+        case DecisionType::ORDER_BLOCKERS:
+            return step(reply.creatures);
+        case DecisionType::BLOCKERS:
+            return step(reply.blocks);
+        case DecisionType::DISCARD:
+            record_counters();
+            return discard(reply.card);
+        case DecisionType::TARGET:
+            record_counters();
+            return target_effect(reply.target);
+        default:
+            return false;
+    }
+}
+
+/**
+* make the pending main phase move
+* 
+* @param chosen the move
+* 
+* @returns false if the game doesn't wait for a main phase move or the move is not legal, the decision stays pending
+**/
+bool game::step(const move& chosen) {
+    if (pending != DecisionType::MAIN_PHASE || !active_player->is_legal_move(chosen, *non_active_player)) return false;
+    record_counters();
+    continue_main_phase(active_player->apply_move(chosen, *non_active_player));
+    return true;
+}
+
+/**
+* declare the pending attackers
+* 
+* @param attackers the attackers
+* 
+* @returns false if the game doesn't wait for attackers or some of them can't attack
+**/
+bool game::step(const std::vector<size_t>& attackers) {
+    if (pending != DecisionType::ATTACKERS && pending != DecisionType::ORDER_BLOCKERS) return false;
+    record_counters();
+    return pending == DecisionType::ATTACKERS ? declare_attackers(attackers) : order_blockers(attackers);
+}
+
+/**
+* declare the pending blockers
+* 
+* @param blockers the blockers
+* 
+* @returns false if the game doesn't wait for blockers or some of them can't block
+**/
+bool game::step(const std::map<size_t, std::vector<size_t>>& blockers) {
+    if (pending != DecisionType::BLOCKERS) return false;
+    record_counters();
+    return declare_blockers(blockers);
+}
+
+/**
+* get the player who makes the pending decision
+*
+* @returns the player, nullptr if there is no decision
+**/
+player* game::get_deciding_player() {
+    switch (pending) {
+        case DecisionType::MULLIGAN:
+            return p1_kept_hand ? &p2 : &p1;
+        case DecisionType::MAIN_PHASE:
+        case DecisionType::ATTACKERS:
+        case DecisionType::ORDER_BLOCKERS:
+        case DecisionType::TARGET:
+            return active_player;
+        case DecisionType::DISCARD:
+            return discarding_player() != nullptr ? discarding_player() : active_player;
+        case DecisionType::BLOCKERS:
+            return non_active_player;
+        default:
+            return nullptr;
+    }
+}
+
+/**
+* get the blockers that wait for their damage order
+*
+* @returns indices into the battlefield of the non-active player
+**/
+const std::vector<size_t>& game::get_blockers_to_order() const {
+    static const std::vector<size_t> none;
+    auto found = declared_blocks.find(ordered_attacker);
+    return found != declared_blocks.end() ? found->second : none;
+}
+
+/**
+* register a trigger told about every phase the game enters
+* 
+* @param on_phase the trigger
+* 
+* @returns id of the trigger for remove_trigger
+**/
+size_t game::add_trigger(trigger on_phase) {
+    triggers.push_back(std::move(on_phase));
+    return triggers.size() - 1;
+}
+
+/**
+* unregister a trigger
+* 
+* @param id id from add_trigger
+**/
+void game::remove_trigger(size_t id) {
+    if (id < triggers.size()) triggers[id] = nullptr;
+}
+
+/**
+* get the winner of the game
+*
+* @returns the player that won, nullptr if the game is not over or nobody won
+**/
+player* game::get_winner() {
+    if (!this->ended) return nullptr;
+    if (active_player->get_life() > 0 && non_active_player->get_life() <= 0) return active_player;
+    if (non_active_player->get_life() > 0 && active_player->get_life() <= 0) return non_active_player;
+    return nullptr;
+}
+
+/**
+* get the seat of the winner of the game
+*
+* @returns 1 if the first player won, 2 if the second one won, 0 if the game is not over or nobody won
+**/
+int game::get_winner_seat() {
+    player* winner = get_winner();
+    if (winner == nullptr) return 0;
+    return winner == &p1 ? 1 : 2;
+}
+
+/**
+* move to the next phase and tell the triggers
+* 
+* @param next the phase
+**/
+void game::enter(phase next) {
+    current_phase = next;
+    if (publishing && event_log_enabled(EventLevel::TURN)) publish(GameEventType::PHASE, active_player, next);
+    for (auto&& on_phase : triggers) {
+        if (on_phase) on_phase(*this, next);
+    }
+}
+
+/**
+* the game is over, the winner is decided by the life totals (see get_winner)
+**/
+void game::end_game() {
+    this->ended = true;
+    player* winner = get_winner();
+    publish(GameEventType::GAME_ENDED, winner, static_cast<int>(turn_number));
+}
+
+/**
+* publish an event of the game if it publishes events (see set_event_publishing)
+* 
+* @param type what happened
+* @param subject the player it happened to, nullptr for none
+* @param amount the phase, the number of turns, ...
+**/
+void game::publish(GameEventType type, player* subject, int amount) {
+    if (!publishing || !event_log_enabled(EventLevel::GAME)) return;
+    game_event event(origin, type, subject != nullptr ? std::string_view(subject->get_damagable_name()) : std::string_view());
+    event.amount = amount;
+    event_bus::publish(event);
+}
+
+/**
+* the steps of the turn up to the main phase, they need no decisions
+**/
+void game::begin_turn() {
+    turn_number++;
+    origin.turn = static_cast<std::uint32_t>(turn_number);
+    enter(phase::untap);
     untap();
+    enter(phase::upkeep);
     upkeep();
+    enter(phase::draw);
     draw_step();
-    main_phase(); // one main phase is enough
-    combat();
-    //main_phase();
-    end_phase();
+    begin_main_phase();
 }
 
 /**
@@ -134,20 +431,11 @@ void game::turn() {
 **/
 void game::untap() {
     if (!this->ended) {
-        if (!(active_player->get_battlefield().empty())) {
-            for (auto&& card : active_player->get_battlefield()) {
-                card->set_tapped(false);
-                if (card->get_type() == "creature") {
-					static_cast<creature*>(card.get())->set_summoning_sickness(false);
-				}
-            }
-        }
+        active_player->get_battlefield().untap_all();
     }
-    // start of untap effects
 }
 void game::upkeep() {
-    // start of upkeep, could just be end of untap
-    // might skip
+    // nothing happens in the upkeep yet, triggers are told about it
 }
 
 /**
@@ -157,108 +445,277 @@ void game::draw_step() {
     if (!this->ended) {
         active_player->draw_card(1);
         if (active_player->get_life() <= 0) {
-            this->ended = true;
+            end_game();
         }
     }
 }
 
 /**
-* main phase - active player plays max one land and any amount of non-land cards provided they have enough mana
+* main phase - active player plays max one land and any amount of non-land cards provided they have enough mana,
+* one move per step until the player passes
 **/
-void game::main_phase() {
-    if (!this->ended) {
-        non_active_player->print_battlefield();
-        active_player->display_hand();
-        active_player->print_battlefield();
-        bool main_phase_end = false;
-        while (!main_phase_end) {
-            main_phase_end = active_player->play(*non_active_player);
-        }
-        std::cout << "\n";
+void game::begin_main_phase() {
+    if (this->ended) {
+        pending = DecisionType::NONE;
+        return;
+    }
+    enter(phase::main1);
+    non_active_player->print_battlefield();
+    active_player->display_hand();
+    active_player->print_battlefield();
+    pending = DecisionType::MAIN_PHASE;
+}
 
-        if (active_player->get_life() <= 0 || non_active_player->get_life() <= 0) {
-            this->ended = true;
-        }
+/**
+* the active player passed, spells of the main phase may have ended the game or killed creatures
+**/
+void game::end_main_phase() {
+    game_log() << "\n";
+    if (active_player->get_life() <= 0 || non_active_player->get_life() <= 0) {
+        end_game();
+    }
 
-        check_deaths();
+    check_deaths();
+    begin_combat();
+}
+
+/**
+* after a main phase move, the effects of a spell may wait for a decision, otherwise the main phase goes on or ends
+* 
+* @param passed true if the active player passed
+**/
+void game::continue_main_phase(bool passed) {
+    if (discarding_player() != nullptr) {
+        pending = DecisionType::DISCARD;
+    } else if (active_player->is_resolving()) {
+        pending = DecisionType::TARGET;
+    } else if (passed) {
+        end_main_phase();
+    } else {
+        pending = DecisionType::MAIN_PHASE;
     }
 }
 
 /**
-* combat step - active player attacks and non-active player blocks
+* target the effect that waits for a target, then the next decision of the effects or the main phase
+* 
+* @param target the target in the format of agent::choose_target
+* 
+* @returns false if there is no such target, the decision stays pending
 **/
-void game::combat() {
-    if (!this->ended) {
-        // start of combat effects
-		bool selector_done = false;
-        std::vector<size_t> attackers;
-        std::map<size_t, std::vector<size_t>> blockers;
-
-        while (!selector_done) {
-            attackers = active_player->select_attackers();
-            bool summoning_sickness = false;
-            for (auto&& attacker : attackers) {
-                if (static_cast<creature*>(active_player->get_battlefield()[attacker].get())->get_summoning_sickness()) {
-                    std::cout << "one or more creatures you selected can't attack this turn\n";
-                    summoning_sickness = true;
-                    break;
-                }
-            }
+bool game::target_effect(const std::string& target) {
+    if (!active_player->target_effect(target, *non_active_player)) return false;
+    if (actions != nullptr) actions->add_target(target);
+    continue_main_phase(false);
+    return true;
+}
 
-			if (!summoning_sickness) selector_done = true;
+/**
+* get the player who chooses the cards an effect made them discard
+* 
+* @returns the player, nullptr if no effect waits for a discard
+**/
+player* game::discarding_player() {
+    if (active_player->get_discards_left() > 0) return active_player;
+    if (non_active_player->get_discards_left() > 0) return non_active_player;
+    return nullptr;
+}
+
+/**
+* combat step - active player attacks and non-active player blocks, a player without permanents is not asked for attackers
+**/
+void game::begin_combat() {
+    if (this->ended) {
+        pending = DecisionType::NONE;
+        return;
+    }
+    enter(phase::combat);
+    if (active_player->get_battlefield().empty()) {
+        declare_attackers({});
+    } else {
+        pending = DecisionType::ATTACKERS;
+    }
+}
+
+/**
+* the attackers get tapped if the selection is legal
+* 
+* @param attackers attackers
+* 
+* @returns false if some of them can't attack, the decision stays pending
+**/
+bool game::declare_attackers(const std::vector<size_t>& attackers) {
+    for (auto&& attacker : attackers) {
+        if (attacker >= active_player->get_battlefield().size()
+            || active_player->get_battlefield().get_type(attacker) != CardType::CREATURE
+            || active_player->get_battlefield().is_tapped(attacker)
+            || active_player->get_battlefield().has_summoning_sickness(attacker)) {
+            game_log() << "one or more creatures you selected can't attack this turn\n";
+            return false;
         }
+    }
+    // a player without permanents is not asked (see begin_combat), that is no decision
+    if (actions != nullptr && pending == DecisionType::ATTACKERS) actions->add_indices(attackers);
 
-        for (auto&& attacker : attackers) {
-			static_cast<creature*>(active_player->get_battlefield()[attacker].get())->set_tapped(true);
-		}
-        
-        selector_done = false;
-        if (!attackers.empty()) {
-            while (!selector_done) {
-                blockers = non_active_player->select_blockers(attackers, get_active_player());
-                bool tapped = false;
-                for (auto&& [_, blocker] : blockers) {
-                    for (auto&& i : blocker) {
-                        if (static_cast<creature*>(non_active_player->get_battlefield()[i].get())->is_tapped()) {
-                            std::cout << "one or more creatures you selected can't block this turn\n";
-                            tapped = true;
-                            break;
-                        }
-                    }
-                    if (tapped) break;
-                }
-
-                if (!tapped) selector_done = true;
+    for (auto&& attacker : attackers) {
+		active_player->get_battlefield().set_tapped(attacker, true);
+	}
+    declared_attackers = attackers;
+    if (attackers.empty()) {
+        combat_damage({});
+    } else {
+        pending = DecisionType::BLOCKERS;
+    }
+    return true;
+}
+
+/**
+* the blocks of the non-active player if they are legal, then combat damage
+* 
+* @param blockers blocks in the form of map<attacker, vector<blockers>>
+* 
+* @returns false if some of them can't block or block a creature that doesn't attack, the decision stays pending
+**/
+bool game::declare_blockers(const std::map<size_t, std::vector<size_t>>& blockers) {
+    std::vector<bool> blocking(non_active_player->get_battlefield().size(), false);
+    for (auto&& [attacker, blocker] : blockers) {
+        if (std::find(declared_attackers.begin(), declared_attackers.end(), attacker) == declared_attackers.end()) {
+            game_log() << "one or more creatures you selected to block don't attack\n";
+            return false;
+        }
+        for (auto&& i : blocker) {
+            if (i >= non_active_player->get_battlefield().size()
+                || non_active_player->get_battlefield().get_type(i) != CardType::CREATURE
+                || non_active_player->get_battlefield().is_tapped(i)
+                || blocking[i]) {
+                game_log() << "one or more creatures you selected can't block this turn\n";
+                return false;
             }
+            blocking[i] = true;
         }
-        int damage = resolve_blocks(attackers, blockers);
-        non_active_player->deal_damage(damage);
-        std::cout << active_player->get_damagable_name() << " " << active_player->get_life() << "\n";
-        std::cout << non_active_player->get_damagable_name() << " " << non_active_player->get_life() << "\n";
-        check_deaths();
     }
+    if (actions != nullptr) actions->add_blocks(blockers);
+
+    std::map<size_t, std::vector<size_t>> blocks = blockers;
+    for (auto&& attacker : declared_attackers) {
+        blocks[attacker]; // unblocked attackers still need an entry to deal damage
+    }
+    combat_damage(blocks);
+    return true;
+}
+
+/**
+* combat damage of the declared attackers
+* 
+* @param blocks blocks in the form of map<attacker, vector<blockers>>, every attacker has an entry
+**/
+void game::combat_damage(const std::map<size_t, std::vector<size_t>>& blocks) {
+    declared_blocks = blocks;
+    ordered_attacker = 0;
+    unblocked_damage = 0;
+    resolve_blocks();
+}
+
+/**
+* the damage order of the blockers of ordered_attacker if it is one, then the rest of the blocks
+* 
+* @param order the blockers in order
+* 
+* @returns false if it is not an order of the blockers, the decision stays pending
+**/
+bool game::order_blockers(const std::vector<size_t>& order) {
+    const std::vector<size_t>& blockers = get_blockers_to_order();
+    if (order.size() != blockers.size() || !std::is_permutation(order.begin(), order.end(), blockers.begin())) {
+        game_log() << "Incorrect input\n";
+        return false;
+    }
+    if (actions != nullptr) actions->add_indices(order);
+    resolve_block(ordered_attacker, blockers, order);
+    ordered_attacker++;
+    resolve_blocks();
+    return true;
+}
+
+/**
+* unblocked damage goes to the non-active player, creatures that died go to the graveyard
+**/
+void game::end_combat() {
+    int damage = unblocked_damage;
+    declared_attackers.clear();
+    declared_blocks.clear();
+    unblocked_damage = 0;
+    non_active_player->deal_damage(damage);
+    if (game_log_enabled()) {
+        game_log() << active_player->get_damagable_name() << " " << active_player->get_life() << "\n";
+        game_log() << non_active_player->get_damagable_name() << " " << non_active_player->get_life() << "\n";
+    }
+    if (non_active_player->get_life() <= 0) {
+        end_game();
+    }
+    check_deaths();
+    end_turn();
+}
+
+/**
+* the end step, the game then waits for the next turn
+**/
+void game::end_turn() {
+    pending = DecisionType::NONE;
+    if (this->ended) return;
+    enter(phase::end);
+    end_phase();
 }
 
 /**
 * end step - reset both players mana pools, creatures get healed, discard cards if needed and change who the active player is
 **/
 void game::end_phase() {
-    if (!this->ended) {
-        // start of end phase effects active_player->check_effects(ENUM end_phase)
-        p1.empty_mana_pool();
-        p2.empty_mana_pool();
-        p1.heal_creatures();
-        p2.heal_creatures();
-        active_player->reset_played_land();
-        if (active_player->get_hand().size() > STARTING_HAND_SIZE) {
-            active_player->discard(active_player->get_hand().size() - STARTING_HAND_SIZE);
-        }
-        if (&p1 == active_player) { 
-            active_player = &p2; 
-            non_active_player = &p1;
-        } else {
-            active_player = &p1;
-			non_active_player = &p2;
-        }
+    p1.empty_mana_pool();
+    p2.empty_mana_pool();
+    p1.heal_creatures();
+    p2.heal_creatures();
+    active_player->reset_played_land();
+    if (active_player->get_hand().size() > STARTING_HAND_SIZE) {
+        pending = DecisionType::DISCARD;
+        return;
+    }
+    change_active_player();
+}
+
+/**
+* a player discards a card for an effect, or the active player discards down to the hand size and the turn is over
+* 
+* @param card index into the hand
+* 
+* @returns false if there is no such card, the decision stays pending
+**/
+bool game::discard(size_t card) {
+    player* discarding = discarding_player();
+    if (discarding != nullptr) {
+        if (!discarding->discard_for_effect(card)) return false;
+        if (actions != nullptr) actions->add_index(card);
+        active_player->resume_effects(*non_active_player);
+        continue_main_phase(false);
+        return true;
+    }
+    if (!active_player->discard_card(card)) return false;
+    if (actions != nullptr) actions->add_index(card);
+    if (active_player->get_hand().size() <= STARTING_HAND_SIZE) {
+        change_active_player();
+    }
+    return true;
+}
+
+/**
+* the turn is over, the other player becomes the active player
+**/
+void game::change_active_player() {
+    pending = DecisionType::NONE;
+    if (&p1 == active_player) { 
+        active_player = &p2; 
+        non_active_player = &p1;
+    } else {
+        active_player = &p1;
+        non_active_player = &p2;
     }
 }
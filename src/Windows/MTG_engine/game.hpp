@@ -3,23 +3,63 @@
 
 #include <string>
 #include <map>
+#include <functional>
+#include <vector>
 #include "player.hpp"
 #include "deck.hpp"
+#include "random.hpp"
+#include "undo_log.hpp"
+#include "action_log.hpp"
+#include "zobrist.hpp"
 
 constexpr int STARTING_LIFE = 20;
+constexpr size_t STARTING_HAND_SIZE = 7;
 
 /**
 * roll dice to see who goes first
 * @param name1 name of player 1
 * @param name2 name of player 2
+* @param gen random generator of the game
 *
 * @returns true if player 1 wins
 **/
-bool roll_for_high(const std::string& name1, const std::string& name2);
+bool roll_for_high(const std::string& name1, const std::string& name2, game_rng& gen);
 
+// the decision a game waits for (see game::step)
+enum class DecisionType : std::uint8_t {
+	NONE,			// the game didn't start, the turn is over or the game ended, the next step deals or starts the next turn
+	MULLIGAN,		// whether a player takes a mulligan, player 1 decides first
+	MAIN_PHASE,		// a main phase move of the active player
+	ATTACKERS,		// the attackers of the active player
+	BLOCKERS,		// the blockers of the non-active player
+	ORDER_BLOCKERS,	// the damage order of the blockers of an attacker (see get_ordered_attacker), by the active player
+	DISCARD,		// a card the active player discards down to the hand size at the end of the turn, or a card a player
+					// discards for an effect (see player::get_discards_left)
+	TARGET			// the target of an effect of a spell the active player cast (see player::get_effect_to_target)
+};
+
+// the answer to a decision (see game::step), only the part for the pending decision is read
+struct decision_reply
+{
+	move chosen_move;								// MAIN_PHASE
+	std::vector<size_t> creatures;					// ATTACKERS: the attackers, ORDER_BLOCKERS: the blockers in order
+	std::map<size_t, std::vector<size_t>> blocks;	// BLOCKERS
+	bool mulligan = false;							// MULLIGAN
+	size_t card = 0;								// DISCARD: index into the hand
+	std::string target;								// TARGET: in the format of agent::choose_target
+};
+
+// a game is a step machine: it runs the phases that need no decision by itself and stops at every decision of a player,
+// step() lets the agent of that player decide, step(reply) takes the decision from the caller, so a scheduler can
+// interleave many games on one thread (see game_task)
+// the effects of a spell stop at a target they need and at the cards of a discard, the main phase goes on once they resolved
+// triggers registered with add_trigger are told about every phase the game enters
 class game
 {
 public:
+	// called when the game enters a phase, must not step the game
+	using trigger = std::function<void(game& current, phase entered)>;
+
 	/**
 	* game constructor
 	* 
@@ -27,9 +67,13 @@ public:
 	* @param name2 name of player 2
 	* @param deck1 deck of player 1
 	* @param deck2 deck of player 2
+	* @param agent1 agent deciding for player 1, console if nullptr
+	* @param agent2 agent deciding for player 2, console if nullptr
+	* @param seed seed of the game's random generator, the same seed and decisions replay the same game
 	**/
-	game(const std::string& name1, const std::string& name2, deck&& deck1, deck&& deck2) : p1(name1, std::move(deck1), STARTING_LIFE), p2(name2, std::move(deck2), STARTING_LIFE) {
-		if (roll_for_high(name1, name2)) { 
+	game(const std::string& name1, const std::string& name2, deck&& deck1, deck&& deck2, agent* agent1 = nullptr, agent* agent2 = nullptr, std::uint64_t seed = random_seed())
+		: p1(name1, std::move(deck1), STARTING_LIFE, agent1), p2(name2, std::move(deck2), STARTING_LIFE, agent2), seed(seed), rng(seed) {
+		if (roll_for_high(name1, name2, rng)) { 
 			active_player = &p1;
 			non_active_player = &p2;
 		} else {
@@ -38,6 +82,69 @@ public:
 		} 
 	}
 
+	/**
+	* copy a game into another memory resource, e.g. to search from a copy of the game without changing it
+	* the copy is at the same point of the game, its players have the same agents and it has no undo log, action log or triggers
+	* and publishes no events
+	* 
+	* @param other the game to copy
+	* @param resource memory resource of the copy (see game_arena)
+	**/
+	game(const game& other, std::pmr::memory_resource* resource)
+		: p1(other.p1, resource), p2(other.p2, resource), ended(other.ended), turn_number(other.turn_number), current_phase(other.current_phase),
+		pending(other.pending), started(other.started), p1_kept_hand(other.p1_kept_hand), declared_attackers(other.declared_attackers),
+		declared_blocks(other.declared_blocks), ordered_attacker(other.ordered_attacker), unblocked_damage(other.unblocked_damage), seed(other.seed), rng(other.rng),
+		active_player(other.active_player == &other.p1 ? &p1 : &p2), non_active_player(other.active_player == &other.p1 ? &p2 : &p1) {}
+
+	/**
+	* build a game around copies of two players, e.g. a copy of a game in the middle of a turn made from the players
+	* an agent sees (see mcts_agent), the game waits for a main phase move of the active player
+	* the copies have the same agents and the game has no undo log
+	* 
+	* @param active the player whose turn it is
+	* @param non_active the other player
+	* @param resource memory resource of the copies (see game_arena)
+	* @param seed seed of the game's random generator
+	**/
+	game(const player& active, const player& non_active, std::pmr::memory_resource* resource, std::uint64_t seed)
+		: p1(active, resource), p2(non_active, resource), current_phase(phase::main1), pending(DecisionType::MAIN_PHASE), started(true), p1_kept_hand(true), seed(seed), rng(seed), active_player(&p1), non_active_player(&p2) {}
+
+	/**
+	* set the undo log told about every change of the game and its players, so undo_log::undo can revert them
+	* 
+	* @param log the log, nullptr for none
+	**/
+	void set_undo_log(undo_log* log) {
+		journal = log;
+		p1.set_undo_log(log);
+		p2.set_undo_log(log);
+	}
+
+	/**
+	* set the action log every decision of the game and its players is added to, whoever makes it (see game_replay)
+	* 
+	* @param log the log, nullptr for none
+	**/
+	void set_action_log(action_log* log) {
+		actions = log;
+		p1.set_action_log(log);
+		p2.set_action_log(log);
+	}
+
+	/**
+	* let the game and its players publish events to the installed event_bus, at the level it was installed with,
+	* the events carry the seed of the game, copies of the game don't publish
+	* 
+	* @param publish true to publish
+	**/
+	void set_event_publishing(bool publish) {
+		origin.game = seed;
+		origin.turn = static_cast<std::uint32_t>(turn_number);
+		p1.set_event_origin(publish ? &origin : nullptr);
+		p2.set_event_origin(publish ? &origin : nullptr);
+		publishing = publish;
+	}
+
 	/**
 	* get active player
 	* 
@@ -53,14 +160,120 @@ public:
 	player* get_non_active_player() { return non_active_player; }
 
 	/**
-	* game starter - shuffles decks, gives cards and opportunity to mulligan
+	* game starter - shuffles decks, gives cards and opportunity to mulligan, the agents decide
 	**/
 	void start_game();
 	/**
-	* main game loop
+	* main game loop - play until the end of the turn, the agents decide, the next turn starts first if the game is between turns
 	**/
 	void turn();
 
+	/**
+	* play the rest of the current turn, the agents decide
+	**/
+	void finish_turn();
+
+	/**
+	* let the agent of the deciding player make the pending decision and run the game to the next decision,
+	* deal the starting hands or start the next turn if there is none, the decision stays pending if the agent's choice is illegal
+	**/
+	void step();
+
+	/**
+	* make the pending decision and run the game to the next decision
+	* @param reply the decision
+	*
+	* @returns false if there is no decision or the reply is illegal, the decision stays pending
+	**/
+	bool step(const decision_reply& reply);
+
+	/**
+	* make the pending main phase move and run the game to the next decision
+	* @param chosen the move, one of move_generator::main_phase
+	*
+	* @returns false if the game doesn't wait for a main phase move or the move is not legal (see player::is_legal_move)
+	**/
+	bool step(const move& chosen);
+
+	/**
+	* declare the pending attackers, or the pending order of blockers, and run the game to the next decision
+	* @param attackers indices into the battlefield of the active player
+	*
+	* @returns false if the game doesn't wait for attackers or an order or the choice is illegal
+	**/
+	bool step(const std::vector<size_t>& attackers);
+
+	/**
+	* declare the pending blockers and run the game to the next decision
+	* @param blockers map of declared attacker to indices into the battlefield of the non-active player
+	*
+	* @returns false if the game doesn't wait for blockers or the blocks are illegal, a creature blocks at most one attacker
+	**/
+	bool step(const std::map<size_t, std::vector<size_t>>& blockers);
+
+	/**
+	* get the decision the game waits for
+	*
+	* @returns decision, NONE between turns and after the game ended
+	**/
+	DecisionType get_decision() const { return pending; }
+
+	/**
+	* get the player who makes the pending decision
+	*
+	* @returns the player, nullptr if there is no decision
+	**/
+	player* get_deciding_player();
+
+	/**
+	* checks if the effects of a spell wait for the pending decision, a target or the cards of a discard
+	*
+	* @returns true if they wait
+	**/
+	bool is_resolving() const { return active_player->is_resolving(); }
+
+	/**
+	* get the attackers declared this combat
+	*
+	* @returns indices into the battlefield of the active player
+	**/
+	const std::vector<size_t>& get_attackers() const { return declared_attackers; }
+
+	/**
+	* get the attacker whose blockers wait for their damage order
+	*
+	* @returns index into the battlefield of the active player
+	**/
+	size_t get_ordered_attacker() const { return ordered_attacker; }
+
+	/**
+	* get the blockers that wait for their damage order
+	*
+	* @returns indices into the battlefield of the non-active player
+	**/
+	const std::vector<size_t>& get_blockers_to_order() const;
+
+	/**
+	* register a trigger told about every phase the game enters, e.g. for triggered abilities
+	* @param on_phase the trigger
+	*
+	* @returns id of the trigger
+	**/
+	size_t add_trigger(trigger on_phase);
+
+	/**
+	* unregister a trigger
+	* @param id id from add_trigger
+	**/
+	void remove_trigger(size_t id);
+
+	/**
+	* play the rest of the current turn after the attackers were declared and tapped: blocks, combat damage and end step
+	* 
+	* @param attackers the attackers, indices into the battlefield of the active player
+	**/
+	void finish_turn_after_attackers(const std::vector<size_t>& attackers);
+
 	/**
 	* check if the game is ended
 	* 
@@ -68,34 +281,151 @@ public:
 	**/
 	bool is_ended() const { return ended; }
 
-	
-	//int round = 0;
-	
+	/**
+	* check if the starting hands were dealt
+	* 
+	* @returns true once the game started
+	**/
+	bool is_started() const { return started; }
+
+	/**
+	* get the winner of the game
+	*
+	* @returns the player that won, nullptr if the game is not over or nobody won
+	**/
+	player* get_winner();
+
+	/**
+	* get the seat of the winner of the game, the players are in the order of the constructor
+	*
+	* @returns 1 if the first player won, 2 if the second one won, 0 if the game is not over or nobody won
+	**/
+	int get_winner_seat();
+
+	/**
+	* get the number of turns started so far
+	*
+	* @returns turn number
+	**/
+	size_t get_turn_number() const { return turn_number; }
+
+	/**
+	* get the phase the game is in
+	*
+	* @returns phase
+	**/
+	phase get_phase() const { return current_phase; }
+
+	/**
+	* get the zobrist hash of the game: both players (see player::hash), who is active, the phase and decision, the combat
+	* in progress (attackers, blocks and the attacker whose blocks resolve next), who decides a mulligan and whether the game ended
+	* the turn number and the random generator are left out, the same position on another turn hashes the same
+	*
+	* @returns hash
+	**/
+	std::uint64_t hash() const {
+		std::uint64_t ret = zobrist_key(zobrist_part::ACTIVE, active_player->hash()) + zobrist_key(zobrist_part::NON_ACTIVE, non_active_player->hash())
+			+ zobrist_key(zobrist_part::PHASE, current_phase, static_cast<std::uint64_t>(pending));
+		for (size_t i = 0; i < declared_attackers.size(); i++) {
+			ret += zobrist_key(zobrist_part::ATTACKER, declared_attackers[i], i);
+		}
+		for (const auto& [attacker, blockers] : declared_blocks) {
+			for (size_t i = 0; i < blockers.size(); i++) {
+				ret += zobrist_key(zobrist_part::BLOCK, (static_cast<std::uint64_t>(attacker) << 32) + blockers[i], i);
+			}
+		}
+		// the combat is over once its blocks are cleared, ordered_attacker is left from it
+		if (!declared_blocks.empty()) {
+			ret += zobrist_key(zobrist_part::ORDERED_ATTACKER, ordered_attacker, static_cast<std::uint64_t>(unblocked_damage));
+		}
+		if (pending == DecisionType::MULLIGAN && p1_kept_hand) ret += zobrist_key(zobrist_part::KEPT_HAND, 0);
+		if (ended) ret += zobrist_key(zobrist_part::ENDED, 0);
+		return ret;
+	}
+
+	/**
+	* get the seed the game was started with
+	*
+	* @returns seed
+	**/
+	std::uint64_t get_seed() const { return seed; }
+
 
 private:
+	friend class undo_log;
+
 	player p1;
 	player p2;
 
 	bool ended = false;
+	size_t turn_number = 0;
+	phase current_phase = phase::end;
+	DecisionType pending = DecisionType::NONE;
+	bool started = false;
+	bool p1_kept_hand = false;
+
+	// the combat in progress, blocks are resolved in the order of the attackers, from ordered_attacker on
+	std::vector<size_t> declared_attackers;
+	std::map<size_t, std::vector<size_t>> declared_blocks;
+	size_t ordered_attacker = 0;
+	int unblocked_damage = 0;
+
+	std::uint64_t seed;
+	game_rng rng;
 
 	player* active_player;
 	player* non_active_player;
 
+	std::vector<trigger> triggers;
+
+	undo_log* journal = nullptr;
+	action_log* actions = nullptr;
+	event_origin origin;
+	bool publishing = false;
+
+	void record_counters() {
+		if (journal != nullptr) journal->save_counters(*this);
+	}
+
+	void enter(phase next);
+	void end_game();
+	void publish(GameEventType type, player* subject, int amount = 0);
+	void deal();
+	void decide_mulligan(bool take);
+	void begin_turn();
     void untap();
     void upkeep();
     void draw_step();
-    void main_phase();
-    void combat();
+	void begin_main_phase();
+	void end_main_phase();
+	void continue_main_phase(bool passed);
+	bool target_effect(const std::string& target);
+	player* discarding_player();
+	void begin_combat();
+	bool declare_attackers(const std::vector<size_t>& attackers);
+	bool declare_blockers(const std::map<size_t, std::vector<size_t>>& blockers);
+	void combat_damage(const std::map<size_t, std::vector<size_t>>& blocks);
+	bool order_blockers(const std::vector<size_t>& order);
+	void end_combat();
+	void end_turn();
     void end_phase();
+	bool discard(size_t card);
+	void change_active_player();
 
 	/**
-	* resolve blocks
-	* @param attackers attackers in the form of vector
-	* @param blocks blocks in the form of map<attacker, vector<blockers>>
-	*
-	* @returns damage
+	* resolve the blocks from ordered_attacker on, stops at an attacker that needs the order of its blockers
 	**/
-	int resolve_blocks(const std::vector<size_t>& attackers, const std::map<size_t, std::vector<size_t>>& blockers);
+	void resolve_blocks();
+
+	/**
+	* resolve the block of one attacker, the damage of an unblocked attacker goes to unblocked_damage
+	* @param attacker the attacker
+	* @param blockers its blockers
+	* @param order its blockers in damage order, only read if it needs one (see needs_order)
+	**/
+	void resolve_block(size_t attacker, const std::vector<size_t>& blockers, const std::vector<size_t>& order);
+
+	bool needs_order(size_t attacker, const std::vector<size_t>& blockers);
 	/**
 	* check for deaths of creatures on the battlefield
 	**/
@@ -0,0 +1,248 @@
+#include "game_events.hpp"
+
+#include <chrono>
+#include <stdexcept>
+
+namespace {
+
+std::atomic<event_bus*> installed_bus{ nullptr };
+// publishers that may hold the installed bus, the bus waits for them before it is freed
+std::atomic<size_t> publishing{ 0 };
+
+const char* event_name(GameEventType type) {
+    switch (type) {
+        case GameEventType::GAME_STARTED: return "game_started";
+        case GameEventType::GAME_ENDED: return "game_ended";
+        case GameEventType::PHASE: return "phase";
+        case GameEventType::SPELL_CAST: return "spell_cast";
+        case GameEventType::LAND_PLAYED: return "land_played";
+        case GameEventType::DAMAGE: return "damage";
+        case GameEventType::LIFE_GAINED: return "life_gained";
+        case GameEventType::ZONE_CHANGE: return "zone_change";
+    }
+    return "unknown";
+}
+
+const char* zone_name(ZoneType zone) {
+    switch (zone) {
+        case ZoneType::LIBRARY: return "library";
+        case ZoneType::HAND: return "hand";
+        case ZoneType::BATTLEFIELD: return "battlefield";
+        case ZoneType::GRAVEYARD: return "graveyard";
+        default: return "none";
+    }
+}
+
+const char* phase_name(int entered) {
+    static const char* const names[] = { "untap", "upkeep", "draw", "main1", "combat", "main2", "end" };
+    return (entered >= 0 && entered < 7) ? names[entered] : "unknown";
+}
+
+// the catalog is only added to while decks are loaded, the bus reads it while games run
+const std::string& card_name(card_id card) {
+    return card_definition(card).get_name();
+}
+
+void write_json_string(std::ostream& out, std::string_view text) {
+    out << '"';
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            out << '\\' << c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            out << ' ';
+        } else {
+            out << c;
+        }
+    }
+    out << '"';
+}
+
+}
+
+void text_event_sink::write(const game_event& event) {
+    out << "game " << event.game << " turn " << event.turn << ": ";
+    switch (event.type) {
+        case GameEventType::GAME_STARTED:
+            out << event.player << " goes first";
+            break;
+        case GameEventType::GAME_ENDED:
+            if (event.player[0] != '\0') {
+                out << event.player << " wins after " << event.amount << " turns";
+            } else {
+                out << "draw after " << event.amount << " turns";
+            }
+            break;
+        case GameEventType::PHASE:
+            out << event.player << " enters " << phase_name(event.amount);
+            break;
+        case GameEventType::SPELL_CAST:
+            out << event.player << " casts " << card_name(event.card);
+            break;
+        case GameEventType::LAND_PLAYED:
+            out << event.player << " plays " << card_name(event.card);
+            break;
+        case GameEventType::DAMAGE:
+            if (event.card != NO_EVENT_CARD) {
+                out << card_name(event.card) << " of " << event.player << " takes " << event.amount << " damage, " << event.total << " health left";
+            } else {
+                out << event.player << " takes " << event.amount << " damage, " << event.total << " life left";
+            }
+            break;
+        case GameEventType::LIFE_GAINED:
+            out << event.player << " gains " << event.amount << " life, " << event.total << " life";
+            break;
+        case GameEventType::ZONE_CHANGE:
+            out << card_name(event.card) << " of " << event.player << " moves from " << zone_name(event.from) << " to " << zone_name(event.to);
+            break;
+    }
+    out << '\n';
+}
+
+void text_event_sink::flush() {
+    out.flush();
+}
+
+void json_event_sink::write(const game_event& event) {
+    out << "{\"game\":" << event.game << ",\"turn\":" << event.turn << ",\"event\":\"" << event_name(event.type) << "\",\"player\":";
+    write_json_string(out, event.player);
+    if (event.card != NO_EVENT_CARD) {
+        out << ",\"card\":";
+        write_json_string(out, card_name(event.card));
+    }
+    switch (event.type) {
+        case GameEventType::GAME_ENDED:
+            out << ",\"turns\":" << event.amount;
+            break;
+        case GameEventType::PHASE:
+            out << ",\"phase\":\"" << phase_name(event.amount) << '"';
+            break;
+        case GameEventType::DAMAGE:
+        case GameEventType::LIFE_GAINED:
+            out << ",\"amount\":" << event.amount << ",\"total\":" << event.total;
+            break;
+        case GameEventType::ZONE_CHANGE:
+            out << ",\"from\":\"" << zone_name(event.from) << "\",\"to\":\"" << zone_name(event.to) << '"';
+            break;
+        default:
+            break;
+    }
+    out << "}\n";
+}
+
+void json_event_sink::flush() {
+    out.flush();
+}
+
+std::unique_ptr<event_sink> make_event_sink(const std::string& format, std::ostream& out) {
+    if (format == "text") return std::make_unique<text_event_sink>(out);
+    if (format == "json") return std::make_unique<json_event_sink>(out);
+    if (format == "null") return std::make_unique<null_event_sink>();
+    throw std::runtime_error("unknown event format: " + format);
+}
+
+event_bus::event_bus(event_sink& sink, EventLevel level, size_t capacity, bool drop_when_full) : sink(sink), drop_when_full(drop_when_full) {
+    size_t size = 2;
+    while (size < capacity) size *= 2;
+    cells = std::make_unique<cell[]>(size);
+    mask = size - 1;
+    for (size_t i = 0; i < size; i++) {
+        cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    event_bus* none = nullptr;
+    if (!installed_bus.compare_exchange_strong(none, this)) {
+        throw std::runtime_error("an event bus is already installed");
+    }
+    consumer = std::thread([this]() { consume(); });
+    event_log_level.store(static_cast<std::uint8_t>(level), std::memory_order_relaxed);
+}
+
+event_bus::~event_bus() {
+    event_log_level.store(static_cast<std::uint8_t>(EventLevel::OFF), std::memory_order_relaxed);
+    installed_bus.store(nullptr);
+    // a publisher that loaded the bus before it was uninstalled may still push to it
+    while (publishing.load() != 0) {
+        std::this_thread::yield();
+    }
+    stopping.store(true);
+    consumer.join();
+}
+
+bool event_bus::publish(const game_event& event) {
+    // counted before the bus is loaded, the destructor either sees the count or this sees no bus
+    publishing.fetch_add(1);
+    event_bus* bus = installed_bus.load();
+    bool pushed = bus != nullptr;
+    while (pushed && !bus->try_push(event)) {
+        if (bus->drop_when_full) {
+            bus->dropped.fetch_add(1, std::memory_order_relaxed);
+            pushed = false;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    if (pushed) bus->published.fetch_add(1, std::memory_order_relaxed);
+    publishing.fetch_sub(1, std::memory_order_release);
+    return pushed;
+}
+
+bool event_bus::try_push(const game_event& event) {
+    size_t position = enqueue_position.load(std::memory_order_relaxed);
+    while (true) {
+        cell& target = cells[position & mask];
+        size_t sequence = target.sequence.load(std::memory_order_acquire);
+        if (sequence == position) {
+            // the cell is free, claim it
+            if (enqueue_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                target.event = event;
+                target.sequence.store(position + 1, std::memory_order_release);
+                return true;
+            }
+        } else if (sequence < position) {
+            // the consumer didn't take the event a lap ago yet, the buffer is full
+            return false;
+        } else {
+            position = enqueue_position.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+bool event_bus::try_pop(game_event& event) {
+    cell& source = cells[dequeue_position & mask];
+    if (source.sequence.load(std::memory_order_acquire) != dequeue_position + 1) return false;
+    event = source.event;
+    // free the cell for the producer one lap ahead
+    source.sequence.store(dequeue_position + mask + 1, std::memory_order_release);
+    dequeue_position++;
+    return true;
+}
+
+void event_bus::consume() {
+    game_event event;
+    bool written = false;
+    size_t idle = 0;
+    while (true) {
+        if (try_pop(event)) {
+            sink.write(event);
+            written = true;
+            idle = 0;
+            continue;
+        }
+        if (stopping.load()) {
+            // the games stopped publishing, take what is left
+            while (try_pop(event)) sink.write(event);
+            sink.flush();
+            return;
+        }
+        if (written) {
+            sink.flush();
+            written = false;
+        }
+        // spin a little, then sleep longer the longer nothing comes
+        if (++idle < 64) {
+            std::this_thread::yield();
+        } else {
+            std::this_thread::sleep_for(std::chrono::microseconds(idle < 1024 ? 100 : 1000));
+        }
+    }
+}
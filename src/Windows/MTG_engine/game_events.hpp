@@ -0,0 +1,230 @@
+#ifndef MTG_ENGINE_GAME_EVENTS_H
+#define MTG_ENGINE_GAME_EVENTS_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include "card_catalog.hpp"
+
+// how much the games publish, every level includes the ones before it
+enum class EventLevel : std::uint8_t {
+	OFF,	// nothing, the games only check the level
+	GAME,	// games starting and ending
+	TURN,	// phases, spells, lands, damage and life gained
+	ZONE	// every card moving from one zone to another
+};
+
+enum class GameEventType : std::uint8_t {
+	GAME_STARTED,	// player: who goes first
+	GAME_ENDED,		// player: the winner, empty for a draw, amount: number of turns
+	PHASE,			// player: the active player, amount: the phase
+	SPELL_CAST,		// player: the caster, card: the spell
+	LAND_PLAYED,	// player: who played it, card: the land
+	DAMAGE,			// player: the player dealt damage or the controller of card, amount: damage, total: life or health left
+	LIFE_GAINED,	// player: who gained it, amount: life gained, total: life
+	ZONE_CHANGE		// player: whose zones, card: the card, from and to: the zones
+};
+
+enum class ZoneType : std::uint8_t {
+	NONE,
+	LIBRARY,
+	HAND,
+	BATTLEFIELD,
+	GRAVEYARD
+};
+
+// the card of an event about a player
+constexpr card_id NO_EVENT_CARD = UINT32_MAX;
+
+// the game an event belongs to, kept by the game and read by its players when they publish
+struct event_origin
+{
+	std::uint64_t game = 0;		// seed of the game
+	std::uint32_t turn = 0;
+};
+
+// one thing that happened in a game, small and trivially copyable so it can be queued without allocating
+struct game_event
+{
+	static constexpr size_t NAME_SIZE = 24;
+
+	std::uint64_t game = 0;
+	std::uint32_t turn = 0;
+	GameEventType type = GameEventType::PHASE;
+	ZoneType from = ZoneType::NONE;
+	ZoneType to = ZoneType::NONE;
+	card_id card = NO_EVENT_CARD;
+	std::int32_t amount = 0;
+	std::int32_t total = 0;
+	char player[NAME_SIZE] = {};	// cut to NAME_SIZE - 1 characters
+
+	game_event() = default;
+
+	/**
+	* game event constructor
+	* @param origin the game and turn
+	* @param type what happened
+	* @param player_name the player it happened to
+	**/
+	game_event(const event_origin& origin, GameEventType type, std::string_view player_name) : game(origin.game), turn(origin.turn), type(type) {
+		player_name.copy(player, std::min(player_name.size(), NAME_SIZE - 1));
+	}
+};
+
+/**
+* the level the games publish at, read by event_log_enabled, set by event_bus
+**/
+inline std::atomic<std::uint8_t> event_log_level{ 0 };
+
+/**
+* checks if events of a level are published, the only cost of an event while they are off
+* @param level level of the event
+*
+* @returns true if the event should be built and published
+**/
+inline bool event_log_enabled(EventLevel level) {
+	return static_cast<std::uint8_t>(level) <= event_log_level.load(std::memory_order_relaxed);
+}
+
+// where the events end up, called from the thread of the event_bus only
+class event_sink
+{
+public:
+	virtual ~event_sink() = default;
+
+	/**
+	* take one event
+	* @param event the event
+	**/
+	virtual void write(const game_event& event) = 0;
+
+	/**
+	* called when the bus has no more events for now
+	**/
+	virtual void flush() {}
+};
+
+// drops every event, e.g. to measure the cost of publishing
+class null_event_sink : public event_sink
+{
+public:
+	void write(const game_event&) override {}
+};
+
+// one line of text per event, e.g. "game 42 turn 3: Player 1 casts Lightning Bolt"
+class text_event_sink : public event_sink
+{
+public:
+	explicit text_event_sink(std::ostream& out) : out(out) {}
+
+	void write(const game_event& event) override;
+	void flush() override;
+
+private:
+	std::ostream& out;
+};
+
+// one JSON object per line, e.g. {"game":42,"turn":3,"event":"spell_cast","player":"Player 1","card":"Lightning Bolt"}
+class json_event_sink : public event_sink
+{
+public:
+	explicit json_event_sink(std::ostream& out) : out(out) {}
+
+	void write(const game_event& event) override;
+	void flush() override;
+
+private:
+	std::ostream& out;
+};
+
+/**
+* build a sink by the name of its format
+* throws std::runtime_error for an unknown format
+* @param format "text", "json" or "null"
+* @param out where the text or JSON goes
+*
+* @returns the sink
+**/
+std::unique_ptr<event_sink> make_event_sink(const std::string& format, std::ostream& out);
+
+// takes the events of all games of all threads into a lock-free ring buffer (a bounded queue with a sequence number per
+// cell, so publishing is one compare and swap and two stores) and hands them to a sink on a thread of its own,
+// a full buffer makes the game wait until the sink caught up, or drops the event and counts it if the bus was told to
+// one bus is installed at a time, from its construction to its destruction, and sets the level of the games
+class event_bus
+{
+public:
+	/**
+	* event bus constructor, installs the bus and starts its thread
+	* throws std::runtime_error if another bus is installed
+	* @param sink where the events go, it has to outlive the bus
+	* @param level what the games publish
+	* @param capacity number of events the buffer holds, rounded up to a power of two
+	* @param drop_when_full true to drop the events that don't fit instead of waiting, the games never wait for the sink
+	**/
+	event_bus(event_sink& sink, EventLevel level, size_t capacity = 1 << 16, bool drop_when_full = false);
+
+	/**
+	* turns publishing off, waits for the events being published, hands the events left to the sink and stops the thread,
+	* later events of the games are not published
+	**/
+	~event_bus();
+
+	event_bus(const event_bus&) = delete;
+	event_bus& operator=(const event_bus&) = delete;
+
+	/**
+	* queue an event for the installed bus, from any thread
+	* @param event the event
+	*
+	* @returns false if no bus is installed or the event was dropped
+	**/
+	static bool publish(const game_event& event);
+
+	/**
+	* get the number of events queued so far
+	*
+	* @returns number of events
+	**/
+	size_t get_published() const {
+		return published.load(std::memory_order_relaxed);
+	}
+
+	/**
+	* get the number of events dropped because the buffer was full (see drop_when_full)
+	*
+	* @returns number of events
+	**/
+	size_t get_dropped() const {
+		return dropped.load(std::memory_order_relaxed);
+	}
+
+private:
+	struct cell {
+		std::atomic<size_t> sequence;
+		game_event event;
+	};
+
+	event_sink& sink;
+	std::unique_ptr<cell[]> cells;
+	size_t mask;
+	bool drop_when_full;
+	alignas(64) std::atomic<size_t> enqueue_position{ 0 };
+	alignas(64) size_t dequeue_position = 0;
+	std::atomic<size_t> published{ 0 };
+	std::atomic<size_t> dropped{ 0 };
+	std::atomic<bool> stopping{ false };
+	std::thread consumer;
+
+	bool try_push(const game_event& event);
+	bool try_pop(game_event& event);
+	void consume();
+};
+
+#endif //MTG_ENGINE_GAME_EVENTS_H
@@ -0,0 +1,53 @@
+#ifndef MTG_ENGINE_GAME_LOG_H
+#define MTG_ENGINE_GAME_LOG_H
+
+#include <iostream>
+
+/**
+* the stream the current thread writes game messages to
+*
+* @returns reference to the stream pointer, std::cout by default
+**/
+inline std::ostream*& game_log_stream() {
+	thread_local std::ostream* stream = &std::cout;
+	return stream;
+}
+
+/**
+* a stream without a buffer, everything written to it is dropped
+*
+* @returns the null stream of the current thread
+**/
+inline std::ostream& null_game_log() {
+	thread_local std::ostream null_stream(nullptr);
+	return null_stream;
+}
+
+/**
+* get the stream game messages (rolls, effects, life totals, battlefields) are written to
+*
+* @returns the stream
+**/
+inline std::ostream& game_log() {
+	return *game_log_stream();
+}
+
+/**
+* redirect game messages of the current thread
+*
+* @param stream new stream, nullptr silences the engine
+**/
+inline void set_game_log(std::ostream* stream) {
+	game_log_stream() = (stream != nullptr) ? stream : &null_game_log();
+}
+
+/**
+* checks if game messages are written anywhere, used to skip building expensive messages
+*
+* @returns true if the engine is not silenced
+**/
+inline bool game_log_enabled() {
+	return game_log_stream() != &null_game_log();
+}
+
+#endif //MTG_ENGINE_GAME_LOG_H
@@ -0,0 +1,80 @@
+#include "game_task.hpp"
+
+// suspends the game until its source wrote the reply, unless the source replies right away
+// it is a named local of the coroutine, GCC 12 frees the string of the reply of a temporary awaiter at a wrong address
+struct decision_awaiter
+{
+    game& current;
+    decision_source& source;
+    decision_reply reply = {};
+
+    bool await_ready() const noexcept {
+        return false;
+    }
+
+    bool await_suspend(std::coroutine_handle<> waiting) {
+        // once request returns false the game may already run on another thread, the awaiter is not touched anymore
+        return !source.request(current, reply, waiting);
+    }
+
+    const decision_reply& await_resume() const {
+        return reply;
+    }
+};
+
+game_task& game_task::operator=(game_task&& other) noexcept {
+    if (this != &other) {
+        if (coroutine) coroutine.destroy();
+        coroutine = other.coroutine;
+        other.coroutine = nullptr;
+    }
+    return *this;
+}
+
+game_task::~game_task() {
+    if (coroutine) coroutine.destroy();
+}
+
+void game_task::rethrow_if_failed() const {
+    if (coroutine && coroutine.promise().error) {
+        std::rethrow_exception(coroutine.promise().error);
+    }
+}
+
+void game_scheduler::schedule(std::coroutine_handle<> ready) {
+    std::lock_guard<std::mutex> guard(lock);
+    queue.push_back(ready);
+}
+
+size_t game_scheduler::run() {
+    size_t resumed = 0;
+    while (true) {
+        std::coroutine_handle<> next;
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            if (queue.empty()) return resumed;
+            next = queue.front();
+            queue.pop_front();
+        }
+        next.resume();
+        resumed++;
+    }
+}
+
+size_t game_scheduler::size() const {
+    std::lock_guard<std::mutex> guard(lock);
+    return queue.size();
+}
+
+game_task play_game(game& current, decision_source* source) {
+    while (!current.is_ended()) {
+        // dealing and the steps between turns need no decision, the agents make the decisions the source leaves to them
+        if (source == nullptr || current.get_decision() == DecisionType::NONE || !source->decides(current)) {
+            current.step();
+            continue;
+        }
+        // an illegal reply leaves the decision pending, it is asked again
+        decision_awaiter decision{ current, *source };
+        current.step(co_await decision);
+    }
+}
@@ -0,0 +1,131 @@
+#ifndef MTG_ENGINE_GAME_TASK_H
+#define MTG_ENGINE_GAME_TASK_H
+
+#include <coroutine>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include "game.hpp"
+
+// where the decisions of a game played by play_game come from, e.g. an agent that waits for a reply over the network
+// or batches the decisions of many games
+class decision_source
+{
+public:
+	virtual ~decision_source() = default;
+
+	/**
+	* checks if the source makes the pending decision of a game, the agent of the deciding player makes the others
+	* @param current the game
+	*
+	* @returns true to be asked with request
+	**/
+	virtual bool decides(game&) {
+		return true;
+	}
+
+	/**
+	* ask for the pending decision of a game (see game::get_decision and game::get_deciding_player)
+	* @param current the game
+	* @param reply where the decision goes
+	* @param waiting the suspended game, to be resumed (e.g. with game_scheduler::schedule) once reply is written
+	*
+	* @returns true if reply was written right away, the game goes on without suspending and waiting must not be resumed
+	**/
+	virtual bool request(game& current, decision_reply& reply, std::coroutine_handle<> waiting) = 0;
+};
+
+// a game played as a coroutine, it starts suspended and suspends at every decision its source can't answer right away
+// the task owns the coroutine, not the game
+class game_task
+{
+public:
+	struct promise_type {
+		std::exception_ptr error;
+
+		game_task get_return_object() {
+			return game_task(std::coroutine_handle<promise_type>::from_promise(*this));
+		}
+		std::suspend_always initial_suspend() noexcept { return {}; }
+		std::suspend_always final_suspend() noexcept { return {}; }
+		void return_void() {}
+		void unhandled_exception() { error = std::current_exception(); }
+	};
+
+	game_task(game_task&& other) noexcept : coroutine(other.coroutine) {
+		other.coroutine = nullptr;
+	}
+	game_task& operator=(game_task&& other) noexcept;
+	~game_task();
+
+	/**
+	* get the coroutine to resume it, e.g. to start the game
+	*
+	* @returns handle
+	**/
+	std::coroutine_handle<> get_handle() const {
+		return coroutine;
+	}
+
+	/**
+	* checks if the game ended (or threw)
+	*
+	* @returns true if the coroutine finished
+	**/
+	bool done() const {
+		return coroutine.done();
+	}
+
+	/**
+	* rethrow the exception the game threw, if it threw one
+	**/
+	void rethrow_if_failed() const;
+
+private:
+	std::coroutine_handle<promise_type> coroutine;
+
+	explicit game_task(std::coroutine_handle<promise_type> coroutine) : coroutine(coroutine) {}
+};
+
+// resumes games whose decisions arrived, schedule and run can be called from any thread
+// run on several threads resumes several games at once, a game is only in the queue while it waits for nothing
+class game_scheduler
+{
+public:
+	/**
+	* queue a game to be resumed
+	* @param ready the game
+	**/
+	void schedule(std::coroutine_handle<> ready);
+
+	/**
+	* resume queued games until the queue is empty, games that suspend wait for their source to schedule them again
+	*
+	* @returns number of games resumed
+	**/
+	size_t run();
+
+	/**
+	* get the number of queued games
+	*
+	* @returns number of games
+	**/
+	size_t size() const;
+
+private:
+	mutable std::mutex lock;
+	std::deque<std::coroutine_handle<>> queue;
+};
+
+/**
+* play a game from where it is to its end as a coroutine, every decision is asked from source
+* @param current the game, it has to outlive the task
+* @param source where the decisions come from, nullptr to let the agents of the players decide (see game::step and
+* decision_source::decides)
+*
+* @returns the task, suspended before the first step
+**/
+game_task play_game(game& current, decision_source* source);
+
+#endif //MTG_ENGINE_GAME_TASK_H
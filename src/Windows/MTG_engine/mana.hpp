@@ -0,0 +1,142 @@
+#ifndef MTG_ENGINE_MANA_H
+#define MTG_ENGINE_MANA_H
+
+#include <cctype>
+#include <cstdint>
+#include <string_view>
+#include "color.hpp"
+
+// an amount of mana of every color packed into one integer, 8 bits per color in the order of the color enum
+// amounts are capped at 127 so comparing all colors at once never borrows from the next color
+class mana
+{
+public:
+	static constexpr std::uint8_t MAX_AMOUNT = 127;
+
+	constexpr mana() = default;
+
+	/**
+	* get the mana of a color
+	* @param color_of_mana the color
+	*
+	* @returns amount
+	**/
+	constexpr unsigned get(color color_of_mana) const {
+		return static_cast<unsigned>((lanes >> shift(color_of_mana)) & 0xFF);
+	}
+
+	/**
+	* add mana of a color, up to MAX_AMOUNT
+	* @param color_of_mana the color
+	* @param amount amount to add
+	**/
+	constexpr void add(color color_of_mana, unsigned amount = 1) {
+		unsigned sum = get(color_of_mana) + amount;
+		if (sum > MAX_AMOUNT) sum = MAX_AMOUNT;
+		lanes = (lanes & ~(std::uint64_t{ 0xFF } << shift(color_of_mana))) | (std::uint64_t{ sum } << shift(color_of_mana));
+	}
+
+	/**
+	* get the mana of all colors together
+	*
+	* @returns amount
+	**/
+	constexpr unsigned total() const {
+		return static_cast<unsigned>((lanes & 0xFF) + ((lanes >> 8) & 0xFF) + ((lanes >> 16) & 0xFF)
+			+ ((lanes >> 24) & 0xFF) + ((lanes >> 32) & 0xFF));
+	}
+
+	/**
+	* checks if there is at least as much mana of every color as in other
+	* @param other the mana to compare to
+	*
+	* @returns true if every color has enough
+	**/
+	constexpr bool contains(mana other) const {
+		// set the high bit of every lane, subtract and see which lanes borrowed it
+		return (((lanes | HIGH_BITS) - other.lanes) & HIGH_BITS) == HIGH_BITS;
+	}
+
+	/**
+	* checks if there is no mana
+	*
+	* @returns true if empty
+	**/
+	constexpr bool empty() const {
+		return lanes == 0;
+	}
+
+	/**
+	* remove all mana
+	**/
+	constexpr void clear() {
+		lanes = 0;
+	}
+
+	/**
+	* get the amounts of all colors packed, e.g. to hash the mana
+	*
+	* @returns packed amounts
+	**/
+	constexpr std::uint64_t bits() const {
+		return lanes;
+	}
+
+	constexpr bool operator==(const mana&) const = default;
+
+private:
+	static constexpr std::uint64_t HIGH_BITS = 0x0000008080808080ULL;
+
+	std::uint64_t lanes = 0;
+
+	static constexpr unsigned shift(color color_of_mana) {
+		return static_cast<unsigned>(color_of_mana) * 8;
+	}
+};
+
+// a mana cost like "1RR" compiled when the card is loaded: the colored part per color and the generic part
+struct mana_cost
+{
+	mana colored;
+	unsigned generic = 0;
+
+	/**
+	* compiles a mana cost
+	* @param cost the cost as written on the card (e.g. "1RR"), digits are the generic part
+	*
+	* @returns the compiled cost
+	**/
+	static mana_cost parse(std::string_view cost) {
+		mana_cost ret;
+		for (auto&& ch : cost) {
+			if (isdigit(static_cast<unsigned char>(ch))) {
+				ret.generic = ret.generic * 10 + (ch - '0');
+			} else if (isalpha(static_cast<unsigned char>(ch))) {
+				ret.colored.add(char_to_color_map(ch));
+			}
+		}
+		return ret;
+	}
+
+	/**
+	* get the mana value of the cost
+	*
+	* @returns generic and colored mana together
+	**/
+	unsigned total() const {
+		return generic + colored.total();
+	}
+};
+
+/**
+* checks if a pool can pay a cost, the colored part with mana of its color and the generic part with anything left
+* @param pool the mana available
+* @param cost the cost
+*
+* @returns true if the cost can be paid
+**/
+constexpr bool can_pay(mana pool, const mana_cost& cost) {
+	return pool.contains(cost.colored) && pool.total() - cost.colored.total() >= cost.generic;
+}
+
+#endif //MTG_ENGINE_MANA_H
@@ -0,0 +1,45 @@
+#ifndef MTG_ENGINE_MAPPED_FILE_H
+#define MTG_ENGINE_MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+
+// read-only memory mapping of a whole file, unmapped when destroyed
+class mapped_file
+{
+public:
+	/**
+	* maps a file into memory
+	* throws std::runtime_error if the file can not be opened or mapped
+	* @param filename path to the file
+	**/
+	explicit mapped_file(const std::string& filename);
+	~mapped_file();
+
+	mapped_file(const mapped_file&) = delete;
+	mapped_file& operator=(const mapped_file&) = delete;
+
+	/**
+	* get the contents of the file
+	*
+	* @returns pointer to the first byte, nullptr for an empty file
+	**/
+	const std::byte* data() const { return bytes; }
+
+	/**
+	* get the size of the file
+	*
+	* @returns size in bytes
+	**/
+	size_t size() const { return length; }
+
+private:
+	const std::byte* bytes = nullptr;
+	size_t length = 0;
+#ifdef _WIN32
+	void* file_handle = nullptr;
+	void* mapping_handle = nullptr;
+#endif
+};
+
+#endif //MTG_ENGINE_MAPPED_FILE_H
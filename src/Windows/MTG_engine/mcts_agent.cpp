@@ -0,0 +1,537 @@
+#include "mcts_agent.hpp"
+#include "game.hpp"
+#include "arena.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <optional>
+#include "player.hpp"
+
+// options of a flat choice are listed in full up to this many
+constexpr size_t MAX_ENUMERATED_OPTIONS = 64;
+
+// random agent of a copy, plays the option being searched when the copy gets to that decision
+class playout_agent : public random_agent
+{
+public:
+    using random_agent::random_agent;
+
+    std::optional<std::vector<size_t>> attackers;
+    std::optional<std::map<size_t, std::vector<size_t>>> blockers;
+
+    std::vector<size_t> choose_attackers(player& me, player& opponent) override {
+        if (attackers) {
+            std::vector<size_t> ret = std::move(*attackers);
+            attackers.reset();
+            return ret;
+        }
+        return random_agent::choose_attackers(me, opponent);
+    }
+
+    std::map<size_t, std::vector<size_t>> choose_blockers(player& me, player& opponent, const std::vector<size_t>& attackers_) override {
+        if (blockers) {
+            std::map<size_t, std::vector<size_t>> ret = std::move(*blockers);
+            blockers.reset();
+            return ret;
+        }
+        return random_agent::choose_blockers(me, opponent, attackers_);
+    }
+};
+
+// what a thread needs for its playouts, kept between decisions so the playouts stop allocating
+struct mcts_worker
+{
+    game_arena arena;
+    playout_agent me{0};
+    playout_agent opponent{0};
+    move_generator moves;
+    std::pmr::vector<move> taps;
+    game_rng rng;
+    std::vector<std::uint32_t> path;
+    std::vector<std::uint64_t> positions;
+};
+
+/**
+* get the worker of the current thread
+*
+* @returns the worker
+**/
+static mcts_worker& local_worker() {
+    thread_local mcts_worker worker;
+    return worker;
+}
+
+/**
+* deal the hand of a player the searching player can't see again: the hand goes back into the library
+* and as many cards are drawn from the shuffled library
+* @param hidden the player
+* @param gen random generator
+**/
+static void deal_hidden_cards(player& hidden, game_rng& gen) {
+    auto& hand = hidden.get_hand();
+    auto& library = hidden.get_library();
+    size_t hand_size = hand.size();
+    library.insert(library.end(), hand.begin(), hand.end());
+    hand.clear();
+    gen.shuffle(library.begin(), library.end());
+    hand.assign(library.end() - hand_size, library.end());
+    library.resize(library.size() - hand_size);
+    hidden.rehash_zones();
+}
+
+/**
+* make a copy ready to be played out: determinize the cards the searching player can't see and let random agents continue
+* @param playout_worker worker of the thread
+* @param me the searching player in the copy
+* @param opponent the other player in the copy
+* @param seed seed of the playout
+**/
+static void prepare(mcts_worker& playout_worker, player& me, player& opponent, std::uint64_t seed) {
+    playout_worker.rng.seed(seed);
+    playout_worker.me.reseed(mix_seed(seed, 1));
+    playout_worker.opponent.reseed(mix_seed(seed, 2));
+    playout_worker.me.attackers.reset();
+    playout_worker.me.blockers.reset();
+    deal_hidden_cards(opponent, playout_worker.rng);
+    me.shuffle(playout_worker.rng);
+    me.set_agent(playout_worker.me);
+    opponent.set_agent(playout_worker.opponent);
+}
+
+/**
+* play a copy until it ends or reaches the turn limit and score it for the searching player
+* @param copy the copy
+* @param me the searching player in the copy
+* @param opponent the other player in the copy
+* @param max_turns turn limit
+*
+* @returns 1 for a win, 0 for a loss, 0.5 for a draw, between 0.25 and 0.75 by the life totals at the limit
+**/
+static double play_out(game& copy, player& me, player& opponent, size_t max_turns) {
+    while (!copy.is_ended() && copy.get_turn_number() < max_turns) {
+        copy.turn();
+    }
+    bool alive = me.get_life() > 0;
+    bool opponent_alive = opponent.get_life() > 0;
+    if (alive != opponent_alive) return alive ? 1.0 : 0.0;
+    if (!alive) return 0.5;
+    return 0.5 + std::clamp(me.get_life() - opponent.get_life(), -STARTING_LIFE, STARTING_LIFE) / (4.0 * STARTING_LIFE);
+}
+
+mcts_agent::mcts_agent(const mcts_settings& settings) : random_agent(settings.seed), settings(settings) {
+    if (this->settings.playouts == 0 && this->settings.seconds <= 0) {
+        this->settings.playouts = mcts_settings().playouts;
+    }
+    if (this->settings.n_of_threads > 1) {
+        pool = std::make_unique<thread_pool>(this->settings.n_of_threads);
+    }
+}
+
+mcts_agent::~mcts_agent() = default;
+
+void mcts_agent::search(const std::function<void(mcts_worker& playout_worker, std::uint64_t seed)>& run) {
+    auto start = std::chrono::steady_clock::now();
+    std::uint64_t decision_seed = mix_seed(settings.seed, stats.decisions);
+    std::atomic<size_t> started{0};
+    std::atomic<size_t> finished{0};
+
+    auto loop = [&]() {
+        mcts_worker& playout_worker = local_worker();
+        // the log is per thread, the copies must not print into the log of the real game
+        std::ostream* previous_log = game_log_stream();
+        set_game_log(nullptr);
+        while (true) {
+            size_t index = started.fetch_add(1);
+            if (settings.playouts > 0 && index >= settings.playouts) break;
+            if (settings.seconds > 0 && std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() >= settings.seconds) break;
+            run(playout_worker, mix_seed(decision_seed, index));
+            finished++;
+        }
+        set_game_log(previous_log);
+    };
+
+    if (pool) {
+        for (size_t i = 0; i < pool->size(); i++) {
+            pool->submit(loop);
+        }
+        pool->wait();
+    } else {
+        loop();
+    }
+
+    stats.decisions++;
+    stats.playouts += finished;
+    stats.seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+double mcts_agent::uct(const node& child, double parent_visits) const {
+    // a virtual loss counts as a played game that scored nothing
+    double n = child.visits + child.virtual_loss;
+    if (n == 0) return std::numeric_limits<double>::infinity();
+    double mean = child.score / n;
+    // other paths to the same position know more about it, the exploration still follows the visits of the path
+    transposition_table::stats shared;
+    if (child.position != 0 && transpositions.find(child.position, shared) && shared.visits > child.visits) {
+        mean = shared.score / (shared.visits + child.virtual_loss);
+    }
+    return mean + settings.exploration * std::sqrt(std::log(std::max(parent_visits, 1.0)) / n);
+}
+
+size_t mcts_agent::choose_option(size_t n_of_options, const playout& run) {
+    if (n_of_options <= 1) return 0;
+    tree.assign(n_of_options + 1, node());
+    for (size_t i = 0; i < n_of_options; i++) {
+        tree[0].children.push_back(static_cast<std::uint32_t>(i + 1));
+    }
+
+    search([&](mcts_worker& playout_worker, std::uint64_t seed) {
+        size_t option = 0;
+        {
+            std::lock_guard<std::mutex> lock(tree_lock);
+            double parent_visits = 0;
+            for (size_t i = 1; i <= n_of_options; i++) {
+                parent_visits += tree[i].visits + tree[i].virtual_loss;
+            }
+            double best = -1;
+            for (size_t i = 1; i <= n_of_options; i++) {
+                double value = uct(tree[i], parent_visits);
+                if (value > best) {
+                    best = value;
+                    option = i - 1;
+                }
+            }
+            tree[option + 1].virtual_loss++;
+        }
+        double result = run(playout_worker, option, seed);
+        std::lock_guard<std::mutex> lock(tree_lock);
+        node& arm = tree[option + 1];
+        arm.visits++;
+        arm.score += result;
+        arm.virtual_loss--;
+    });
+
+    size_t best = 0;
+    for (size_t i = 1; i < n_of_options; i++) {
+        if (tree[i + 1].visits > tree[best + 1].visits) best = i;
+    }
+    return best;
+}
+
+mcts_agent::move_key mcts_agent::key_of(const move& m, player& me) {
+    move_key key;
+    key.type = m.type;
+    switch (m.type) {
+        case MoveType::PLAY_LAND:
+            key.card = me.get_hand()[m.index];
+            break;
+        case MoveType::CAST_SPELL:
+            key.card = me.get_hand()[m.index];
+            key.target = m.target;
+            key.target_index = m.target_index;
+            break;
+        case MoveType::TAP_LAND:
+            key.card = me.get_battlefield().get_id(m.index);
+            key.mana_color = m.mana_color;
+            break;
+        default:
+            break;
+    }
+    return key;
+}
+
+std::uint64_t mcts_agent::position_of(const player& me, const player& opponent) {
+    return zobrist_key(zobrist_part::ACTIVE, me.private_hash()) + zobrist_key(zobrist_part::NON_ACTIVE, opponent.public_hash());
+}
+
+std::uint32_t mcts_agent::select(std::uint32_t parent, const std::pmr::vector<move>& legal_moves, player& me, size_t& chosen) {
+    // a move that was never played from here is played first
+    double parent_visits = 0;
+    for (size_t i = 0; i < legal_moves.size(); i++) {
+        move_key key = key_of(legal_moves[i], me);
+        std::uint32_t found = 0;
+        for (auto&& child : tree[parent].children) {
+            if (tree[child].key == key) {
+                found = child;
+                break;
+            }
+        }
+        if (found == 0) {
+            std::uint32_t child = static_cast<std::uint32_t>(tree.size());
+            tree.emplace_back();
+            tree[child].key = key;
+            tree[child].virtual_loss++;
+            tree[parent].children.push_back(child);
+            chosen = i;
+            return child;
+        }
+        parent_visits += tree[found].visits + tree[found].virtual_loss;
+    }
+
+    // the copy may not have every move of the node, only the children that are legal in it compete
+    std::uint32_t best_child = 0;
+    double best = -1;
+    for (size_t i = 0; i < legal_moves.size(); i++) {
+        move_key key = key_of(legal_moves[i], me);
+        for (auto&& child : tree[parent].children) {
+            if (tree[child].key == key) {
+                double value = uct(tree[child], parent_visits);
+                if (value > best) {
+                    best = value;
+                    best_child = child;
+                    chosen = i;
+                }
+                break;
+            }
+        }
+    }
+    tree[best_child].virtual_loss++;
+    return best_child;
+}
+
+void mcts_agent::main_phase_playout(mcts_worker& playout_worker, player& me, player& opponent, std::uint64_t seed) {
+    double result;
+    {
+        game copy(me, opponent, playout_worker.arena.get_resource(), seed);
+        player& my_copy = *copy.get_active_player();
+        player& opponent_copy = *copy.get_non_active_player();
+        prepare(playout_worker, my_copy, opponent_copy, seed);
+
+        playout_worker.path.assign(1, 0);
+        playout_worker.positions.assign(1, 0);
+        std::uint32_t current = 0;
+        bool passed = false;
+        {
+            std::lock_guard<std::mutex> lock(tree_lock);
+            tree[0].virtual_loss++;
+        }
+        // down the tree until a new node is added or the main phase ends
+        while (true) {
+            const auto& legal_moves = playout_worker.moves.spells(my_copy, opponent_copy);
+            size_t chosen = 0;
+            bool expanded;
+            {
+                std::lock_guard<std::mutex> lock(tree_lock);
+                size_t tree_size = tree.size();
+                current = select(current, legal_moves, my_copy, chosen);
+                expanded = tree.size() != tree_size;
+            }
+            playout_worker.path.push_back(current);
+            passed = legal_moves[chosen].type == MoveType::PASS;
+            if (legal_moves[chosen].type == MoveType::CAST_SPELL) {
+                const spell& chosen_spell = static_cast<const spell&>(card_definition(my_copy.get_hand()[legal_moves[chosen].index]));
+                move_generator::taps_for(my_copy, chosen_spell.get_mana_cost(), playout_worker.taps);
+                for (auto&& tap : playout_worker.taps) {
+                    copy.step(tap);
+                }
+            }
+            copy.step(legal_moves[chosen]);
+            // the targets and discards of the effects of the spell
+            while (copy.is_resolving()) copy.step();
+            playout_worker.positions.push_back(position_of(my_copy, opponent_copy));
+            if (passed || expanded || my_copy.get_life() <= 0 || opponent_copy.get_life() <= 0) break;
+        }
+
+        copy.finish_turn();
+        result = play_out(copy, my_copy, opponent_copy, settings.max_turns);
+    }
+    playout_worker.arena.reset();
+
+    std::lock_guard<std::mutex> lock(tree_lock);
+    for (size_t i = 0; i < playout_worker.path.size(); i++) {
+        node& visited = tree[playout_worker.path[i]];
+        visited.visits++;
+        visited.score += result;
+        visited.virtual_loss--;
+        if (i > 0) {
+            if (visited.position == 0) visited.position = playout_worker.positions[i];
+            transpositions.add(playout_worker.positions[i], result);
+        }
+    }
+}
+
+size_t mcts_agent::choose_move(player& me, player& opponent, const std::pmr::vector<move>& legal_moves) {
+    if (legal_moves.size() <= 1) return 0;
+
+    if (!planned_cast) {
+        tree.assign(1, node());
+        transpositions.clear();
+        search([&](mcts_worker& playout_worker, std::uint64_t seed) {
+            main_phase_playout(playout_worker, me, opponent, seed);
+        });
+
+        move_key best;
+        std::uint32_t best_visits = 0;
+        for (auto&& option : generator.spells(me, opponent)) {
+            move_key key = key_of(option, me);
+            for (auto&& child : tree[0].children) {
+                if (tree[child].key == key) {
+                    if (tree[child].visits > best_visits) {
+                        best_visits = tree[child].visits;
+                        best = key;
+                    }
+                    break;
+                }
+            }
+        }
+        if (best.type != MoveType::CAST_SPELL) {
+            return find_move(best, legal_moves, me);
+        }
+        planned_cast = best;
+    }
+
+    // the searched moves are whole spells, the lands a spell needs are tapped one move at a time before it is cast
+    size_t cast = find_move(*planned_cast, legal_moves, me);
+    if (cast != NO_MOVE) {
+        planned_cast.reset();
+        return cast;
+    }
+    auto& hand = me.get_hand();
+    auto in_hand = std::find(hand.begin(), hand.end(), planned_cast->card);
+    if (in_hand != hand.end()) {
+        generator.taps_for(me, static_cast<const spell&>(card_definition(*in_hand)).get_mana_cost(), taps);
+        if (!taps.empty()) {
+            size_t tap = find_move(key_of(taps.front(), me), legal_moves, me);
+            if (tap != NO_MOVE) return tap;
+        }
+    }
+    planned_cast.reset();
+    return random_agent::choose_move(me, opponent, legal_moves);
+}
+
+size_t mcts_agent::find_move(const move_key& key, const std::pmr::vector<move>& legal_moves, player& me) {
+    for (size_t i = 0; i < legal_moves.size(); i++) {
+        if (key_of(legal_moves[i], me) == key) return i;
+    }
+    return NO_MOVE;
+}
+
+bool mcts_agent::choose_mulligan(player& me) {
+    size_t hand_size = me.get_hand().size();
+    if (hand_size <= 1) return false;
+
+    // the deck of the opponent is not known before the game, the hand is played against a copy of the player's own deck
+    return choose_option(2, [&](mcts_worker& playout_worker, size_t option, std::uint64_t seed) {
+        double result;
+        {
+            game copy(me, me, playout_worker.arena.get_resource(), seed);
+            bool on_the_play = (mix_seed(seed, 3) & 1) == 0;
+            player& my_copy = on_the_play ? *copy.get_active_player() : *copy.get_non_active_player();
+            player& opponent_copy = on_the_play ? *copy.get_non_active_player() : *copy.get_active_player();
+            prepare(playout_worker, my_copy, opponent_copy, seed);
+            if (option == 1) {
+                my_copy.mulligan(hand_size - 1, playout_worker.rng);
+            }
+            result = play_out(copy, my_copy, opponent_copy, settings.max_turns);
+        }
+        playout_worker.arena.reset();
+        return result;
+    }) == 1;
+}
+
+std::vector<size_t> mcts_agent::choose_attackers(player& me, player& opponent) {
+    std::vector<size_t> eligible;
+    for (auto&& attack : generator.attacks(me, eligible)) {
+        if (attack.type == MoveType::ATTACK) eligible.push_back(attack.index);
+    }
+    if (eligible.empty()) return eligible;
+
+    // every subset of the attackers if there are few, otherwise no attack, all in and every creature alone
+    std::vector<std::vector<size_t>> options;
+    if ((size_t{1} << std::min(eligible.size(), size_t{16})) <= MAX_ENUMERATED_OPTIONS) {
+        for (size_t subset = 0; subset < (size_t{1} << eligible.size()); subset++) {
+            std::vector<size_t>& option = options.emplace_back();
+            for (size_t i = 0; i < eligible.size(); i++) {
+                if (subset & (size_t{1} << i)) option.push_back(eligible[i]);
+            }
+        }
+    } else {
+        options.emplace_back();
+        options.push_back(eligible);
+        for (auto&& attacker : eligible) {
+            options.push_back({attacker});
+        }
+    }
+
+    size_t chosen = choose_option(options.size(), [&](mcts_worker& playout_worker, size_t option, std::uint64_t seed) {
+        double result;
+        {
+            game copy(me, opponent, playout_worker.arena.get_resource(), seed);
+            player& my_copy = *copy.get_active_player();
+            player& opponent_copy = *copy.get_non_active_player();
+            prepare(playout_worker, my_copy, opponent_copy, seed);
+            playout_worker.me.attackers = options[option];
+            copy.step(move::pass());
+            copy.finish_turn();
+            result = play_out(copy, my_copy, opponent_copy, settings.max_turns);
+        }
+        playout_worker.arena.reset();
+        return result;
+    });
+    return options[chosen];
+}
+
+std::map<size_t, std::vector<size_t>> mcts_agent::choose_blockers(player& me, player& opponent, const std::vector<size_t>& attackers) {
+    std::vector<size_t> untapped;
+    battlefield_zone& battlefield = me.get_battlefield();
+    for (size_t i = 0; i < battlefield.size(); i++) {
+        if (battlefield.get_type(i) == CardType::CREATURE && !battlefield.is_tapped(i)) {
+            untapped.push_back(i);
+        }
+    }
+    if (untapped.empty() || attackers.empty()) return {};
+
+    // every assignment of blockers to attackers (or to none) if there are few, otherwise no block and every single block
+    std::vector<std::map<size_t, std::vector<size_t>>> options;
+    size_t n_of_assignments = 1;
+    for (size_t i = 0; i < untapped.size() && n_of_assignments <= MAX_ENUMERATED_OPTIONS; i++) {
+        n_of_assignments *= attackers.size() + 1;
+    }
+    if (n_of_assignments <= MAX_ENUMERATED_OPTIONS) {
+        for (size_t assignment = 0; assignment < n_of_assignments; assignment++) {
+            auto& option = options.emplace_back();
+            size_t rest = assignment;
+            for (auto&& blocker : untapped) {
+                size_t target = rest % (attackers.size() + 1);
+                rest /= attackers.size() + 1;
+                if (target > 0) option[attackers[target - 1]].push_back(blocker);
+            }
+        }
+    } else {
+        options.emplace_back();
+        for (auto&& blocker : untapped) {
+            for (auto&& attacker : attackers) {
+                options.emplace_back()[attacker].push_back(blocker);
+            }
+        }
+        // the blocks the combat solver values most, often ones with several blockers the list above leaves out
+        auto solved = solver.best_blocks(me, opponent, attackers);
+        if (std::find(options.begin(), options.end(), solved) == options.end()) {
+            options.push_back(std::move(solved));
+        }
+    }
+
+    size_t chosen = choose_option(options.size(), [&](mcts_worker& playout_worker, size_t option, std::uint64_t seed) {
+        double result;
+        {
+            game copy(opponent, me, playout_worker.arena.get_resource(), seed);
+            player& my_copy = *copy.get_non_active_player();
+            player& opponent_copy = *copy.get_active_player();
+            prepare(playout_worker, my_copy, opponent_copy, seed);
+            playout_worker.me.blockers = options[option];
+            copy.finish_turn_after_attackers(attackers);
+            result = play_out(copy, my_copy, opponent_copy, settings.max_turns);
+        }
+        playout_worker.arena.reset();
+        return result;
+    });
+    return options[chosen];
+}
+
+std::vector<size_t> mcts_agent::choose_order_of_blockers(player& me, player& opponent, size_t attacker, const std::vector<size_t>& blockers) {
+    // the order only decides which blockers die and the rest of the combat can't be resumed from here,
+    // so the combat solver picks the order that kills the most
+    return combat_solver::best_order(me, opponent, attacker, blockers);
+}
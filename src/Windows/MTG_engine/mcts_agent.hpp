@@ -0,0 +1,183 @@
+#ifndef MTG_ENGINE_MCTS_AGENT_H
+#define MTG_ENGINE_MCTS_AGENT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+#include "agent.hpp"
+#include "card_catalog.hpp"
+#include "combat_solver.hpp"
+#include "thread_pool.hpp"
+#include "transposition_table.hpp"
+
+struct mcts_worker;
+
+struct mcts_settings
+{
+	size_t playouts = 1000;		// playouts per decision, 0 for no limit
+	double seconds = 0;			// time per decision, 0 for no limit (one of the limits has to be set)
+	size_t n_of_threads = 1;	// threads running playouts, more than one starts a pool owned by the agent
+	double exploration = 1.41;	// UCT exploration constant
+	size_t max_turns = 60;		// turns a playout lasts before it is scored by the life totals
+	std::uint64_t seed = 0;
+};
+
+struct mcts_stats
+{
+	size_t decisions = 0;
+	size_t playouts = 0;
+	double seconds = 0;
+
+	double playouts_per_second() const {
+		return seconds > 0 ? playouts / seconds : 0.0;
+	}
+};
+
+// Monte Carlo tree search agent
+// every decision is played out many times from copies of the game, the cards the agent can't see (the hand and library
+// of the opponent, the order of its own library) are dealt at random for every copy (determinization), the copies
+// continue with random agents and the option that wins most often is chosen
+// the main phase is searched as a tree of moves (UCT), attackers, blockers and the mulligan as a flat choice among
+// the options, threads share the tree and add a virtual loss to the path they play so they spread over it
+// the positions of the main phase also go into a transposition table, so spells cast in a different order share
+// their results: a child is valued by all playouts through its position, not only by the ones through its path
+// the order of blockers comes from the combat solver
+// targets and discards are left to the random agent it derives from
+class mcts_agent : public random_agent
+{
+public:
+	/**
+	* mcts agent constructor
+	* @param settings budget and parameters of the search
+	**/
+	explicit mcts_agent(const mcts_settings& settings = mcts_settings());
+	~mcts_agent() override;
+
+	size_t choose_move(player& me, player& opponent, const std::pmr::vector<move>& legal_moves) override;
+	bool choose_mulligan(player& me) override;
+	std::vector<size_t> choose_attackers(player& me, player& opponent) override;
+	std::map<size_t, std::vector<size_t>> choose_blockers(player& me, player& opponent, const std::vector<size_t>& attackers) override;
+	std::vector<size_t> choose_order_of_blockers(player& me, player& opponent, size_t attacker, const std::vector<size_t>& blockers) override;
+
+	/**
+	* get the playouts and time spent so far
+	*
+	* @returns stats
+	**/
+	const mcts_stats& get_stats() const {
+		return stats;
+	}
+
+	/**
+	* get the settings of the search
+	*
+	* @returns settings
+	**/
+	const mcts_settings& get_settings() const {
+		return settings;
+	}
+
+private:
+	// what a move does independently of where the cards are, so the same move matches in every copy of the game
+	struct move_key {
+		MoveType type = MoveType::PASS;
+		MoveTarget target = MoveTarget::NONE;
+		color mana_color = color::W;
+		card_id card = 0;
+		std::uint16_t target_index = 0;
+
+		bool operator==(const move_key&) const = default;
+	};
+
+	struct node {
+		move_key key;
+		std::uint32_t visits = 0;
+		std::uint32_t virtual_loss = 0;
+		double score = 0;
+		std::uint64_t position = 0;	// what the searching player knows after the move, 0 until the first result
+		std::vector<std::uint32_t> children;
+	};
+
+	using playout = std::function<double(mcts_worker& playout_worker, size_t option, std::uint64_t seed)>;
+
+	mcts_settings settings;
+	mcts_stats stats;
+	std::unique_ptr<thread_pool> pool;
+
+	move_generator generator;
+	combat_solver solver;
+	std::pmr::vector<move> taps;
+
+	// the spell the main phase search chose, its lands are tapped first
+	std::optional<move_key> planned_cast;
+
+	// the tree of the current decision, options of a flat choice are the children of the root
+	std::mutex tree_lock;
+	std::vector<node> tree;
+	transposition_table transpositions;
+
+	/**
+	* run playouts until the budget of the decision is used up, on every thread of the pool
+	* @param run one playout, gets the thread's worker and the seed of the playout
+	**/
+	void search(const std::function<void(mcts_worker& playout_worker, std::uint64_t seed)>& run);
+
+	/**
+	* choose among options by playing each of them out, the most played one wins (UCB1 over the options)
+	* @param n_of_options number of options
+	* @param run plays one option out and scores it
+	*
+	* @returns index of the option
+	**/
+	size_t choose_option(size_t n_of_options, const playout& run);
+
+	/**
+	* play a copy of the main phase down the tree and out, and add the result to the tree
+	* the tree is searched at the level of spells (see move_generator::spells), a cast taps its lands first
+	**/
+	void main_phase_playout(mcts_worker& playout_worker, player& me, player& opponent, std::uint64_t seed);
+
+	/**
+	* choose the child of a node to play next, among the legal moves of the copy
+	* @param parent the node
+	* @param legal_moves legal moves of the copy
+	* @param me the player of the copy
+	* @param chosen index of the move into legal_moves
+	*
+	* @returns the child, a new one if some legal move was not played from the node yet
+	**/
+	std::uint32_t select(std::uint32_t parent, const std::pmr::vector<move>& legal_moves, player& me, size_t& chosen);
+
+	/**
+	* get the UCT value of a child
+	* @param child the child
+	* @param parent_visits sum of the visits of the children that are legal in the copy
+	*
+	* @returns the value
+	**/
+	double uct(const node& child, double parent_visits) const;
+
+	static move_key key_of(const move& m, player& me);
+
+	/**
+	* get the hash of a position as the searching player knows it: its own cards and what it sees of the opponent
+	* (see player::private_hash and player::public_hash), the same in every determinization
+	*
+	* @returns hash
+	**/
+	static std::uint64_t position_of(const player& me, const player& opponent);
+
+	/**
+	* find the legal move that does the same as a key
+	*
+	* @returns index into legal_moves, NO_MOVE if none does
+	**/
+	static size_t find_move(const move_key& key, const std::pmr::vector<move>& legal_moves, player& me);
+};
+
+#endif //MTG_ENGINE_MCTS_AGENT_H
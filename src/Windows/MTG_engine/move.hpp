@@ -0,0 +1,91 @@
+#ifndef MTG_ENGINE_MOVE_H
+#define MTG_ENGINE_MOVE_H
+
+#include <cstddef>
+#include <cstdint>
+#include "color.hpp"
+
+enum class MoveType : std::uint8_t {
+	PASS,			// end the main phase, or finish declaring attackers/blockers
+	PLAY_LAND,		// index: land in the hand
+	TAP_LAND,		// index: land on the battlefield, mana_color: the color it adds
+	CAST_SPELL,		// index: spell in the hand, target/target_index: target of its effects
+	ATTACK,			// index: creature on the battlefield of the attacking player
+	BLOCK,			// index: creature on the battlefield of the blocking player, attacker: what it blocks
+	ORDER_BLOCKER	// index: the blocker that fights attacker next
+};
+
+// the target a spell is cast with, used for every effect of the spell that needs one
+enum class MoveTarget : std::uint8_t {
+	NONE,				// the spell needs no target or its effects can't share one, the agent is asked per effect
+	ME,
+	OPPONENT,
+	MY_CREATURE,		// target_index: creature on the battlefield of the player
+	OPPONENT_CREATURE	// target_index: creature on the battlefield of the opponent
+};
+
+// a legal action of a player, small enough to be generated into reused buffers (see move_generator)
+struct move
+{
+	MoveType type = MoveType::PASS;
+	MoveTarget target = MoveTarget::NONE;
+	color mana_color = color::W;
+	std::uint16_t index = 0;
+	std::uint16_t attacker = 0;
+	std::uint16_t target_index = 0;
+
+	static constexpr move pass() {
+		return move{};
+	}
+
+	static constexpr move play_land(size_t hand_index) {
+		move ret;
+		ret.type = MoveType::PLAY_LAND;
+		ret.index = static_cast<std::uint16_t>(hand_index);
+		return ret;
+	}
+
+	static constexpr move tap_land(size_t battlefield_index, color color_of_mana) {
+		move ret;
+		ret.type = MoveType::TAP_LAND;
+		ret.index = static_cast<std::uint16_t>(battlefield_index);
+		ret.mana_color = color_of_mana;
+		return ret;
+	}
+
+	static constexpr move cast(size_t hand_index, MoveTarget target = MoveTarget::NONE, size_t target_index = 0) {
+		move ret;
+		ret.type = MoveType::CAST_SPELL;
+		ret.index = static_cast<std::uint16_t>(hand_index);
+		ret.target = target;
+		ret.target_index = static_cast<std::uint16_t>(target_index);
+		return ret;
+	}
+
+	static constexpr move attack(size_t battlefield_index) {
+		move ret;
+		ret.type = MoveType::ATTACK;
+		ret.index = static_cast<std::uint16_t>(battlefield_index);
+		return ret;
+	}
+
+	static constexpr move block(size_t blocker, size_t attacker) {
+		move ret;
+		ret.type = MoveType::BLOCK;
+		ret.index = static_cast<std::uint16_t>(blocker);
+		ret.attacker = static_cast<std::uint16_t>(attacker);
+		return ret;
+	}
+
+	static constexpr move order_blocker(size_t attacker, size_t blocker) {
+		move ret;
+		ret.type = MoveType::ORDER_BLOCKER;
+		ret.index = static_cast<std::uint16_t>(blocker);
+		ret.attacker = static_cast<std::uint16_t>(attacker);
+		return ret;
+	}
+
+	constexpr bool operator==(const move&) const = default;
+};
+
+#endif //MTG_ENGINE_MOVE_H
@@ -0,0 +1,206 @@
+#include "move_generator.hpp"
+#include "player.hpp"
+
+/**
+* checks if an earlier card of the hand is the same card
+* @param hand the hand
+* @param hand_index index of the card
+*
+* @returns true if the card is a copy of an earlier one
+**/
+static bool is_repeated(const std::pmr::vector<card_id>& hand, size_t hand_index) {
+    return std::find(hand.begin(), hand.begin() + hand_index, hand[hand_index]) != hand.begin() + hand_index;
+}
+
+const std::pmr::vector<move>& move_generator::main_phase(player& me, player& opponent) {
+    moves.clear();
+    moves.push_back(move::pass());
+
+    auto& hand = me.get_hand();
+    for (size_t i = 0; i < hand.size(); i++) {
+        if (is_repeated(hand, i)) continue;
+        if (card_definition(hand[i]).get_type() == CardType::LAND) {
+            if (!me.has_played_land()) {
+                moves.push_back(move::play_land(i));
+            }
+        } else if (can_pay(me.get_mana_pool(), static_cast<const spell&>(card_definition(hand[i])).get_mana_cost())) {
+            add_casts(i, me, opponent);
+        }
+    }
+
+    battlefield_zone& battlefield = me.get_battlefield();
+    size_t first_tap = moves.size();
+    for (size_t i = 0; i < battlefield.size(); i++) {
+        if (battlefield.get_type(i) != CardType::LAND || battlefield.is_tapped(i)) continue;
+        // untapped copies of a land are the same move, there are few different lands so only those are compared
+        bool repeated = false;
+        for (size_t j = first_tap; j < moves.size(); j++) {
+            if (battlefield.get_id(moves[j].index) == battlefield.get_id(i)) {
+                repeated = true;
+                break;
+            }
+        }
+        if (repeated) continue;
+        color_set taps_for = static_cast<const land&>(battlefield.definition(i)).get_taps_for();
+        for (size_t c = 0; c < N_OF_COLORS; c++) {
+            if (taps_for.contains(static_cast<color>(c))) {
+                moves.push_back(move::tap_land(i, static_cast<color>(c)));
+            }
+        }
+    }
+    return moves;
+}
+
+const std::pmr::vector<move>& move_generator::spells(player& me, player& opponent) {
+    moves.clear();
+    moves.push_back(move::pass());
+
+    auto& hand = me.get_hand();
+    for (size_t i = 0; i < hand.size(); i++) {
+        if (is_repeated(hand, i)) continue;
+        if (card_definition(hand[i]).get_type() == CardType::LAND) {
+            if (!me.has_played_land()) {
+                moves.push_back(move::play_land(i));
+            }
+        } else if (taps_for(me, static_cast<const spell&>(card_definition(hand[i])).get_mana_cost(), taps)) {
+            add_casts(i, me, opponent);
+        }
+    }
+    return moves;
+}
+
+bool move_generator::taps_for(player& me, const mana_cost& cost, std::pmr::vector<move>& taps) {
+    taps.clear();
+    mana pool = me.get_mana_pool();
+    unsigned missing[N_OF_COLORS];
+    unsigned spare = 0;
+    for (size_t c = 0; c < N_OF_COLORS; c++) {
+        unsigned have = pool.get(static_cast<color>(c));
+        unsigned need = cost.colored.get(static_cast<color>(c));
+        missing[c] = need > have ? need - have : 0;
+        spare += have > need ? have - need : 0;
+    }
+    unsigned generic = cost.generic > spare ? cost.generic - spare : 0;
+
+    battlefield_zone& battlefield = me.get_battlefield();
+    auto is_free = [&](size_t i) {
+        if (battlefield.get_type(i) != CardType::LAND || battlefield.is_tapped(i)) return false;
+        for (auto&& tap : taps) {
+            if (tap.index == i) return false;
+        }
+        return true;
+    };
+    // lands of one color are used up first, lands of several colors can still pay for what is left
+    for (bool multicolor : {false, true}) {
+        for (size_t i = 0; i < battlefield.size(); i++) {
+            if (!is_free(i)) continue;
+            color_set colors = static_cast<const land&>(battlefield.definition(i)).get_taps_for();
+            if ((colors.size() > 1) != multicolor) continue;
+            for (size_t c = 0; c < N_OF_COLORS; c++) {
+                if (missing[c] > 0 && colors.contains(static_cast<color>(c))) {
+                    missing[c]--;
+                    taps.push_back(move::tap_land(i, static_cast<color>(c)));
+                    break;
+                }
+            }
+        }
+    }
+    for (size_t c = 0; c < N_OF_COLORS; c++) {
+        if (missing[c] > 0) return false;
+    }
+    for (size_t i = 0; i < battlefield.size() && generic > 0; i++) {
+        if (!is_free(i)) continue;
+        taps.push_back(move::tap_land(i, static_cast<const land&>(battlefield.definition(i)).get_taps_for().first()));
+        generic--;
+    }
+    return generic == 0;
+}
+
+void move_generator::add_casts(size_t hand_index, player& me, player& opponent) {
+    bool players = true;
+    bool creatures = true;
+    bool targeted = false;
+    for (auto&& eff : static_cast<const spell&>(card_definition(me.get_hand()[hand_index])).get_effects()) {
+        switch (eff->get_target()) {
+            case EffectTarget::NONE:
+                continue;
+            case EffectTarget::PLAYER:
+                creatures = false;
+                break;
+            case EffectTarget::CREATURE:
+                players = false;
+                break;
+            case EffectTarget::ANY:
+                break;
+        }
+        targeted = true;
+    }
+
+    if (!targeted || (!players && !creatures)) {
+        // nothing to target, or the effects can't share a target and ask for theirs one by one
+        moves.push_back(move::cast(hand_index));
+        return;
+    }
+    if (players) {
+        moves.push_back(move::cast(hand_index, MoveTarget::ME));
+        moves.push_back(move::cast(hand_index, MoveTarget::OPPONENT));
+    }
+    if (creatures) {
+        for (size_t i = 0; i < me.get_battlefield().size(); i++) {
+            if (me.get_battlefield().get_type(i) == CardType::CREATURE) {
+                moves.push_back(move::cast(hand_index, MoveTarget::MY_CREATURE, i));
+            }
+        }
+        for (size_t i = 0; i < opponent.get_battlefield().size(); i++) {
+            if (opponent.get_battlefield().get_type(i) == CardType::CREATURE) {
+                moves.push_back(move::cast(hand_index, MoveTarget::OPPONENT_CREATURE, i));
+            }
+        }
+    }
+}
+
+const std::pmr::vector<move>& move_generator::attacks(player& me, const std::vector<size_t>& declared) {
+    moves.clear();
+    moves.push_back(move::pass());
+
+    battlefield_zone& battlefield = me.get_battlefield();
+    for (size_t i = 0; i < battlefield.size(); i++) {
+        if (battlefield.get_type(i) == CardType::CREATURE && !battlefield.is_tapped(i) && !battlefield.has_summoning_sickness(i)
+            && std::find(declared.begin(), declared.end(), i) == declared.end()) {
+            moves.push_back(move::attack(i));
+        }
+    }
+    return moves;
+}
+
+const std::pmr::vector<move>& move_generator::blocks(player& me, const std::vector<size_t>& attackers, const std::map<size_t, std::vector<size_t>>& declared) {
+    moves.clear();
+    moves.push_back(move::pass());
+
+    battlefield_zone& battlefield = me.get_battlefield();
+    for (size_t i = 0; i < battlefield.size(); i++) {
+        if (battlefield.get_type(i) != CardType::CREATURE || battlefield.is_tapped(i)) continue;
+        bool blocking = false;
+        for (auto&& [_, blockers] : declared) {
+            if (std::find(blockers.begin(), blockers.end(), i) != blockers.end()) {
+                blocking = true;
+                break;
+            }
+        }
+        if (blocking) continue;
+        for (auto&& attacker : attackers) {
+            moves.push_back(move::block(i, attacker));
+        }
+    }
+    return moves;
+}
+
+const std::pmr::vector<move>& move_generator::blocker_orders(size_t attacker, const std::vector<size_t>& blockers, const std::vector<size_t>& ordered) {
+    moves.clear();
+    for (auto&& blocker : blockers) {
+        if (std::find(ordered.begin(), ordered.end(), blocker) == ordered.end()) {
+            moves.push_back(move::order_blocker(attacker, blocker));
+        }
+    }
+    return moves;
+}
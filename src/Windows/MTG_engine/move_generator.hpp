@@ -0,0 +1,103 @@
+#ifndef MTG_ENGINE_MOVE_GENERATOR_H
+#define MTG_ENGINE_MOVE_GENERATOR_H
+
+#include <cstddef>
+#include <map>
+#include <memory_resource>
+#include <vector>
+#include "move.hpp"
+#include "mana.hpp"
+
+class player;
+
+// lists the legal moves of a player at a decision point
+// the moves are written into one buffer that is reused by every call, so a generator that is kept around
+// stops allocating once the buffer is big enough; the returned list is valid until the next call
+class move_generator
+{
+public:
+	/**
+	* move generator constructor
+	* @param resource memory resource of the buffer
+	**/
+	explicit move_generator(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) : moves(resource), taps(resource) {}
+
+	/**
+	* list the moves of the main phase: play a land (if none was played this turn), tap an untapped land for each
+	* of its colors, cast a spell the mana pool can pay for with each target its effects can share, and pass
+	* copies of the same card only get moves for the first copy
+	* @param me the active player
+	* @param opponent the other player
+	*
+	* @returns moves, PASS is always the first one
+	**/
+	const std::pmr::vector<move>& main_phase(player& me, player& opponent);
+
+	/**
+	* list the main phase moves at the level of spells, for searches: play a land, cast a spell the mana pool and
+	* the untapped lands can pay for together (with the targets of main_phase) and pass
+	* the lands a cast needs are found with taps_for and tapped before it
+	* @param me the active player
+	* @param opponent the other player
+	*
+	* @returns moves, PASS is always the first one
+	**/
+	const std::pmr::vector<move>& spells(player& me, player& opponent);
+
+	/**
+	* list the lands to tap so the mana pool pays for a cost: a land of the color for every colored mana the pool lacks,
+	* lands of one color before lands of several, then any untapped lands for the generic part
+	* @param me the player
+	* @param cost the cost
+	* @param taps TAP_LAND moves, replaced
+	*
+	* @returns false if the untapped lands can't pay for the cost
+	**/
+	static bool taps_for(player& me, const mana_cost& cost, std::pmr::vector<move>& taps);
+
+	/**
+	* list the creatures that can still be declared as attackers: untapped creatures without summoning sickness
+	* @param me the attacking player
+	* @param declared attackers declared so far
+	*
+	* @returns ATTACK moves and PASS to finish declaring, PASS is the first one
+	**/
+	const std::pmr::vector<move>& attacks(player& me, const std::vector<size_t>& declared);
+
+	/**
+	* list the blocks that can still be declared: every untapped creature that is not blocking yet can block any attacker
+	* @param me the blocking player
+	* @param attackers attackers, indices into the battlefield of the attacking player
+	* @param declared blocks declared so far
+	*
+	* @returns BLOCK moves and PASS to finish declaring, PASS is the first one
+	**/
+	const std::pmr::vector<move>& blocks(player& me, const std::vector<size_t>& attackers, const std::map<size_t, std::vector<size_t>>& declared);
+
+	/**
+	* list the blockers that can fight an attacker next
+	* @param attacker the attacker
+	* @param blockers its blockers
+	* @param ordered blockers already put in order
+	*
+	* @returns ORDER_BLOCKER moves, empty when every blocker is ordered
+	**/
+	const std::pmr::vector<move>& blocker_orders(size_t attacker, const std::vector<size_t>& blockers, const std::vector<size_t>& ordered);
+
+	/**
+	* get the moves of the last call
+	*
+	* @returns moves
+	**/
+	const std::pmr::vector<move>& get_moves() const {
+		return moves;
+	}
+
+private:
+	std::pmr::vector<move> moves;
+	std::pmr::vector<move> taps;
+
+	void add_casts(size_t hand_index, player& me, player& opponent);
+};
+
+#endif //MTG_ENGINE_MOVE_GENERATOR_H
@@ -0,0 +1,18 @@
+#ifndef MTG_ENGINE_PERMANENT_HANDLE_H
+#define MTG_ENGINE_PERMANENT_HANDLE_H
+
+#include <cstdint>
+
+/**
+* stable reference to a permanent on a battlefield_zone, stays valid while the permanent is on the battlefield
+* even when other permanents leave and the permanents are moved around
+**/
+struct permanent_handle
+{
+	std::uint32_t slot = UINT32_MAX;
+	std::uint32_t generation = 0;
+
+	bool operator==(const permanent_handle&) const = default;
+};
+
+#endif //MTG_ENGINE_PERMANENT_HANDLE_H
@@ -0,0 +1,110 @@
+# Profile-guided optimization of the engine, included by CMakeLists.txt after the targets are defined.
+#
+# MTG_PGO=ON builds an instrumented copy of the engine in ${CMAKE_BINARY_DIR}/pgo-instrumented, runs the workload below
+# with it, and compiles mtg_core, MTG_simulator and MTG_replay with the profile and link-time optimization.
+# The profile is made again when the instrumented executables change, and the targets are compiled again with it.
+# GCC and Clang only.
+#
+# The workload is seeded, so every run profiles the same games: self-play of random agents, recorded and replayed,
+# and a few games of MCTS agents.
+
+option (MTG_PGO "Build an instrumented engine, profile it on self-play games and optimize the engine with the profile" OFF)
+set (MTG_PGO_DIR "${CMAKE_BINARY_DIR}/pgo" CACHE PATH "Where the profiles of MTG_PGO are kept")
+# set by MTG_PGO for the instrumented build, GENERATE to instrument every target
+set (MTG_PGO_PHASE "" CACHE STRING "Internal, the part of MTG_PGO a build is")
+mark_as_advanced (MTG_PGO_PHASE)
+
+set (MTG_PGO_DECK "decks/red.ini")
+set (MTG_PGO_TRAINED mtg_core MTG_simulator MTG_replay)
+
+if (NOT MTG_PGO AND NOT MTG_PGO_PHASE)
+  return()
+endif()
+if (NOT CMAKE_CXX_COMPILER_ID MATCHES "GNU|Clang" OR CMAKE_CXX_COMPILER_ID STREQUAL "GNU" AND CMAKE_CXX_COMPILER_VERSION VERSION_LESS 11)
+  message (FATAL_ERROR "MTG_PGO needs GCC 11 or newer or Clang")
+endif()
+if (CMAKE_VERSION VERSION_LESS 3.13)
+  message (FATAL_ERROR "MTG_PGO needs CMake 3.13 or newer")
+endif()
+
+if (MTG_PGO_PHASE STREQUAL "GENERATE")
+  # counters are written when an instrumented executable exits, atomically as the search and the tournament use threads
+  if (CMAKE_CXX_COMPILER_ID STREQUAL "GNU")
+    set (MTG_PGO_GENERATE_FLAGS "-fprofile-generate=${MTG_PGO_DIR}" "-fprofile-prefix-path=${CMAKE_BINARY_DIR}" "-fprofile-update=prefer-atomic")
+  else()
+    set (MTG_PGO_GENERATE_FLAGS "-fprofile-generate=${MTG_PGO_DIR}")
+  endif()
+  foreach (target mtg_core ${MTG_EXECUTABLES})
+    target_compile_options (${target} PRIVATE ${MTG_PGO_GENERATE_FLAGS})
+    target_link_options (${target} PRIVATE ${MTG_PGO_GENERATE_FLAGS})
+  endforeach()
+  return()
+endif()
+
+if (CMAKE_CONFIGURATION_TYPES)
+  message (FATAL_ERROR "MTG_PGO needs a single-configuration generator (e.g. Unix Makefiles or Ninja)")
+endif()
+
+include (ExternalProject)
+
+set (MTG_PGO_BINARY_DIR "${CMAKE_BINARY_DIR}/pgo-instrumented")
+set (MTG_PGO_RAW_DIR "${MTG_PGO_DIR}/raw")
+set (MTG_PGO_SIMULATOR "${MTG_PGO_BINARY_DIR}/MTG_engine/MTG_simulator${CMAKE_EXECUTABLE_SUFFIX}")
+set (MTG_PGO_REPLAY "${MTG_PGO_BINARY_DIR}/MTG_engine/MTG_replay${CMAKE_EXECUTABLE_SUFFIX}")
+set (MTG_PGO_STAMP "${MTG_PGO_DIR}/profile.stamp")
+
+ExternalProject_Add (mtg_pgo_instrumented
+  SOURCE_DIR "${CMAKE_SOURCE_DIR}"
+  BINARY_DIR "${MTG_PGO_BINARY_DIR}"
+  CMAKE_ARGS
+    "-DCMAKE_BUILD_TYPE=${CMAKE_BUILD_TYPE}"
+    "-DCMAKE_CXX_COMPILER=${CMAKE_CXX_COMPILER}"
+    "-DCMAKE_CXX_FLAGS=${CMAKE_CXX_FLAGS}"
+    "-DMTG_PGO_PHASE=GENERATE"
+    "-DMTG_PGO_DIR=${MTG_PGO_RAW_DIR}"
+  BUILD_COMMAND "${CMAKE_COMMAND}" --build "${MTG_PGO_BINARY_DIR}" --target MTG_simulator
+    COMMAND "${CMAKE_COMMAND}" --build "${MTG_PGO_BINARY_DIR}" --target MTG_replay
+  BUILD_ALWAYS ON
+  BUILD_BYPRODUCTS "${MTG_PGO_SIMULATOR}" "${MTG_PGO_REPLAY}"
+  INSTALL_COMMAND "")
+
+# the workload, from the directory of the decks
+set (MTG_PGO_WORKLOAD
+  COMMAND "${MTG_PGO_SIMULATOR}" --seed 1 --record "${MTG_PGO_DIR}/workload.mtgr" "${MTG_PGO_DECK}" "${MTG_PGO_DECK}" 20000
+  COMMAND "${MTG_PGO_REPLAY}" "${MTG_PGO_DECK}" "${MTG_PGO_DECK}" "${MTG_PGO_DIR}/workload.mtgr"
+  COMMAND "${MTG_PGO_SIMULATOR}" --seed 3 --mcts 100 "${MTG_PGO_DECK}" "${MTG_PGO_DECK}" 10)
+
+if (CMAKE_CXX_COMPILER_ID STREQUAL "GNU")
+  # GCC names the counters of an object after its path, relative to the build directory they are both in
+  set (MTG_PGO_MERGE "")
+  set (MTG_PGO_USE_FLAGS "-fprofile-use=${MTG_PGO_RAW_DIR}" "-fprofile-prefix-path=${CMAKE_BINARY_DIR}" "-fprofile-partial-training" "-Wno-missing-profile")
+else()
+  get_filename_component (MTG_COMPILER_DIR "${CMAKE_CXX_COMPILER}" DIRECTORY)
+  find_program (MTG_LLVM_PROFDATA NAMES llvm-profdata HINTS "${MTG_COMPILER_DIR}")
+  if (NOT MTG_LLVM_PROFDATA)
+    message (FATAL_ERROR "MTG_PGO needs llvm-profdata with Clang")
+  endif()
+  set (MTG_PGO_PROFILE "${MTG_PGO_DIR}/mtg.profdata")
+  set (MTG_PGO_MERGE COMMAND "${MTG_LLVM_PROFDATA}" merge "-output=${MTG_PGO_PROFILE}" "${MTG_PGO_RAW_DIR}")
+  set (MTG_PGO_USE_FLAGS "-fprofile-use=${MTG_PGO_PROFILE}" "-Wno-profile-instr-unprofiled" "-Wno-profile-instr-out-of-date")
+endif()
+
+add_custom_command (OUTPUT "${MTG_PGO_STAMP}"
+  COMMAND "${CMAKE_COMMAND}" -E remove_directory "${MTG_PGO_RAW_DIR}"
+  COMMAND "${CMAKE_COMMAND}" -E make_directory "${MTG_PGO_DIR}"
+  ${MTG_PGO_WORKLOAD}
+  ${MTG_PGO_MERGE}
+  COMMAND "${CMAKE_COMMAND}" -E touch "${MTG_PGO_STAMP}"
+  DEPENDS mtg_pgo_instrumented "${MTG_PGO_SIMULATOR}" "${MTG_PGO_REPLAY}"
+  WORKING_DIRECTORY "${CMAKE_SOURCE_DIR}"
+  COMMENT "Profiling the engine on self-play games"
+  VERBATIM)
+add_custom_target (mtg_pgo_profile DEPENDS "${MTG_PGO_STAMP}")
+
+foreach (target ${MTG_PGO_TRAINED})
+  add_dependencies (${target} mtg_pgo_profile)
+  target_compile_options (${target} PRIVATE ${MTG_PGO_USE_FLAGS})
+  # a new profile compiles the target again
+  get_target_property (MTG_PGO_SOURCES ${target} SOURCES)
+  set_property (SOURCE ${MTG_PGO_SOURCES} APPEND PROPERTY OBJECT_DEPENDS "${MTG_PGO_STAMP}")
+endforeach()
@@ -0,0 +1,449 @@
+#include "player.hpp"
+
+#include <climits>
+
+std::string creature_ref::get_damagable_name() {
+    return controller.get_battlefield().get_name(get_index());
+}
+
+void creature_ref::deal_damage(int amount) {
+    controller.damage_creature(get_index(), amount);
+}
+
+std::string player::print_mana_pool() const {
+    std::string mana_pool_string = "";
+    for (size_t i = 0; i < N_OF_COLORS; i++) {
+        color color_of_mana = static_cast<color>(i);
+        if (mana_pool.get(color_of_mana) > 0) {
+            mana_pool_string += std::to_string(mana_pool.get(color_of_mana)) + " ";
+            mana_pool_string += color_to_string(color_of_mana);
+            mana_pool_string += " ";
+        }
+    }
+    return mana_pool_string;
+}
+
+void player::print_battlefield() {
+    if (!game_log_enabled()) return;
+    game_log() << "Battlefield of " << this->get_damagable_name() << ":\n";
+    for (size_t i = 0; i < battlefield.size(); i++) {
+        game_log() << battlefield.get_name(i) << " - " << card_type_to_string(battlefield.get_type(i)) << " - " << (battlefield.is_tapped(i) ? "tapped" : "untapped");
+        if (battlefield.get_type(i) == CardType::CREATURE) {
+            game_log() << "(" << (battlefield.has_summoning_sickness(i) ? "ss" : "nss" ) << ") - " << battlefield.get_power(i) << " - " << battlefield.get_health(i);
+        }
+        game_log() << "\n";
+    }
+    game_log() << "\n";
+}
+
+void player::print_graveyard() {
+    if (!game_log_enabled()) return;
+    game_log() << "Graveyard of " << this->get_damagable_name() << ":\n";
+    for (auto&& smt : graveyard) {
+        game_log() << card_definition(smt).get_name() << " - " << card_type_to_string(card_definition(smt).get_type()) << "\n";
+    }
+    game_log() << "\n";
+}
+
+void player::mulligan(const size_t n_of_cards, game_rng& gen) {
+    record(library);
+    record(hand);
+    for (size_t i = 0; i < this->hand.size(); i++) {
+        publish_move(hand[i], ZoneType::HAND, ZoneType::LIBRARY);
+        library.push_back(std::move(hand[i]));
+    }
+    hand.clear();
+    hand_hash = 0;
+    shuffle(gen);
+    draw_card(n_of_cards);
+}
+
+void player::discard(const size_t n_of_cards) {
+    record(hand);
+    record(graveyard);
+    if (n_of_cards > hand.size()) {
+        for (auto&& card : hand) {
+            graveyard_hash += zobrist_key(zobrist_part::GRAVEYARD, card);
+            publish_move(card, ZoneType::HAND, ZoneType::GRAVEYARD);
+            graveyard.push_back(std::move(card));
+        }
+        hand.clear();
+        hand_hash = 0;
+        return;
+    }
+    // the cards are chosen as decisions of the game (see game::step)
+    record_counters();
+    discards_left = n_of_cards;
+}
+
+bool player::discard_for_effect(size_t index) {
+    if (discards_left == 0 || !discard_card(index)) return false;
+    record_counters();
+    discards_left--;
+    return true;
+}
+
+void player::display_hand() {
+    if (!game_log_enabled()) return;
+    game_log() << this->get_damagable_name() << "\n";
+    for (auto&& id : hand) {
+        const card& definition = card_definition(id);
+        game_log() << definition.get_name() << " - " << card_type_to_string(definition.get_type());
+        if (definition.get_type() != CardType::LAND) {
+            game_log() << " - " << static_cast<const spell&>(definition).get_cost();
+        }
+        game_log() << "\n";
+    }
+    game_log() << "\n";
+}
+
+std::vector<size_t> player::select_order_of_blockers(size_t attacker, std::vector<size_t> blockers, player* opponent) {
+    bool correct_input = false;
+    std::vector<size_t> ret;
+    while (!correct_input) {
+        ret = decider->choose_order_of_blockers(*this, *opponent, attacker, blockers);
+        if (ret.size() == blockers.size() && std::is_permutation(ret.begin(), ret.end(), blockers.begin())) {
+            correct_input = true;
+        } else {
+            game_log() << "Incorrect input\n";
+        }
+    }
+    return ret;
+}
+
+bool player::play(player& opponent) {
+    const auto& moves = legal_moves.main_phase(*this, opponent);
+    size_t chosen = decider->choose_move(*this, opponent, moves);
+    if (chosen < moves.size()) {
+        return apply_move(moves[chosen], opponent);
+    }
+
+    std::string action = decider->choose_play(*this, opponent);
+    if (actions != nullptr) actions->add_command(action);
+    if (action == "concede") {
+        concede();
+        return true;
+    } else if (action == "pass") {
+        pass_turn();
+        return true;
+    } else if (action == "hand") {
+        display_hand();
+    } else if (action == "battlefield") {
+        print_battlefield();
+    } else if (action == "graveyard") {
+        print_graveyard();
+    } else {
+        return decode_play(action, opponent);
+    }
+    return false;
+}
+
+bool player::is_legal_move(const move& chosen, const player& opponent) const {
+    switch (chosen.type) {
+        case MoveType::PASS:
+            return true;
+        case MoveType::PLAY_LAND:
+            return chosen.index < hand.size() && card_definition(hand[chosen.index]).get_type() == CardType::LAND && !played_land;
+        case MoveType::TAP_LAND:
+            return chosen.index < battlefield.size() && battlefield.get_type(chosen.index) == CardType::LAND && !battlefield.is_tapped(chosen.index)
+                && static_cast<const land&>(battlefield.definition(chosen.index)).get_taps_for().contains(chosen.mana_color);
+        case MoveType::CAST_SPELL:
+            break;
+        default:
+            // attackers and blockers are declared through select_attackers and select_blockers
+            return false;
+    }
+
+    if (chosen.index >= hand.size() || card_definition(hand[chosen.index]).get_type() == CardType::LAND) return false;
+    const spell& cast = static_cast<const spell&>(card_definition(hand[chosen.index]));
+    if (!can_pay(mana_pool, cast.get_mana_cost())) return false;
+    if (chosen.target == MoveTarget::NONE) return true;
+
+    // the target is shared by every effect that needs one, the same as in move_generator::add_casts
+    bool players = true;
+    bool creatures = true;
+    bool targeted = false;
+    for (auto&& eff : cast.get_effects()) {
+        if (eff->get_target() == EffectTarget::NONE) continue;
+        players = players && eff->get_target() != EffectTarget::CREATURE;
+        creatures = creatures && eff->get_target() != EffectTarget::PLAYER;
+        targeted = true;
+    }
+    const battlefield_zone& targets = chosen.target == MoveTarget::MY_CREATURE ? battlefield : opponent.battlefield;
+    switch (chosen.target) {
+        case MoveTarget::ME:
+        case MoveTarget::OPPONENT:
+            return targeted && players;
+        case MoveTarget::MY_CREATURE:
+        case MoveTarget::OPPONENT_CREATURE:
+            return targeted && creatures && chosen.target_index < targets.size() && targets.get_type(chosen.target_index) == CardType::CREATURE;
+        default:
+            return false;
+    }
+}
+
+bool player::apply_move(move chosen, player& opponent) {
+    if (!is_legal_move(chosen, opponent)) {
+        game_log() << "you can't make that move\n";
+        return false;
+    }
+    if (actions != nullptr) actions->add_move(chosen);
+    switch (chosen.type) {
+        case MoveType::PASS:
+            pass_turn();
+            return true;
+        case MoveType::PLAY_LAND:
+        case MoveType::CAST_SPELL:
+            cast_from_hand(hand.begin() + chosen.index, opponent, chosen);
+            print_battlefield();
+            return false;
+        case MoveType::TAP_LAND:
+            tap_land(chosen.index, chosen.mana_color);
+            return false;
+        default:
+            return false;
+    }
+}
+
+void player::pass_turn() {
+    if (game_log_enabled()) game_log() << this->get_damagable_name() << " passed their current phase\n";
+}
+
+void player::concede() {
+    if (game_log_enabled()) game_log() << this->get_damagable_name() << " conceded\n";
+    deal_damage(INT_MAX);
+}
+
+bool player::decode_play(std::string& play, player& opponent) {
+    size_t offset_to_space = play.find(" ");
+    if (offset_to_space != std::string::npos) {
+        if (play.substr(0,offset_to_space) == "tap") {
+            card_id id;
+            std::optional<color> chosen = std::nullopt;
+            if (!find_land_to_tap(play.substr(offset_to_space+1), id, chosen)) {
+                return false;
+            }
+            for (size_t i = 0; i < battlefield.size(); i++) {
+                if (battlefield.get_id(i) == id && !battlefield.is_tapped(i) && battlefield.get_type(i) == CardType::LAND) {
+                    color_set taps_for = static_cast<const land&>(battlefield.definition(i)).get_taps_for();
+                    if (!chosen || taps_for.contains(*chosen)) {
+                        tap_land(i, chosen ? *chosen : taps_for.first());
+                    }
+                    break;
+                }
+            }
+        } else if (play.substr(0,offset_to_space) == "play" || play.substr(0,offset_to_space) == "cast") {
+            return cast_card(play.substr(offset_to_space + 1), opponent);
+        }
+    }
+    return false;
+}
+
+bool player::find_land_to_tap(std::string_view target, card_id& id, std::optional<color>& chosen) {
+    if (card_catalog::global().find(target, id)) {
+        return true;
+    }
+    color color_of_mana;
+    if (target.size() > 2 && target[target.size() - 2] == ' ' && try_char_to_color(target.back(), color_of_mana)
+        && card_catalog::global().find(target.substr(0, target.size() - 2), id)) {
+        chosen = color_of_mana;
+        return true;
+    }
+    return false;
+}
+
+void player::tap_land(size_t index, color color_of_mana) {
+    battlefield.set_tapped(index, true);
+    add_to_mana_pool(color_of_mana);
+    if (game_log_enabled()) game_log() << this->print_mana_pool() << "\n";
+}
+
+bool player::cast_card(const std::string& name, player& opponent) {
+    card_id id;
+    if (!card_catalog::global().find(name, id)) {
+        return false;
+    }
+    auto found = std::find(hand.begin(), hand.end(), id);
+    if (found != hand.end()) {
+        cast_from_hand(found, opponent, move::cast(found - hand.begin()));
+    }
+    print_battlefield();
+    return false;
+}
+
+void player::cast_from_hand(std::pmr::vector<card_id>::iterator found, player& opponent, const move& chosen) {
+    card_id id = *found;
+    const card& definition = card_definition(id);
+    if (definition.get_type() != CardType::LAND) {
+        if (!pay(static_cast<const spell&>(definition).get_mana_cost())) {
+            return;
+        }
+
+        // take the card out of the hand first, effects (e.g. draw) can change the hand,
+        // it gets to the battlefield or the graveyard once its effects resolved (see finish_spell)
+        remove_from_hand(found);
+        publish_card(GameEventType::SPELL_CAST, id);
+        do_effects(id, opponent, chosen);
+    }
+    else {
+        if (played_land) {
+            game_log() << "you can only play one land per turn\n";
+            return;
+        }
+
+        remove_from_hand(found);
+        battlefield.add(id);
+        record_counters();
+        played_land = true;
+        publish_card(GameEventType::LAND_PLAYED, id);
+        publish_move(id, ZoneType::HAND, ZoneType::BATTLEFIELD);
+    }
+}
+
+bool player::pay(const mana_cost& cost) {
+    if (can_pay(mana_pool, cost)) {
+        // for now, counting on the player to tap precisely how he needs and not more
+        empty_mana_pool();
+        return true;
+    } else {
+        game_log() << "You can't pay for that with your current mana pool\n";
+        return false;
+    }
+}
+
+void player::remove_from_hand(std::pmr::vector<card_id>::iterator found) {
+    record(hand);
+    hand_hash -= zobrist_key(zobrist_part::HAND, *found);
+    std::iter_swap(found, hand.end() - 1);
+    hand.pop_back();
+}
+
+void player::do_effects(card_id spell, player& opponent, const move& chosen) {
+    record_counters();
+    resolving = true;
+    resolving_spell = spell;
+    next_effect = 0;
+    resolving_target = chosen.target;
+    if (chosen.target == MoveTarget::MY_CREATURE) {
+        resolving_creature = battlefield.handle(chosen.target_index);
+    } else if (chosen.target == MoveTarget::OPPONENT_CREATURE) {
+        resolving_creature = opponent.battlefield.handle(chosen.target_index);
+    }
+    resume_effects(opponent);
+}
+
+void player::resume_effects(player& opponent) {
+    if (!resolving) return;
+    record_counters();
+    auto& effects = static_cast<const spell&>(card_definition(resolving_spell)).get_effects();
+    for (; next_effect < effects.size(); next_effect++) {
+        // the cards of a discard are chosen before the next effect
+        if (discards_left > 0 || opponent.discards_left > 0) return;
+        const effect& eff = *effects[next_effect];
+        if (eff.get_name() == "nothing") {
+            continue;
+        }
+        if (resolving_target == MoveTarget::NONE) {
+            // an effect on creatures does nothing without a creature to target
+            if (eff.get_target() == EffectTarget::CREATURE && !has_creature() && !opponent.has_creature()) {
+                continue;
+            }
+            // waits for the target (see target_effect)
+            return;
+        }
+        std::optional<creature_ref> chosen_creature;
+        damagable* chosen_target = move_target(opponent, chosen_creature);
+        // an earlier effect can take the creature off the battlefield
+        if (chosen_target != nullptr) {
+            eff.execute(*chosen_target);
+        }
+    }
+    if (discards_left > 0 || opponent.discards_left > 0) return;
+    resolving = false;
+    finish_spell();
+}
+
+void player::finish_spell() {
+    if (card_definition(resolving_spell).get_type() == CardType::CREATURE) {
+        battlefield.add(resolving_spell);
+        publish_move(resolving_spell, ZoneType::HAND, ZoneType::BATTLEFIELD);
+    }
+    else {
+        record(graveyard);
+        graveyard.push_back(resolving_spell);
+        graveyard_hash += zobrist_key(zobrist_part::GRAVEYARD, resolving_spell);
+        publish_move(resolving_spell, ZoneType::HAND, ZoneType::GRAVEYARD);
+    }
+}
+
+const effect* player::get_effect_to_target() const {
+    if (!resolving || resolving_target != MoveTarget::NONE || discards_left > 0) return nullptr;
+    auto& effects = static_cast<const spell&>(card_definition(resolving_spell)).get_effects();
+    return next_effect < effects.size() ? effects[next_effect].get() : nullptr;
+}
+
+bool player::target_effect(std::string target, player& opponent) {
+    const effect* eff = get_effect_to_target();
+    if (eff == nullptr || opponent.discards_left > 0) return false;
+    std::optional<creature_ref> creature_target;
+    damagable* target_ptr = parse_target(target, opponent, creature_target);
+    if (target_ptr == nullptr) return false;
+    // the effect casts its target to a player or a creature_ref (see effect.cpp)
+    if ((creature_target && eff->get_target() == EffectTarget::PLAYER) || (!creature_target && eff->get_target() == EffectTarget::CREATURE)) {
+        game_log() << eff->get_name() << " can't target that\n";
+        return false;
+    }
+    record_counters();
+    eff->execute(*target_ptr);
+    next_effect++;
+    resume_effects(opponent);
+    return true;
+}
+
+bool player::has_creature() const {
+    for (size_t i = 0; i < battlefield.size(); i++) {
+        if (battlefield.get_type(i) == CardType::CREATURE) return true;
+    }
+    return false;
+}
+
+damagable* player::move_target(player& opponent, std::optional<creature_ref>& creature_target) {
+    switch (resolving_target) {
+        case MoveTarget::ME:
+            return this;
+        case MoveTarget::OPPONENT:
+            return &opponent;
+        case MoveTarget::MY_CREATURE:
+            creature_target.emplace(*this, resolving_creature);
+            break;
+        case MoveTarget::OPPONENT_CREATURE:
+            creature_target.emplace(opponent, resolving_creature);
+            break;
+        default:
+            return nullptr;
+    }
+    return creature_target->is_valid() ? &*creature_target : nullptr;
+}
+
+damagable* player::parse_target(std::string& target, player& opponent, std::optional<creature_ref>& creature_target) {
+    if (target == "me" || target == this->name) {
+        return this;
+    } else if (target == "opp" || target == opponent.name) {
+        return &opponent;
+    } else {
+        std::string owner = target.substr(0, target.find("-"));
+        std::string name = target.substr(target.find("-") + 1);
+        card_id id;
+        if (!card_catalog::global().find(name, id)) {
+            return nullptr;
+        }
+        player& controller = (owner == "me") ? *this : opponent;
+        for (size_t i = 0; i < controller.battlefield.size(); i++) {
+            if (controller.battlefield.get_id(i) == id && controller.battlefield.get_type(i) == CardType::CREATURE) {
+                creature_target.emplace(controller, controller.battlefield.handle(i));
+                return &*creature_target;
+            }
+        }
+    }
+    return nullptr;
+}
@@ -4,17 +4,63 @@
 #include <string>
 #include <map>
 #include <vector>
-#include <iostream>
+#include <memory_resource>
 #include <memory>
-#include <random>
-#include <ranges>
-#include <sstream>
 #include <algorithm>
+#include <optional>
 
 #include "deck.hpp"
+#include "zone.hpp"
+#include "mana.hpp"
 #include "phase.hpp"
 #include "damagable.hpp"
+#include "agent.hpp"
+#include "move_generator.hpp"
+#include "undo_log.hpp"
+#include "action_log.hpp"
+#include "game_events.hpp"
+#include "game_log.hpp"
+#include "random.hpp"
+#include "zobrist.hpp"
+
+class player;
+
+// a creature on the battlefield of a player as the target of an effect
+class creature_ref : public damagable
+{
+public:
+    /**
+    * creature_ref constructor
+    * @param controller player whose battlefield the creature is on
+    * @param creature handle of the creature on that battlefield
+    **/
+    creature_ref(player& controller, permanent_handle creature) : controller(controller), creature(creature) {}
 
+    std::string get_damagable_name() override;
+    void deal_damage(int amount) override;
+
+    /**
+    * get the player whose battlefield the creature is on
+    * @returns the controller
+    **/
+    player& get_controller() { return controller; }
+
+    /**
+    * get the current index of the creature on the battlefield of its controller
+    * @returns index
+    **/
+    size_t get_index() const;
+
+    /**
+    * checks if the creature is still on the battlefield
+    * @returns true if it is
+    **/
+    bool is_valid() const;
+
+private:
+    player& controller;
+    permanent_handle creature;
+};
 
 class player : public damagable
 {
@@ -22,29 +68,52 @@ public:
     /**
     * player constructor
     * @param name name of the player
-    * @param my_deck deck of the player
+    * @param my_deck deck of the player, the zones of the player use the memory resource of the deck
+    * @param starting_life life the player starts with
+    * @param decider agent that makes the player's decisions, console if nullptr
     * @returns player
     **/
-	player(const std::string& name,deck&& my_deck, int starting_life) : name(name), library(std::move(my_deck.library)), life(starting_life) {
-        for (auto& card : library) {
-			card->set_owner(this);
-		}
+	player(const std::string& name,deck&& my_deck, int starting_life, agent* decider = nullptr) : name(name), life(starting_life), decider(decider != nullptr ? decider : &console_agent::instance()),
+        library(std::move(my_deck.library)), graveyard(library.get_allocator()), hand(library.get_allocator()), battlefield(library.get_allocator().resource()),
+        legal_moves(library.get_allocator().resource()) {
+        rehash_zones();
     }
 
-    // TODO: deletion causes leaks for some reason
-    ~player() {
-        for (auto& card : library) {
-            card.reset();
-        }
-        for (auto& card : graveyard) {
-			card.reset();
-		}
-		for (auto& card : hand) {
-			card.reset();
-		}
-		for (auto& card : battlefield) {
-			card.reset();
-		}
+    /**
+    * copy a player into another memory resource (e.g. to search from a copy of the game), the copy has no undo log or action log
+    * and publishes no events
+    * @param other the player to copy
+    * @param resource memory resource of the zones of the copy
+    **/
+    player(const player& other, std::pmr::memory_resource* resource) : name(other.name), life(other.life), played_land(other.played_land),
+        mana_pool(other.mana_pool), resolving(other.resolving), resolving_spell(other.resolving_spell), next_effect(other.next_effect),
+        resolving_target(other.resolving_target), resolving_creature(other.resolving_creature), discards_left(other.discards_left), decider(other.decider), library(other.library, resource), graveyard(other.graveyard, resource),
+        hand(other.hand, resource), battlefield(other.battlefield, resource), legal_moves(resource),
+        library_hash(other.library_hash), graveyard_hash(other.graveyard_hash), hand_hash(other.hand_hash) {}
+
+    /**
+    * set the undo log told about changes of the player (see game::set_undo_log)
+    * @param log the log, nullptr for none
+    **/
+    void set_undo_log(undo_log* log) {
+        journal = log;
+        battlefield.set_undo_log(log);
+    }
+
+    /**
+    * set the action log the decisions of the player are added to (see game::set_action_log)
+    * @param log the log, nullptr for none
+    **/
+    void set_action_log(action_log* log) {
+        actions = log;
+    }
+
+    /**
+    * set the game the events of the player belong to (see game::set_event_publishing)
+    * @param game_origin the game, nullptr to publish none
+    **/
+    void set_event_origin(const event_origin* game_origin) {
+        origin = game_origin;
     }
 
     /**
@@ -60,7 +129,31 @@ public:
     * @param amount amount of damage
     **/
     void deal_damage(int amount) override {
+        record_counters();
         life -= amount;
+        if (amount != 0 && publishes(EventLevel::TURN)) {
+            // healing is negative damage
+            game_event event(*origin, amount >= 0 ? GameEventType::DAMAGE : GameEventType::LIFE_GAINED, name);
+            event.amount = amount >= 0 ? amount : -amount;
+            event.total = life;
+            event_bus::publish(event);
+        }
+    }
+
+    /**
+    * deal damage to a creature on the battlefield of the player, it dies when its health drops to 0
+    * @param index index of the creature on the battlefield
+    * @param amount amount of damage
+    **/
+    void damage_creature(size_t index, int amount) {
+        battlefield.deal_damage(index, amount);
+        if (publishes(EventLevel::TURN)) {
+            game_event event(*origin, GameEventType::DAMAGE, name);
+            event.card = battlefield.get_id(index);
+            event.amount = amount;
+            event.total = battlefield.get_health(index);
+            event_bus::publish(event);
+        }
     }
 
     /**
@@ -76,14 +169,85 @@ public:
     * @param add amount of life
     **/
     void add_life(int add) {
+        record_counters();
         life += add;
     }
 
+    /**
+    * get the agent making the decisions of the player
+    * @returns agent
+    **/
+    agent& get_agent() {
+        return *decider;
+    }
+
+    /**
+    * set the agent making the decisions of the player
+    * @param new_decider agent
+    **/
+    void set_agent(agent& new_decider) {
+        decider = &new_decider;
+    }
+
+    /**
+    * get the zobrist hash of what the opponent sees of the player: the battlefield, the graveyard, life, mana pool,
+    * whether a land was played, how many cards are in the hand and the library and the spell whose effects resolve
+    * @returns hash
+    **/
+    std::uint64_t public_hash() const {
+        std::uint64_t ret = battlefield.hash() + graveyard_hash + zobrist_key(zobrist_part::LIFE, static_cast<std::uint64_t>(life))
+            + zobrist_key(zobrist_part::MANA_POOL, mana_pool.bits()) + zobrist_key(zobrist_part::HAND_SIZE, hand.size())
+            + zobrist_key(zobrist_part::LIBRARY_SIZE, library.size());
+        if (played_land) ret += zobrist_key(zobrist_part::PLAYED_LAND, 0);
+        if (resolving) {
+            ret += zobrist_key(zobrist_part::RESOLVING, resolving_spell, next_effect);
+            // the creature is only the target of spells cast at a creature, it is left from an earlier spell otherwise
+            bool at_creature = resolving_target == MoveTarget::MY_CREATURE || resolving_target == MoveTarget::OPPONENT_CREATURE;
+            ret += zobrist_key(zobrist_part::RESOLVING_TARGET, static_cast<std::uint64_t>(resolving_target),
+                at_creature ? (static_cast<std::uint64_t>(resolving_creature.slot) << 32) + resolving_creature.generation : 0);
+        }
+        if (discards_left > 0) ret += zobrist_key(zobrist_part::DISCARDS_LEFT, discards_left);
+        return ret;
+    }
+
+    /**
+    * get the zobrist hash of what the player sees of itself: public_hash and the cards in the hand
+    * @returns hash
+    **/
+    std::uint64_t private_hash() const {
+        return public_hash() + hand_hash;
+    }
+
+    /**
+    * get the zobrist hash of the whole player, with the order of the library
+    * @returns hash
+    **/
+    std::uint64_t hash() const {
+        return private_hash() + library_hash;
+    }
+
+    /**
+    * recompute the hashes of the hand, the library and the graveyard
+    * the zones update them on every change made through the player, this is for changes made directly to the zones
+    **/
+    void rehash_zones() {
+        record_counters();
+        hand_hash = 0;
+        for (auto&& id : hand) {
+            hand_hash += zobrist_key(zobrist_part::HAND, id);
+        }
+        graveyard_hash = 0;
+        for (auto&& id : graveyard) {
+            graveyard_hash += zobrist_key(zobrist_part::GRAVEYARD, id);
+        }
+        rehash_library();
+    }
+
     /**
     * get the library of the player
     * @returns library
     **/
-    std::vector<std::unique_ptr<card>>& get_library() { 
+    std::pmr::vector<card_id>& get_library() { 
         return library; 
     }
 
@@ -91,7 +255,7 @@ public:
     * get the graveyard of the player
     * @returns graveyard
     **/
-    std::vector<std::unique_ptr<card>>& get_graveyard() { 
+    std::pmr::vector<card_id>& get_graveyard() { 
         return graveyard; 
     }
 
@@ -99,7 +263,7 @@ public:
     * get the hand of the player
     * @returns hand
     **/
-    std::vector<std::unique_ptr<card>>& get_hand() { 
+    std::pmr::vector<card_id>& get_hand() { 
         return hand; 
     }
 
@@ -107,80 +271,76 @@ public:
     * get the battlefield of the player
     * @returns battlefield
     **/
-    std::vector<std::unique_ptr<card>>& get_battlefield() { 
+    battlefield_zone& get_battlefield() { 
         return battlefield; 
     }
 
     /**
-    * get the mana pool of the player into a string ready to be printed 
+    * get the mana pool of the player
     * @returns mana pool
     **/
-    std::string print_mana_pool() const {
-        std::string mana_pool_string = "";
-		for (auto& [color, count] : mana_pool) {
-			mana_pool_string += std::to_string(count) + " " + color_to_string(color) + " ";
-		}
-        return mana_pool_string;
+    mana get_mana_pool() const {
+        return mana_pool;
+    }
+
+    /**
+    * check if the player already played a land this turn
+    * @returns true if a land was played
+    **/
+    bool has_played_land() const {
+        return played_land;
     }
 
+    /**
+    * get the mana pool of the player into a string ready to be printed 
+    * @returns mana pool
+    **/
+    std::string print_mana_pool() const;
+
     /**
     * get the battlefield of the player into a string ready to be printed 
     * @returns battlefield
     **/
-    void print_battlefield() {
-        std::cout << "Battlefield of " << this->get_damagable_name() << ":\n";
-        for (auto&& smt : battlefield) {
-            std::cout << smt->get_name() << " - " << smt->get_type() << " - " << (smt->is_tapped() ? "tapped" : "untapped");
-            if (smt->get_type() == "creature") {
-				std::cout << "(" << (static_cast<creature*>(smt.get())->get_summoning_sickness() ? "ss" : "nss" ) << ") - " << static_cast<creature*>(smt.get())->get_power() << " - " << static_cast<creature*>(smt.get())->get_health();
-			}
-			std::cout << "\n";
-        }
-		std::cout << "\n";
-    }
+    void print_battlefield();
 
     /**
     * get the graveyard of the player into a string ready to be printed
     * @returns graveyard
     **/
-    void print_graveyard() {
-        std::cout << "Graveyard of " << this->get_damagable_name() << ":\n";
-        for (auto&& smt : graveyard) {
-            std::cout << smt->get_name() << " - " << smt->get_type() << "\n";
-        }
-		std::cout << "\n";
-    }
+    void print_graveyard();
 
     /**
     * add mana to the mana pool
     * @param color_of_mana color of the mana
     **/
-    void add_to_mana_pool(color color_of_mana) { mana_pool[color_of_mana]++; }
+    void add_to_mana_pool(color color_of_mana) {
+        record_counters();
+        mana_pool.add(color_of_mana);
+    }
 
     /**
     * shuffle the library of the player, uses internal library
+    * @param gen random generator of the game
     **/
-    void shuffle() {
-        std::shuffle(library.begin(), library.end(), std::mt19937(std::random_device()()));
+    void shuffle(game_rng& gen) {
+        record(library);
+        gen.shuffle(library.begin(), library.end());
+        rehash_library();
     }               
 
     /**
-    * mulligan the player
+    * mulligan the player once, the game asks if they want to mulligan again (see game::step)
     * @param n_of_cards number of cards to draw after mulligan
+    * @param gen random generator of the game
     **/
-    void mulligan(const size_t n_of_cards) {
-        for (size_t i = 0; i < this->hand.size(); i++) {
-            library.push_back(std::move(hand[i]));
-        }
-        hand.clear();
-        shuffle();
-        std::string player_mulligan;
-        draw_card(n_of_cards);
-        display_hand();
-        std::cout << this->name << " mulligan? y/N\n";
-        std::getline(std::cin, player_mulligan);
-        if ((player_mulligan == "Y" || player_mulligan == "y") && (n_of_cards > 1)) mulligan(n_of_cards - 1);
-        else if (n_of_cards == 1) std::cout << "You can't mulligan anymore, you have 1 card in your hand\n\n";
+    void mulligan(const size_t n_of_cards, game_rng& gen);
+
+    /**
+    * ask the agent of the player if they want to mulligan their current hand
+    * @returns true if the player wants to mulligan
+    **/
+    bool wants_mulligan() {
+        return decider->choose_mulligan(*this);
     }
 
     /**
@@ -193,67 +353,72 @@ public:
             this->add_life(-999999999);
             return;
         }
+        record(library);
+        record(hand);
         for (size_t i = 0; i < n_of_cards; i++) {
+            library_hash -= zobrist_key(zobrist_part::LIBRARY, library.back(), library.size() - 1);
+            hand_hash += zobrist_key(zobrist_part::HAND, library.back());
+            publish_move(library.back(), ZoneType::LIBRARY, ZoneType::HAND);
             hand.push_back(std::move(library.back()));
             library.pop_back();
         }
     }
 
     /**
-    * discard n_of_cards from the hand
+    * discard n_of_cards from the hand, the whole hand if it has fewer cards,
+    * otherwise the player chooses them one by one (see discard_for_effect)
     * @param n_of_cards number of cards to discard
     **/
-    void discard(const size_t n_of_cards) {
-        if (n_of_cards > hand.size()) {
-            for (auto&& card : hand) {
-                graveyard.push_back(std::move(card));
-            }
-            return;
-        }
-        for (size_t i = 0; i < n_of_cards; i++) {
-            std::cout << "Select a card to discard: \n";
-            for (size_t j = 0; j < hand.size(); j++) {
-                std::cout << j << ": " << hand[j]->get_name() << "\n";
-            }
-            int choice = 0;
-            if (std::cin >> choice) {
-                graveyard.push_back(std::move(hand[choice]));
-                hand.erase(hand.begin() + choice);
-            } else {
-                i--;
-                std::cin.clear();
-                std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-            }
-        }
+    void discard(const size_t n_of_cards);
+
+    /**
+    * discard one of the cards an effect made the player discard
+    * @param index index of the card in the hand
+    *
+    * @returns false if there is no such card
+    **/
+    bool discard_for_effect(size_t index);
+
+    /**
+    * get the number of cards an effect made the player discard that are not chosen yet (see discard)
+    * @returns number of cards
+    **/
+    size_t get_discards_left() const {
+        return discards_left;
     }
 
     /**
-    * display the hand of the player
+    * discard a card from the hand
+    * @param index index of the card in the hand
+    *
+    * @returns false if there is no such card
     **/
-    void display_hand() {
-        std::cout << this->get_damagable_name() << "\n";
-        for (auto&& card : hand) {
-            std::cout << card->get_name() << " - " << card->get_type();
-            if (card->get_type() != "land") {
-                std::cout << " - " << static_cast<spell*>(card.get())->get_cost();
-            }
-            std::cout << "\n";
-        }
-        std::cout << "\n";
+    bool discard_card(size_t index) {
+        if (index >= hand.size()) return false;
+        record(hand);
+        record(graveyard);
+        hand_hash -= zobrist_key(zobrist_part::HAND, hand[index]);
+        graveyard_hash += zobrist_key(zobrist_part::GRAVEYARD, hand[index]);
+        publish_move(hand[index], ZoneType::HAND, ZoneType::GRAVEYARD);
+        graveyard.push_back(std::move(hand[index]));
+        hand.erase(hand.begin() + index);
+        return true;
     }
 
+    /**
+    * display the hand of the player
+    **/
+    void display_hand();
+
     /**
     * select creatures you want to attack with
+    * @param opponent pointer to the opponent
+    * 
     * @returns selected creatures in the form of a vector of indices
     **/
-    std::vector<size_t> select_attackers() {
+    std::vector<size_t> select_attackers(player* opponent) {
         if (battlefield.size() == 0) return std::vector<size_t>();
-		std::cout << this->get_damagable_name() << " Select attackers: \n";
-		for (size_t i = 0; i < battlefield.size(); i++) {
-			std::cout << i + 1 << ": " << battlefield[i]->get_name() << "\n";
-		}
-
-        return selector();
+        return decider->choose_attackers(*this, *opponent);
     }
 
     /**
@@ -264,324 +429,245 @@ public:
     * @returns selected creatures in the form of a map of attackers to vector of indices of blockers
     **/
     std::map<size_t, std::vector<size_t>> select_blockers(std::vector<size_t> attackers, player* opponent) {
-        std::map<size_t, std::vector<size_t>> ret;
-        for (size_t i = 0; i < battlefield.size(); i++) {
-            std::cout << i + 1 << ": " << battlefield[i]->get_name() << "\n";
-        }
-        std::cout << this->get_damagable_name() << " Select blocker/s for each attacker: \n";
-        for (auto&& attacker : attackers) {
-			std::cout << opponent->get_battlefield()[attacker]->get_name() << "\n";
-            ret[attacker] = selector();
-        }
-        return ret;
+        return decider->choose_blockers(*this, *opponent, attackers);
     }
 
     /**
     * select the order you want to battle the blocking creatures as the attacker
     * @param attacker index of the attacker
     * @param blockers vector of indices of creatures that are blocking
+    * @param opponent pointer to the blocking player
     * 
     * @returns selected order in the form of a vector of indices
     **/
-    std::vector<size_t> select_order_of_blockers(size_t attacker, std::vector<size_t> blockers) {
-        std::cout << this->get_damagable_name() << " Select order of blockers for " << battlefield[attacker]->get_name() << "\n";
-        bool correct_input = false;
-        std::vector<size_t> ret;
-        while (!correct_input) {
-            ret = selector();
-            if (ret.size() == blockers.size() && std::includes(ret.begin(), ret.end(), blockers.begin(), blockers.end())) { // includes in this case means that all elements of blockers are in ret
-                correct_input = true;
-            } else {
-                std::cout << "Incorrect input\n";
-            }
-        }
-		return ret;
-    }
-
-    /**
-    * selector of indices from a list to create a vector
-    * @returns selected creatures in the form of a vector of indices
-    **/
-    std::vector<size_t> selector() {
-        std::string choice;
-        std::getline(std::cin, choice);
-
-        std::istringstream iss(choice);
-        std::vector<size_t> ret;
-
-        size_t num;
-        while (iss >> num) {
-            ret.push_back(num - 1);
-        }
-        return ret;
-    }
+    std::vector<size_t> select_order_of_blockers(size_t attacker, std::vector<size_t> blockers, player* opponent);
 
     /**
     * empty the mana pool
     **/
     void empty_mana_pool() {
-        for (const auto& key : mana_pool | std::views::keys) {
-            mana_pool[key] = 0;
-        }
+        record_counters();
+        mana_pool.clear();
     }
 
     /**
     * heal all creatures
     **/
-    void heal_creatures() const
+    void heal_creatures()
     {
-        for (auto&& card : battlefield) {
-            auto creature_ = static_cast<creature*>(card.get());
-            if (creature_ != nullptr) {
-                creature_->set_health(creature_->get_toughness());
-            }
-        }
+        battlefield.heal_creatures();
     }
 
     /**
-    * send a permanent to the graveyard from the battlefield
-    * @param target permanent reference to send
+    * send a card to the graveyard from the battlefield
+    * @param index index of the card on the battlefield
     **/
-    void send_to_graveyard(const permanent& target) {
-        move_card_from_target_to_target(target, battlefield, graveyard);
+    void send_to_graveyard(size_t index) {
+        record(graveyard);
+        graveyard.push_back(battlefield.remove(index));
+        graveyard_hash += zobrist_key(zobrist_part::GRAVEYARD, graveyard.back());
+        publish_move(graveyard.back(), ZoneType::BATTLEFIELD, ZoneType::GRAVEYARD);
     }
 
     /**
-    * send a card to the graveyard from the battlefield
-    * @param target card pointer to send
+    * send all dead creatures to the graveyard
     **/
-    void send_to_graveyard(card* target) {
-        auto found = std::find_if(battlefield.begin(), battlefield.end(),
-			[&target](const std::unique_ptr<card>& cardPtr) {
-				return *cardPtr == *target;
-			});
-
-		move_from_vector_to_another(found, battlefield, graveyard);
+    void send_dead_to_graveyard() {
+        if (!battlefield.any_dead()) return;
+        for (size_t i = 0; i < battlefield.size(); i++) {
+            if (battlefield.is_dead(i)) {
+                send_to_graveyard(i);
+                i--;
+            }
+        }
     }
 
     /**
     * play a turn from the command line with some options
+    * the agent is offered the legal moves first and asked for a command if it doesn't pick one
     * @param opponent player for reference
     * 
     * @returns true if the player ended his main phase
     **/
-    bool play(player& opponent) {
-        std::string action;
-        std::getline(std::cin, action);
-        if (action == "concede") {
-            concede();
-            return true;
-        } else if (action == "pass") {
-            pass_turn();
-            return true;
-        } else if (action == "hand") {
-			display_hand();
-        } else if (action == "battlefield") {
-            print_battlefield();
-        } else if (action == "graveyard") {
-            print_graveyard();
-        } else {
-            return decode_play(action, opponent);
-        }
-        return false;
-    }
+    bool play(player& opponent);
+
+    /**
+    * check a main phase move against the zones of the players, the conditions of move_generator::main_phase
+    * a spell may be cast without a target, its effects then ask for theirs
+    * @param chosen the move
+    * @param opponent player for reference
+    *
+    * @returns true if the move can be made
+    **/
+    bool is_legal_move(const move& chosen, const player& opponent) const;
 
-    static void check_effects(phase start_of) {
-        // TODO: do this (actually might not be necessary)
+    /**
+    * make a main phase move, one of move_generator::main_phase
+    * @param chosen the move, copied because it may point into the buffer of a generator that effects reuse
+    * @param opponent player for reference
+    *
+    * @returns true if the player ended his main phase, false also if the move is not legal (see is_legal_move)
+    **/
+    bool apply_move(move chosen, player& opponent);
+
+    /**
+    * checks if the effects of a spell the player cast wait for a decision, the target of an effect (see get_effect_to_target)
+    * or the cards an effect made a player discard (see get_discards_left)
+    * @returns true if they wait
+    **/
+    bool is_resolving() const {
+        return resolving;
     }
 
+    /**
+    * get the effect that waits for a target
+    * @returns the effect, nullptr if the effects wait for no target
+    **/
+    const effect* get_effect_to_target() const;
+
+    /**
+    * target the effect that waits for a target and resolve the effects after it up to the next decision
+    * @param target the target in the format of agent::choose_target
+    * @param opponent player for reference
+    *
+    * @returns false if no effect waits for a target, there is no such target or it is a creature for an effect on players
+    * or a player for an effect on creatures (see effect::get_target)
+    **/
+    bool target_effect(std::string target, player& opponent);
+
+    /**
+    * resolve the effects of the spell up to the next decision, e.g. once the cards of a discard were chosen
+    * @param opponent player for reference
+    **/
+    void resume_effects(player& opponent);
+
     /**
     * reset the played_land flag for the next turn
     **/
     void reset_played_land() {
+        record_counters();
         played_land = false;
     }
 
 private:
+    friend class undo_log;
+
 	std::string name;
 	int life = 0;
     bool played_land = false;
 
-    std::map<color, int> mana_pool;
-
-    std::vector<std::unique_ptr<card>> library;
-    std::vector<std::unique_ptr<card>> graveyard;
-    std::vector<std::unique_ptr<card>> hand;
-    std::vector<std::unique_ptr<card>> battlefield;
-
-    void pass_turn() {
-        std::cout << this->get_damagable_name() << " passed their current phase\n";
-    }
-    void concede() {
-        std::cout << this->get_damagable_name() << " conceded\n";
-        deal_damage(INT_MAX);
-    }
-
-    bool decode_play(std::string& play, player& opponent) {
-        size_t offset_to_space = play.find(" ");
-        if (offset_to_space != std::string::npos) {
-            if (play.substr(0,offset_to_space) == "tap") {
-                std::string name = play.substr(offset_to_space+1);
-                for (auto&& smt : battlefield) {
-                    if (smt->get_name() == name && !smt->is_tapped() && smt->get_type() == "land") {
-                        smt->set_tapped(true);
-                        mana_pool[static_cast<land*>(smt.get())->get_taps_for()]++;
-                        break;
-                    }
-                }
-                std::cout << this->print_mana_pool() << "\n";
-            } else if (play.substr(0,offset_to_space) == "play" || play.substr(0,offset_to_space) == "cast") {
-                return cast_card(play.substr(offset_to_space + 1), opponent);
-            }
-        }
-        return false;
-    }
-
-    bool cast_card(std::string name, player& opponent) {
-        std::string cost;
-        for (auto&& smt : hand) {
-            if (smt->get_name() == name && smt->get_type() != "land") {
-                cost = static_cast<spell*>(smt.get())->get_cost();
-                if (!pay(cost)) {
-                    return false;
-                }
-
-                auto found = std::find_if(hand.begin(), hand.end(),
-                    [&smt](const std::unique_ptr<card>& cardPtr) {
-                        return *cardPtr == *smt;
-                    });
-
-                if (smt->get_type() == "creature") {
-                    if (found != hand.end()) {
-                        do_effects(smt, opponent);
-                        battlefield.push_back(std::move(*found));
-                        std::iter_swap(found, hand.end() - 1);
-                        hand.pop_back();
-                    }
-                }
-                else {
-                    if (found != hand.end()) {
-                        do_effects(smt, opponent);
-                        graveyard.push_back(std::move(*found));
-                        std::iter_swap(found, hand.end() - 1);
-                        hand.pop_back();
-                    }
-                }
-                break;
-            }
-            else if (smt->get_name() == name && smt->get_type() == "land") {
-                if (played_land) {
-                    std::cout << "you can only play one land per turn\n";
-                    return false;
-                }
-
-                move_card_from_target_to_target(*smt, hand, battlefield);
-                played_land = true;
-                break;
-            }
-        }
-        print_battlefield();
-        return false;
-    }
-
-    bool pay(std::string& cost) {
-        if (can_pay(mana_pool, cost)) {
-            // for now, counting on the player to tap precisely how he needs and not more
-            empty_mana_pool();
-            return true;
-        } else {
-            std::cout << "You can't pay for that with your current mana pool\n";
-            return false;
-        }
-    }
-	
-    void move_card_from_target_to_target(const card& target, std::vector<std::unique_ptr<card>>& source_vector, std::vector<std::unique_ptr<card>>& target_vector) {
-        auto found = std::find_if(source_vector.begin(), source_vector.end(),
-			[&target](const std::unique_ptr<card>& cardPtr) {
-				return *cardPtr == target;
-			});
+    mana mana_pool;
+
+    // the spell whose effects wait for a decision, the effects before next_effect resolved
+    bool resolving = false;
+    card_id resolving_spell = 0;
+    size_t next_effect = 0;
+    // the target of the effects chosen with the move, NONE to ask for the target of every effect
+    MoveTarget resolving_target = MoveTarget::NONE;
+    permanent_handle resolving_creature;
+    // the cards an effect made the player discard that are not chosen yet
+    size_t discards_left = 0;
+
+    agent* decider;
+
+    std::pmr::vector<card_id> library;
+    std::pmr::vector<card_id> graveyard;
+    std::pmr::vector<card_id> hand;
+    battlefield_zone battlefield;
+
+    move_generator legal_moves;
 
-		move_from_vector_to_another(found, source_vector, target_vector);
+    // zobrist hashes of the card zones (see hash), the battlefield keeps its own
+    std::uint64_t library_hash = 0;
+    std::uint64_t graveyard_hash = 0;
+    std::uint64_t hand_hash = 0;
+
+    undo_log* journal = nullptr;
+    action_log* actions = nullptr;
+    const event_origin* origin = nullptr;
+
+    bool publishes(EventLevel level) const {
+        return origin != nullptr && event_log_enabled(level);
     }
 
-    void move_from_vector_to_another(std::vector<std::unique_ptr<card>>::iterator found ,std::vector<std::unique_ptr<card>>& source_vector, std::vector<std::unique_ptr<card>>& target_vector) {
-        if (found != source_vector.end()) {
-            target_vector.push_back(std::move(*found));
-            std::iter_swap(found, source_vector.end() - 1);
-            source_vector.pop_back();
-        }
+    void publish_card(GameEventType type, card_id card) {
+        if (!publishes(EventLevel::TURN)) return;
+        game_event event(*origin, type, name);
+        event.card = card;
+        event_bus::publish(event);
     }
 
-    void destroy(const card& target) {
-        move_card_from_target_to_target(target, battlefield, graveyard);
+    void publish_move(card_id card, ZoneType from, ZoneType to) {
+        if (!publishes(EventLevel::ZONE)) return;
+        game_event event(*origin, GameEventType::ZONE_CHANGE, name);
+        event.card = card;
+        event.from = from;
+        event.to = to;
+        event_bus::publish(event);
     }
 
-    bool can_pay(std::map<color, int> mana_pool, std::string& cost) {
-        int any = 0;
-        if (isdigit(cost[0])) {
-            any = cost[0] - '0';
-            cost = cost.substr(1);
-        }
+    void record_counters() {
+        if (journal != nullptr) journal->save_counters(*this);
+    }
 
-        std::map<color, int> mana_pool_local = mana_pool;
-
-		for (auto&& ch : cost) {
-			if (isalpha(ch)) {
-				if (mana_pool_local[char_to_color_map(ch)] < 1) {
-					return false;
-				}
-				mana_pool_local[char_to_color_map(ch)] -= 1;
-			}
-		}
-
-        int mana = 0;
-        for (auto&& [color, count] : mana_pool_local) {
-			mana += count;
-		}
-		if (mana >= any) {
-			return true;
-		}
-
-        return false;
-    }
-
-    void do_effects(std::unique_ptr<card>& smt, player& opponent) {
-        auto& effects = static_cast<creature*>(&*smt)->get_effects();
-        for (auto&& eff : effects) {
-            if (eff->get_name() == "nothing") {
-                continue;
-            }
-            std::cout << "Enter target for effect " << eff->get_name() << " : ";
-            std::string target;
-            std::getline(std::cin, target);
-            auto&& target_ptr = parse_target(target, opponent);
-            eff->execute(target_ptr);
+    // the hash of the zone is one of the counters
+    void record(std::pmr::vector<card_id>& zone) {
+        if (journal != nullptr) {
+            journal->save_zone(zone);
+            journal->save_counters(*this);
         }
     }
 
-    damagable& parse_target(std::string& target, player& opponent) {
-        if (target == "me" || target == this->name) {
-            return *this;
-        } else if (target == "opp" || target == opponent.name) {
-            return opponent;
-        } else {
-            std::string owner = target.substr(0, target.find("-"));
-            std::string name = target.substr(target.find("-") + 1);
-            if (owner == "me") {
-                for (auto&& card : battlefield) {
-					if (card->get_name() == name) {
-						return static_cast<creature&>(*card);
-					}
-				}
-            } else {
-                for (auto&& card : opponent.battlefield) {
-                    if (card->get_name() == name) {
-                        return static_cast<creature&>(*card);
-                    }
-                }
-            }
+    void rehash_library() {
+        library_hash = 0;
+        for (size_t i = 0; i < library.size(); i++) {
+            library_hash += zobrist_key(zobrist_part::LIBRARY, library[i], i);
         }
     }
+
+    void pass_turn();
+    void concede();
+
+    bool decode_play(std::string& play, player& opponent);
+
+    /**
+    * finds the land of a tap command, "Name" or "Name X" where X is the color to tap a land of more colors for
+    * @param target what follows "tap "
+    * @param id set to the id of the land
+    * @param chosen set to the color if there is one
+    *
+    * @returns true if the land is a known card
+    **/
+    static bool find_land_to_tap(std::string_view target, card_id& id, std::optional<color>& chosen);
+
+    void tap_land(size_t index, color color_of_mana);
+
+    bool cast_card(const std::string& name, player& opponent);
+
+    void cast_from_hand(std::pmr::vector<card_id>::iterator found, player& opponent, const move& chosen);
+
+    bool pay(const mana_cost& cost);
+	
+    void remove_from_hand(std::pmr::vector<card_id>::iterator found);
+
+    void do_effects(card_id spell, player& opponent, const move& chosen);
+
+    // puts the resolved spell onto the battlefield if it is a creature, into the graveyard otherwise
+    void finish_spell();
+
+    bool has_creature() const;
+
+    damagable* move_target(player& opponent, std::optional<creature_ref>& creature_target);
+
+    damagable* parse_target(std::string& target, player& opponent, std::optional<creature_ref>& creature_target);
 };
 
+inline size_t creature_ref::get_index() const {
+    return controller.get_battlefield().index_of(creature);
+}
+
+inline bool creature_ref::is_valid() const {
+    return controller.get_battlefield().contains(creature);
+}
+
 #endif
\ No newline at end of file
@@ -0,0 +1,135 @@
+#ifndef MTG_ENGINE_RANDOM_H
+#define MTG_ENGINE_RANDOM_H
+
+#include <cstdint>
+#include <iterator>
+#include <random>
+#include <utility>
+
+/**
+* one step of splitmix64, used to spread seeds over the whole state
+* @param x state, advanced by the call
+*
+* @returns next output
+**/
+inline std::uint64_t splitmix64(std::uint64_t& x) {
+	std::uint64_t z = (x += 0x9e3779b97f4a7c15ULL);
+	z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+	return z ^ (z >> 31);
+}
+
+/**
+* derive an independent seed for a sub-stream (a game of a batch, an agent of a game)
+* @param seed base seed
+* @param stream index of the sub-stream
+*
+* @returns the derived seed
+**/
+inline std::uint64_t mix_seed(std::uint64_t seed, std::uint64_t stream) {
+	std::uint64_t x = seed ^ (stream * 0xd1b54a32d192ed03ULL);
+	return splitmix64(x);
+}
+
+/**
+* get a seed from std::random_device, for games that were not given one
+*
+* @returns the seed
+**/
+inline std::uint64_t random_seed() {
+	std::random_device rd;
+	return (static_cast<std::uint64_t>(rd()) << 32) | rd();
+}
+
+// xoshiro256** generator owned by every game, seeded once, 32 bytes of state
+// satisfies UniformRandomBitGenerator, but shuffle and below are used instead of the std algorithms
+// so the same seed gives the same game with every standard library
+class game_rng
+{
+public:
+	using result_type = std::uint64_t;
+
+	/**
+	* game_rng constructor
+	* @param seed the seed, every value (including 0) is fine
+	**/
+	explicit game_rng(std::uint64_t seed = 0) {
+		this->seed(seed);
+	}
+
+	/**
+	* reseed the generator
+	* @param seed the new seed
+	**/
+	void seed(std::uint64_t seed) {
+		for (auto&& word : state) {
+			word = splitmix64(seed);
+		}
+	}
+
+	static constexpr result_type min() { return 0; }
+	static constexpr result_type max() { return ~static_cast<result_type>(0); }
+
+	/**
+	* get the next 64 random bits
+	*
+	* @returns random number
+	**/
+	result_type operator()() {
+		const std::uint64_t result = rotl(state[1] * 5, 7) * 9;
+		const std::uint64_t t = state[1] << 17;
+		state[2] ^= state[0];
+		state[3] ^= state[1];
+		state[1] ^= state[2];
+		state[0] ^= state[3];
+		state[2] ^= t;
+		state[3] = rotl(state[3], 45);
+		return result;
+	}
+
+	/**
+	* get a uniform random number in [0, bound) without modulo bias
+	* @param bound exclusive upper bound, must not be 0
+	*
+	* @returns random number
+	**/
+	std::uint64_t below(std::uint64_t bound) {
+		const std::uint64_t threshold = (0 - bound) % bound;
+		while (true) {
+			const std::uint64_t r = (*this)();
+			if (r >= threshold) return r % bound;
+		}
+	}
+
+	/**
+	* get a random bool
+	*
+	* @returns true or false with the same probability
+	**/
+	bool coin_flip() {
+		return ((*this)() >> 63) != 0;
+	}
+
+	/**
+	* Fisher-Yates shuffle of a range
+	* @param first begin of the range
+	* @param last end of the range
+	**/
+	template <class RandomIt>
+	void shuffle(RandomIt first, RandomIt last) {
+		auto n = static_cast<std::uint64_t>(std::distance(first, last));
+		for (std::uint64_t i = n; i > 1; i--) {
+			using std::swap;
+			swap(first[i - 1], first[below(i)]);
+		}
+	}
+
+private:
+	std::uint64_t state[4];
+
+	static std::uint64_t rotl(std::uint64_t x, int k) {
+		return (x << k) | (x >> (64 - k));
+	}
+};
+
+#endif //MTG_ENGINE_RANDOM_H
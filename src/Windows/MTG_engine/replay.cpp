@@ -0,0 +1,261 @@
+#include "replay.hpp"
+#include "game.hpp"
+#include "card_catalog.hpp"
+
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+
+constexpr char MAGIC[4] = { 'M', 'T', 'G', 'R' };
+constexpr size_t HEADER_SIZE = 4 + 4 + 8;
+constexpr size_t SEED_AND_WINNER = 8 + 1;
+
+void put_varint(std::vector<std::uint8_t>& out, std::uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<std::uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<std::uint8_t>(value));
+}
+
+void put_u64(std::vector<std::uint8_t>& out, std::uint64_t value, size_t n_of_bytes = 8) {
+    for (size_t i = 0; i < n_of_bytes; i++) {
+        out.push_back(static_cast<std::uint8_t>(value >> (8 * i)));
+    }
+}
+
+std::uint64_t read_u64(const std::uint8_t* bytes, size_t n_of_bytes = 8) {
+    std::uint64_t ret = 0;
+    for (size_t i = 0; i < n_of_bytes; i++) {
+        ret |= static_cast<std::uint64_t>(bytes[i]) << (8 * i);
+    }
+    return ret;
+}
+
+size_t varint_size(std::uint64_t value) {
+    size_t ret = 1;
+    while (value >= 0x80) {
+        value >>= 7;
+        ret++;
+    }
+    return ret;
+}
+
+}
+
+std::uint64_t deck_fingerprint(const compiled_deck& deck1, const compiled_deck& deck2) {
+    // FNV-1a, the same on every platform unlike std::hash
+    std::uint64_t ret = 0xcbf29ce484222325ULL;
+    auto add = [&ret](std::uint8_t byte) {
+        ret = (ret ^ byte) * 0x100000001b3ULL;
+    };
+    for (const compiled_deck* deck : { &deck1, &deck2 }) {
+        for (auto&& id : deck->get_cards()) {
+            for (char c : card_definition(id).get_name()) add(static_cast<std::uint8_t>(c));
+            add(0);
+        }
+        add(0xFF);
+    }
+    return ret;
+}
+
+std::uint8_t replay_winner(game& played) {
+    return static_cast<std::uint8_t>(played.get_winner_seat());
+}
+
+replay_writer::replay_writer(const std::string& filename, std::uint64_t fingerprint, size_t buffer_size)
+    : out(filename, std::ios::binary | std::ios::trunc), buffer_size(buffer_size) {
+    if (!out) {
+        throw std::runtime_error("can't write replay: " + filename);
+    }
+    buffer.reserve(buffer_size + 64);
+    for (char c : MAGIC) buffer.push_back(static_cast<std::uint8_t>(c));
+    put_u64(buffer, REPLAY_VERSION, 4);
+    put_u64(buffer, fingerprint);
+    bytes = buffer.size();
+}
+
+replay_writer::~replay_writer() {
+    flush();
+}
+
+void replay_writer::write_game(std::uint64_t seed, std::uint8_t winner, size_t turns, const action_log& actions) {
+    const std::vector<std::uint8_t>& decisions = actions.get_bytes();
+    const size_t start = buffer.size();
+    put_varint(buffer, SEED_AND_WINNER + varint_size(turns) + decisions.size());
+    put_u64(buffer, seed);
+    buffer.push_back(winner);
+    put_varint(buffer, turns);
+    buffer.insert(buffer.end(), decisions.begin(), decisions.end());
+    bytes += buffer.size() - start;
+    games++;
+    if (buffer.size() >= buffer_size) flush();
+}
+
+void replay_writer::flush() {
+    if (buffer.empty()) return;
+    out.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+    out.flush();
+    buffer.clear();
+}
+
+replay_file::replay_file(const std::string& filename, std::uint64_t fingerprint) : file(filename) {
+    const std::uint8_t* data = reinterpret_cast<const std::uint8_t*>(file.data());
+    const size_t size = file.size();
+    if (size < HEADER_SIZE || std::memcmp(data, MAGIC, 4) != 0) {
+        throw std::runtime_error("not a replay: " + filename);
+    }
+    if (read_u64(data + 4, 4) != REPLAY_VERSION) {
+        throw std::runtime_error("unsupported replay version: " + filename);
+    }
+    if (read_u64(data + 8) != fingerprint) {
+        throw std::runtime_error("replay was recorded with other decks: " + filename);
+    }
+
+    // find every record once, get() trusts the offsets afterwards
+    action_reader lengths(data, size);
+    lengths.seek(HEADER_SIZE);
+    while (!lengths.at_end()) {
+        size_t length = lengths.get_index();
+        size_t offset = lengths.tell();
+        if (length < SEED_AND_WINNER || offset > size || length > size - offset) {
+            throw std::runtime_error("damaged replay: " + filename);
+        }
+        offsets.push_back(offset);
+        ends.push_back(offset + length);
+        lengths.seek(offset + length);
+    }
+}
+
+replay_record replay_file::get(size_t index) const {
+    const std::uint8_t* data = reinterpret_cast<const std::uint8_t*>(file.data());
+    const std::uint8_t* record_start = data + offsets[index];
+    replay_record ret;
+    ret.seed = read_u64(record_start);
+    ret.winner = record_start[8];
+    action_reader rest(record_start + SEED_AND_WINNER, ends[index] - offsets[index] - SEED_AND_WINNER);
+    ret.turns = rest.get_index();
+    ret.actions = record_start + SEED_AND_WINNER + rest.tell();
+    ret.actions_size = data + ends[index] - ret.actions;
+    return ret;
+}
+
+std::string replay_agent::choose_play(player&, player&) {
+    return reader.get_string();
+}
+
+bool replay_agent::choose_mulligan(player&) {
+    return reader.get_flag();
+}
+
+std::vector<size_t> replay_agent::choose_attackers(player&, player&) {
+    return reader.get_indices();
+}
+
+std::map<size_t, std::vector<size_t>> replay_agent::choose_blockers(player&, player&, const std::vector<size_t>&) {
+    return reader.get_blocks();
+}
+
+std::vector<size_t> replay_agent::choose_order_of_blockers(player&, player&, size_t, const std::vector<size_t>&) {
+    return reader.get_indices();
+}
+
+size_t replay_agent::choose_discard(player&) {
+    return reader.get_index();
+}
+
+std::string replay_agent::choose_target(player&, player&, const effect&) {
+    return reader.get_target();
+}
+
+game_replay::game_replay(const compiled_deck& deck1, const compiled_deck& deck2, const replay_record& record, size_t checkpoint_interval)
+    : record(record), checkpoint_interval(checkpoint_interval), reader(record.actions, record.actions_size), answers(reader) {
+    current = std::make_unique<game>("Player 1", "Player 2", deck1.instantiate(&resource), deck2.instantiate(&resource), &answers, &answers, record.seed);
+    checkpoints.push_back({ std::make_unique<game>(*current, &resource), 0 });
+}
+
+game_replay::~game_replay() = default;
+
+bool game_replay::step() {
+    game& played = *current;
+    if (played.is_ended()) return false;
+    DecisionType decision = played.get_decision();
+    if (decision != DecisionType::NONE && reader.at_end()) return false;
+
+    decision_reply reply;
+    move chosen;
+    switch (decision) {
+        case DecisionType::NONE:
+            played.step();
+            break;
+        case DecisionType::MULLIGAN:
+            reply.mulligan = reader.get_flag();
+            played.step(reply);
+            break;
+        case DecisionType::MAIN_PHASE:
+            if (reader.get_move(chosen)) {
+                played.step(chosen);
+            } else {
+                // a console command, the agent reads it when the game asks for it
+                played.step();
+            }
+            break;
+        case DecisionType::ATTACKERS:
+        case DecisionType::ORDER_BLOCKERS:
+            played.step(reader.get_indices());
+            break;
+        case DecisionType::BLOCKERS:
+            played.step(reader.get_blocks());
+            break;
+        case DecisionType::DISCARD:
+            reply.card = reader.get_index();
+            played.step(reply);
+            break;
+        case DecisionType::TARGET:
+            reply.target = reader.get_target();
+            played.step(reply);
+            break;
+    }
+    save_checkpoint();
+    return true;
+}
+
+bool game_replay::run() {
+    while (step()) {}
+    return current->is_ended() && replay_winner(*current) == record.winner && current->get_turn_number() == record.turns;
+}
+
+bool game_replay::seek(size_t turn) {
+    // between turns the turn number is the number of the turn that ended, during a turn it is its own
+    auto at_turn = [this, turn]() {
+        return turn == 0 ? !current->is_started() : between_turns() && current->get_turn_number() == turn - 1;
+    };
+    if (at_turn()) return true;
+
+    // the turn is behind the game, go back to the last checkpoint before it
+    if (turn == 0 || current->get_turn_number() >= turn) {
+        size_t index = (turn == 0 || checkpoint_interval == 0) ? 0 : std::min((turn - 1) / checkpoint_interval, checkpoints.size() - 1);
+        current = std::make_unique<game>(*checkpoints[index].state, &resource);
+        reader.seek(checkpoints[index].position);
+        if (at_turn()) return true;
+    }
+
+    while (!at_turn()) {
+        if (!step()) return false;
+    }
+    return true;
+}
+
+bool game_replay::between_turns() {
+    // the starting hands were dealt and kept, no turn is in progress and the game goes on
+    return current->is_started() && current->get_decision() == DecisionType::NONE && !current->is_ended();
+}
+
+void game_replay::save_checkpoint() {
+    if (checkpoint_interval == 0 || !between_turns()) return;
+    size_t turn_number = current->get_turn_number();
+    if (turn_number > 0 && turn_number == checkpoints.size() * checkpoint_interval) {
+        checkpoints.push_back({ std::make_unique<game>(*current, &resource), reader.tell() });
+    }
+}
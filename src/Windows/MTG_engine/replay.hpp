@@ -0,0 +1,256 @@
+#ifndef MTG_ENGINE_REPLAY_H
+#define MTG_ENGINE_REPLAY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <vector>
+#include "action_log.hpp"
+#include "agent.hpp"
+#include "deck.hpp"
+#include "mapped_file.hpp"
+
+class game;
+
+constexpr std::uint32_t REPLAY_VERSION = 1;
+
+// a file of recorded games, written by replay_writer and read in place by replay_file
+//
+//   header:  "MTGR", version (little endian 32 bit), fingerprint of the decks (little endian 64 bit, see deck_fingerprint)
+//   games:   one record after another, the size of the rest of the record as a varint, the seed (little endian 64 bit),
+//            the winner (one byte, see replay_winner), the number of turns as a varint and the decisions (see action_log)
+// a game is its seed and its decisions, about 14 bytes per turn, everything else is replayed
+
+/**
+* get the fingerprint of the decks of a game, a replay only fits the decks it was recorded with
+* @param deck1 deck of player 1
+* @param deck2 deck of player 2
+*
+* @returns hash of the names of the cards in the order of the decks
+**/
+std::uint64_t deck_fingerprint(const compiled_deck& deck1, const compiled_deck& deck2);
+
+/**
+* get the winner of a game in the format of a replay (see game::get_winner_seat)
+* @param played the game
+*
+* @returns 1 if the first player won, 2 if the second one won, 0 for a draw or a game that didn't end
+**/
+std::uint8_t replay_winner(game& played);
+
+// a recorded game in a replay_file, the decisions point into the file
+struct replay_record
+{
+	std::uint64_t seed = 0;
+	std::uint8_t winner = 0;
+	size_t turns = 0;
+	const std::uint8_t* actions = nullptr;
+	size_t actions_size = 0;
+};
+
+// appends recorded games to a replay file, the records are buffered and written when the buffer is full,
+// on flush and when the writer is destroyed, one writer is used by one thread at a time
+class replay_writer
+{
+public:
+	/**
+	* replay writer constructor, writes the header
+	* throws std::runtime_error if the file can not be opened
+	* @param filename path to the file, replaced
+	* @param fingerprint fingerprint of the decks (see deck_fingerprint)
+	* @param buffer_size bytes of records kept before they are written
+	**/
+	replay_writer(const std::string& filename, std::uint64_t fingerprint, size_t buffer_size = 1 << 20);
+	~replay_writer();
+
+	replay_writer(const replay_writer&) = delete;
+	replay_writer& operator=(const replay_writer&) = delete;
+
+	/**
+	* add a game
+	* @param seed seed of the game
+	* @param winner winner of the game (see replay_winner)
+	* @param turns number of turns of the game
+	* @param actions the decisions of the game
+	**/
+	void write_game(std::uint64_t seed, std::uint8_t winner, size_t turns, const action_log& actions);
+
+	/**
+	* write the buffered records to the file
+	**/
+	void flush();
+
+	/**
+	* get the number of games added so far
+	*
+	* @returns number of games
+	**/
+	size_t get_games() const {
+		return games;
+	}
+
+	/**
+	* get the size of the file with the buffered records
+	*
+	* @returns size in bytes
+	**/
+	std::uint64_t get_bytes() const {
+		return bytes;
+	}
+
+private:
+	std::ofstream out;
+	std::vector<std::uint8_t> buffer;
+	size_t buffer_size;
+	size_t games = 0;
+	std::uint64_t bytes = 0;
+};
+
+// a replay file mapped into memory, the records are found once when it is opened
+class replay_file
+{
+public:
+	/**
+	* open a replay file
+	* throws std::runtime_error if it is not a replay file, it is damaged or it was recorded with other decks
+	* @param filename path to the file
+	* @param fingerprint fingerprint of the decks to replay it with (see deck_fingerprint)
+	**/
+	replay_file(const std::string& filename, std::uint64_t fingerprint);
+
+	/**
+	* get the number of recorded games
+	*
+	* @returns number of games
+	**/
+	size_t size() const {
+		return offsets.size();
+	}
+
+	/**
+	* get a recorded game
+	* @param index index of the game, in the order they were written
+	*
+	* @returns the record, valid while the file is open
+	**/
+	replay_record get(size_t index) const;
+
+	/**
+	* get the size of the file
+	*
+	* @returns size in bytes
+	**/
+	size_t get_bytes() const {
+		return file.size();
+	}
+
+private:
+	mapped_file file;
+	std::vector<size_t> offsets;	// of the seed of every record
+	std::vector<size_t> ends;
+};
+
+// an agent that answers from the decisions of a replay, for the decisions a player is asked for in the middle of a move
+// (targets, discards) and the commands of the console, the rest is given to the game with step(reply) by game_replay
+class replay_agent : public agent
+{
+public:
+	/**
+	* replay agent constructor
+	* @param reader the decisions, read as the game asks for them
+	**/
+	explicit replay_agent(action_reader& reader) : reader(reader) {}
+
+	std::string choose_play(player& me, player& opponent) override;
+	bool choose_mulligan(player& me) override;
+	std::vector<size_t> choose_attackers(player& me, player& opponent) override;
+	std::map<size_t, std::vector<size_t>> choose_blockers(player& me, player& opponent, const std::vector<size_t>& attackers) override;
+	std::vector<size_t> choose_order_of_blockers(player& me, player& opponent, size_t attacker, const std::vector<size_t>& blockers) override;
+	size_t choose_discard(player& me) override;
+	std::string choose_target(player& me, player& opponent, const effect& eff) override;
+
+private:
+	action_reader& reader;
+};
+
+// replays a recorded game: the game is rebuilt from its seed and every recorded decision is made again, nothing is
+// asked from an agent and nothing is printed unless game_log is on
+// a copy of the game is kept every checkpoint_interval turns, seek goes back to the nearest one instead of the start
+class game_replay
+{
+public:
+	/**
+	* game replay constructor, the game is before the starting hands are dealt
+	* @param deck1 deck of player 1
+	* @param deck2 deck of player 2
+	* @param record the recorded game, its decisions have to outlive the replay
+	* @param checkpoint_interval turns between the copies seek restores, 0 for none
+	**/
+	game_replay(const compiled_deck& deck1, const compiled_deck& deck2, const replay_record& record, size_t checkpoint_interval = 8);
+	~game_replay();
+
+	game_replay(const game_replay&) = delete;
+	game_replay& operator=(const game_replay&) = delete;
+
+	/**
+	* make the next recorded decision, or deal or start the next turn if the game waits for none
+	*
+	* @returns false if the game ended or the decisions ran out
+	**/
+	bool step();
+
+	/**
+	* replay the rest of the game
+	*
+	* @returns true if the game ended the way it was recorded, with the same winner and number of turns
+	**/
+	bool run();
+
+	/**
+	* go to the start of a turn, before its untap step, back to the nearest checkpoint first if the turn is behind the game
+	* @param turn the turn, counted from 1, 0 for before the starting hands are dealt
+	*
+	* @returns false if the game ended before that turn
+	**/
+	bool seek(size_t turn);
+
+	/**
+	* get the replayed game
+	*
+	* @returns the game
+	**/
+	game& get_game() {
+		return *current;
+	}
+
+private:
+	struct checkpoint {
+		std::unique_ptr<game> state;
+		size_t position = 0;	// of the next decision in the record
+	};
+
+	replay_record record;
+	size_t checkpoint_interval;
+	action_reader reader;
+	replay_agent answers;
+	std::pmr::unsynchronized_pool_resource resource;
+	std::unique_ptr<game> current;
+	std::vector<checkpoint> checkpoints;	// the first is before the starting hands, checkpoint i at the start of turn i * checkpoint_interval + 1
+
+	/**
+	* checks if the game is between turns, where seek stops and checkpoints are kept
+	*
+	* @returns true between turns
+	**/
+	bool between_turns();
+
+	/**
+	* keep a copy of the game if it is at the start of the next checkpoint
+	**/
+	void save_checkpoint();
+};
+
+#endif //MTG_ENGINE_REPLAY_H
@@ -0,0 +1,103 @@
+// replay_main.cpp : replays games recorded by MTG_simulator --record, checks them or shows one of them
+//
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "replay.hpp"
+#include "binary_deck.hpp"
+#include "game.hpp"
+
+static void print_usage() {
+    std::cout << "usage: MTG_replay [--game INDEX [--turn TURN]] [--checkpoints TURNS] <deck1.ini|.mtgd> <deck2.ini|.mtgd> <replay>\n";
+}
+
+int main(int argc, char* argv[])
+{
+    size_t game_index = SIZE_MAX;
+    size_t turn = 0;
+    size_t checkpoint_interval = 8;
+    std::vector<std::string> args;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--game" && i + 1 < argc) {
+            game_index = std::stoul(argv[++i]);
+        } else if (arg == "--turn" && i + 1 < argc) {
+            turn = std::stoul(argv[++i]);
+        } else if (arg == "--checkpoints" && i + 1 < argc) {
+            checkpoint_interval = std::stoul(argv[++i]);
+        } else {
+            args.push_back(arg);
+        }
+    }
+    if (args.size() != 3) {
+        print_usage();
+        return 1;
+    }
+
+    try {
+        compiled_deck deck1 = load_deck(args[0]);
+        compiled_deck deck2 = load_deck(args[1]);
+        replay_file replays(args[2], deck_fingerprint(deck1, deck2));
+
+        if (game_index != SIZE_MAX) {
+            // one game: the whole game as it was played, or the state at the start of a turn
+            if (game_index >= replays.size()) {
+                std::cout << "the replay has " << replays.size() << " games\n";
+                return 1;
+            }
+            replay_record record = replays.get(game_index);
+            std::cout << "seed: " << record.seed << "\n";
+            if (turn == 0) {
+                game_replay replay(deck1, deck2, record, checkpoint_interval);
+                bool same = replay.run();
+                std::cout << "turns: " << replay.get_game().get_turn_number() << (same ? "" : " (differs from the recording)") << "\n";
+                return same ? 0 : 1;
+            }
+
+            std::ostream* previous_log = game_log_stream();
+            set_game_log(nullptr);
+            game_replay replay(deck1, deck2, record, checkpoint_interval);
+            bool reached = replay.seek(turn);
+            set_game_log(previous_log);
+            if (!reached) {
+                std::cout << "the game ended on turn " << replay.get_game().get_turn_number() << "\n";
+                return 1;
+            }
+            game& current = replay.get_game();
+            player* active = current.get_active_player();
+            player* non_active = current.get_non_active_player();
+            std::cout << "turn " << turn << ", " << active->get_damagable_name() << " is next\n";
+            std::cout << active->get_damagable_name() << " life: " << active->get_life() << "\n";
+            std::cout << non_active->get_damagable_name() << " life: " << non_active->get_life() << "\n";
+            non_active->print_battlefield();
+            active->display_hand();
+            active->print_battlefield();
+            return 0;
+        }
+
+        // every game, silently, as fast as they replay
+        std::ostream* previous_log = game_log_stream();
+        set_game_log(nullptr);
+        size_t differing = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < replays.size(); i++) {
+            game_replay replay(deck1, deck2, replays.get(i), 0);
+            if (!replay.run()) differing++;
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        set_game_log(previous_log);
+
+        std::cout << "games: " << replays.size() << "\n";
+        std::cout << "differing from the recording: " << differing << "\n";
+        std::cout << "bytes: " << replays.get_bytes() << "\n";
+        std::cout << "bytes per game: " << (replays.size() > 0 ? static_cast<double>(replays.get_bytes()) / replays.size() : 0.0) << "\n";
+        std::cout << "seconds: " << seconds << "\n";
+        std::cout << "games per second: " << (seconds > 0.0 ? replays.size() / seconds : 0.0) << "\n";
+        return differing == 0 ? 0 : 1;
+    } catch (const std::exception& e) {
+        std::cout << e.what() << "\n";
+        return 1;
+    }
+}
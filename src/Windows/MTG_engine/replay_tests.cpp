@@ -0,0 +1,48 @@
+// replay_tests.cpp : games recorded by the simulator against their replays
+//
+
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include "tests.hpp"
+#include "simulator.hpp"
+#include "replay.hpp"
+
+namespace {
+
+// games recorded by the simulator replay to the same end
+void test_replay(const compiled_deck& deck) {
+    const size_t n_of_games = 200;
+    std::string filename = (std::filesystem::temp_directory_path() / "MTG_tests.mtgr").string();
+    std::uint64_t fingerprint = deck_fingerprint(deck, deck);
+    random_agent agent1(1);
+    random_agent agent2(2);
+    simulation_result result;
+    {
+        replay_writer recorder(filename, fingerprint);
+        for (size_t i = 0; i < n_of_games; i++) {
+            simulator::play_game(deck, deck, agent1, agent2, mix_seed(11, i), result, &recorder);
+        }
+        check(recorder.get_games() == n_of_games, "the recorder counts every game");
+    }
+    {
+        replay_file replays(filename, fingerprint);
+        check(replays.size() == n_of_games, "the replay has every recorded game");
+        for (size_t i = 0; i < replays.size(); i++) {
+            game_replay replay(deck, deck, replays.get(i), 4);
+            check(replay.run(), "game " + std::to_string(i) + " replays differently");
+        }
+        if (replays.size() > 0) {
+            // seek back and forth through the checkpoints, then play the rest
+            game_replay replay(deck, deck, replays.get(0), 4);
+            replay.seek(9);
+            replay.seek(2);
+            check(replay.run(), "game 0 replays differently after seeking");
+        }
+    }
+    std::remove(filename.c_str());
+}
+
+const test_registration replay_test("replay", test_replay);
+
+}
@@ -0,0 +1,101 @@
+#include "simulator.hpp"
+#include "game.hpp"
+#include "arena.hpp"
+#include "batch_inference.hpp"
+#include "replay.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <deque>
+
+void simulator::play_game(const compiled_deck& deck1, const compiled_deck& deck2, agent& agent1, agent& agent2, std::uint64_t seed, simulation_result& result, replay_writer* recorder) {
+    game_arena& arena = game_arena::thread_local_arena();
+    // reused by the games of the thread, it keeps its capacity
+    thread_local action_log actions;
+    {
+        game game("Player 1", "Player 2", deck1.instantiate(arena.get_resource()), deck2.instantiate(arena.get_resource()), &agent1, &agent2, seed);
+        if (recorder != nullptr) {
+            actions.clear();
+            game.set_action_log(&actions);
+        }
+        game.set_event_publishing(event_log_enabled(EventLevel::GAME));
+        game.start_game();
+        while (!game.is_ended()) {
+            game.turn();
+        }
+        add_result(game, result);
+        if (recorder != nullptr) recorder->write_game(seed, replay_winner(game), game.get_turn_number(), actions);
+    }
+    // the game is destroyed, everything it allocated is freed at once
+    arena.reset();
+}
+
+void simulator::add_result(game& played, simulation_result& result) {
+    player* winner = played.get_winner();
+    if (winner == nullptr) {
+        result.draws++;
+    } else if (winner->get_damagable_name() == "Player 1") {
+        result.p1_wins++;
+    } else {
+        result.p2_wins++;
+    }
+    result.turns += played.get_turn_number();
+    result.games++;
+}
+
+simulation_result simulator::run(size_t n_of_games, agent& agent1, agent& agent2, std::uint64_t seed, replay_writer* recorder) const {
+    simulation_result result;
+    std::ostream* previous_log = game_log_stream();
+    set_game_log(nullptr);
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < n_of_games; i++) {
+        play_game(agent1, agent2, mix_seed(seed, i), result, recorder);
+    }
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    set_game_log(previous_log);
+    return result;
+}
+
+simulation_result simulator::run_batched(size_t n_of_games, size_t in_flight, batched_source& source, game_scheduler& scheduler, agent& agent1, agent& agent2, std::uint64_t seed, replay_writer* recorder) const {
+    simulation_result result;
+    std::ostream* previous_log = game_log_stream();
+    set_game_log(nullptr);
+    game_arena& arena = game_arena::thread_local_arena();
+    in_flight = std::max<size_t>(in_flight, 1);
+
+    auto start = std::chrono::steady_clock::now();
+    // the games are played in waves that share the arena, it is reset once the whole wave ended
+    for (size_t first = 0; first < n_of_games; first += in_flight) {
+        size_t wave = std::min(in_flight, n_of_games - first);
+        std::deque<game> games;
+        std::vector<game_task> tasks;
+        std::vector<action_log> logs(recorder != nullptr ? wave : 0);
+        tasks.reserve(wave);
+        for (size_t i = first; i < first + wave; i++) {
+            games.emplace_back("Player 1", "Player 2", deck1.instantiate(arena.get_resource()), deck2.instantiate(arena.get_resource()), &agent1, &agent2, mix_seed(seed, i));
+            if (recorder != nullptr) games.back().set_action_log(&logs[i - first]);
+            games.back().set_event_publishing(event_log_enabled(EventLevel::GAME));
+            tasks.push_back(::play_game(games.back(), &source));
+            scheduler.schedule(tasks.back().get_handle());
+        }
+        // every game runs until it ends or waits for the model, then the model decides for all the waiting ones
+        do {
+            scheduler.run();
+        } while (source.flush());
+
+        for (size_t i = 0; i < wave; i++) {
+            tasks[i].rethrow_if_failed();
+            add_result(games[i], result);
+            if (recorder != nullptr) recorder->write_game(mix_seed(seed, first + i), replay_winner(games[i]), games[i].get_turn_number(), logs[i]);
+        }
+        tasks.clear();
+        games.clear();
+        arena.reset();
+    }
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    set_game_log(previous_log);
+    return result;
+}
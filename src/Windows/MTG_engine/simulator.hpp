@@ -0,0 +1,111 @@
+#ifndef MTG_ENGINE_SIMULATOR_H
+#define MTG_ENGINE_SIMULATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include "deck.hpp"
+#include "agent.hpp"
+
+class game;
+class game_scheduler;
+class batched_source;
+class replay_writer;
+
+/**
+* results of a batch of simulated games
+**/
+struct simulation_result {
+	size_t games = 0;
+	size_t p1_wins = 0;
+	size_t p2_wins = 0;
+	size_t draws = 0;
+	size_t turns = 0;
+	double seconds = 0.0;
+
+	/**
+	* get the throughput of the batch
+	*
+	* @returns games per second
+	**/
+	double games_per_second() const {
+		return seconds > 0.0 ? static_cast<double>(games) / seconds : 0.0;
+	}
+};
+
+// plays whole games without console input or output, they publish events if an event_bus is installed
+class simulator
+{
+public:
+	/**
+	* simulator constructor
+	* @param deck1 deck of player 1
+	* @param deck2 deck of player 2
+	**/
+	simulator(compiled_deck deck1, compiled_deck deck2) : deck1(std::move(deck1)), deck2(std::move(deck2)) {}
+
+	/**
+	* plays one game from start_game until it ends
+	* does not touch game_log, the caller silences it
+	* @param deck1 deck of player 1
+	* @param deck2 deck of player 2
+	* @param agent1 agent deciding for player 1
+	* @param agent2 agent deciding for player 2
+	* @param seed seed of the game
+	* @param result result the game is added to
+	* @param recorder where the game is recorded, nullptr for nowhere
+	**/
+	static void play_game(const compiled_deck& deck1, const compiled_deck& deck2, agent& agent1, agent& agent2, std::uint64_t seed, simulation_result& result, replay_writer* recorder = nullptr);
+
+	/**
+	* plays one game between the decks of this simulator
+	* @param agent1 agent deciding for player 1
+	* @param agent2 agent deciding for player 2
+	* @param seed seed of the game
+	* @param result result the game is added to
+	* @param recorder where the game is recorded, nullptr for nowhere
+	**/
+	void play_game(agent& agent1, agent& agent2, std::uint64_t seed, simulation_result& result, replay_writer* recorder = nullptr) const {
+		play_game(deck1, deck2, agent1, agent2, seed, result, recorder);
+	}
+
+	/**
+	* plays n_of_games games, silently
+	* @param n_of_games number of games to play
+	* @param agent1 agent deciding for player 1
+	* @param agent2 agent deciding for player 2
+	* @param seed base seed, game i is seeded with mix_seed(seed, i)
+	* @param recorder where the games are recorded, nullptr for nowhere
+	*
+	* @returns the tally of the games and the time they took
+	**/
+	simulation_result run(size_t n_of_games, agent& agent1, agent& agent2, std::uint64_t seed, replay_writer* recorder = nullptr) const;
+
+	/**
+	* plays n_of_games games as coroutines (see play_game in game_task.hpp), in_flight of them at once, silently
+	* the decisions the source makes are batched over the games in flight, the batch is flushed when no game can go on
+	* @param n_of_games number of games to play
+	* @param in_flight number of games played at once
+	* @param source where the decisions come from, it schedules the games on scheduler
+	* @param scheduler resumes the games
+	* @param agent1 agent of player 1
+	* @param agent2 agent of player 2
+	* @param seed base seed, game i is seeded with mix_seed(seed, i)
+	* @param recorder where the games are recorded, in the order they were started, nullptr for nowhere
+	*
+	* @returns the tally of the games and the time they took
+	**/
+	simulation_result run_batched(size_t n_of_games, size_t in_flight, batched_source& source, game_scheduler& scheduler, agent& agent1, agent& agent2, std::uint64_t seed, replay_writer* recorder = nullptr) const;
+
+private:
+	compiled_deck deck1;
+	compiled_deck deck2;
+
+	/**
+	* add a finished game to a result
+	* @param played the game
+	* @param result the result
+	**/
+	static void add_result(game& played, simulation_result& result);
+};
+
+#endif //MTG_ENGINE_SIMULATOR_H
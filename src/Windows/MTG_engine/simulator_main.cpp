@@ -0,0 +1,146 @@
+// simulator_main.cpp : headless self-play of two decks, reports win rates and throughput
+//
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "simulator.hpp"
+#include "binary_deck.hpp"
+#include "mcts_agent.hpp"
+#include "batch_inference.hpp"
+#include "replay.hpp"
+#include "game_events.hpp"
+
+int main(int argc, char* argv[])
+{
+    std::uint64_t seed = random_seed();
+    size_t mcts_playouts = 0;
+    size_t mcts_threads = 1;
+    size_t batch_games = 0;
+    std::string record_file;
+    std::string events_file;
+    EventLevel event_level = EventLevel::TURN;
+    std::string event_format = "text";
+    std::vector<std::string> args;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--seed" && i + 1 < argc) {
+            seed = std::stoull(argv[++i]);
+        } else if (arg == "--mcts" && i + 1 < argc) {
+            mcts_playouts = std::stoul(argv[++i]);
+        } else if (arg == "--mcts-threads" && i + 1 < argc) {
+            mcts_threads = std::stoul(argv[++i]);
+        } else if (arg == "--batch" && i + 1 < argc) {
+            batch_games = std::stoul(argv[++i]);
+        } else if (arg == "--record" && i + 1 < argc) {
+            record_file = argv[++i];
+        } else if (arg == "--events" && i + 1 < argc) {
+            events_file = argv[++i];
+        } else if (arg == "--event-level" && i + 1 < argc) {
+            event_level = static_cast<EventLevel>(std::min<unsigned long>(std::stoul(argv[++i]), static_cast<unsigned long>(EventLevel::ZONE)));
+        } else if (arg == "--event-format" && i + 1 < argc) {
+            event_format = argv[++i];
+        } else {
+            args.push_back(arg);
+        }
+    }
+    if (args.size() < 2) {
+        std::cout << "usage: MTG_simulator [--seed SEED] [--mcts PLAYOUTS [--mcts-threads N] | --batch GAMES] [--record FILE] [--events FILE [--event-level 0-3] [--event-format text|json|null]] <deck1.ini|.mtgd> <deck2.ini|.mtgd> [number of games]\n";
+        return 1;
+    }
+    size_t n_of_games = (args.size() > 2) ? std::stoul(args[2]) : 1000;
+
+    simulation_result result;
+    mcts_stats search_stats;
+    size_t batches = 0;
+    std::uint64_t recorded_bytes = 0;
+    size_t events = 0;
+    size_t dropped_events = 0;
+    try {
+        // the games publish their events to a file if asked to, written on a thread of the bus
+        std::ofstream events_out;
+        std::unique_ptr<event_sink> sink;
+        std::unique_ptr<event_bus> bus;
+        if (!events_file.empty()) {
+            events_out.open(events_file);
+            if (!events_out) throw std::runtime_error("can't write events: " + events_file);
+            sink = make_event_sink(event_format, events_out);
+            bus = std::make_unique<event_bus>(*sink, event_level);
+        }
+        // player 1 searches with MCTS or is decided by the stub model in batches over many games if asked to,
+        // player 2 plays randomly
+        std::unique_ptr<agent> agent1;
+        if (mcts_playouts > 0) {
+            mcts_settings settings;
+            settings.playouts = mcts_playouts;
+            settings.n_of_threads = mcts_threads;
+            settings.seed = mix_seed(seed, 1);
+            agent1 = std::make_unique<mcts_agent>(settings);
+        } else {
+            agent1 = std::make_unique<random_agent>(mix_seed(seed, 1));
+        }
+        random_agent agent2(mix_seed(seed, 2));
+        compiled_deck deck1 = load_deck(args[0]);
+        compiled_deck deck2 = load_deck(args[1]);
+        // every game is recorded for MTG_replay if asked to
+        std::unique_ptr<replay_writer> recorder;
+        if (!record_file.empty()) {
+            recorder = std::make_unique<replay_writer>(record_file, deck_fingerprint(deck1, deck2));
+        }
+        simulator sim(std::move(deck1), std::move(deck2));
+        if (batch_games > 0) {
+            linear_evaluator model;
+            game_scheduler scheduler;
+            batched_source source(model, scheduler, agent1.get());
+            result = sim.run_batched(n_of_games, batch_games, source, scheduler, *agent1, agent2, seed, recorder.get());
+            batches = source.get_batches();
+        } else {
+            result = sim.run(n_of_games, *agent1, agent2, seed, recorder.get());
+        }
+        if (recorder) {
+            recorder->flush();
+            recorded_bytes = recorder->get_bytes();
+        }
+        if (bus) {
+            events = bus->get_published();
+            dropped_events = bus->get_dropped();
+            bus.reset();
+        }
+        if (auto* searcher = dynamic_cast<mcts_agent*>(agent1.get())) {
+            search_stats = searcher->get_stats();
+        }
+    } catch (const std::exception& e) {
+        std::cout << e.what() << "\n";
+        return 1;
+    }
+
+    std::cout << "seed: " << seed << "\n";
+    std::cout << "games: " << result.games << "\n";
+    std::cout << "player 1 wins: " << result.p1_wins << "\n";
+    std::cout << "player 2 wins: " << result.p2_wins << "\n";
+    std::cout << "draws: " << result.draws << "\n";
+    std::cout << "average turns: " << (result.games > 0 ? static_cast<double>(result.turns) / result.games : 0.0) << "\n";
+    std::cout << "seconds: " << result.seconds << "\n";
+    std::cout << "games per second: " << result.games_per_second() << "\n";
+    if (mcts_playouts > 0) {
+        std::cout << "mcts decisions: " << search_stats.decisions << "\n";
+        std::cout << "mcts playouts: " << search_stats.playouts << "\n";
+        std::cout << "mcts playouts per second: " << search_stats.playouts_per_second() << "\n";
+    }
+    if (batch_games > 0) {
+        std::cout << "batches: " << batches << "\n";
+    }
+    if (!events_file.empty()) {
+        std::cout << "events: " << events << "\n";
+        std::cout << "dropped events: " << dropped_events << "\n";
+    }
+    if (!record_file.empty()) {
+        std::cout << "recorded bytes: " << recorded_bytes << "\n";
+        std::cout << "recorded bytes per game: " << (result.games > 0 ? static_cast<double>(recorded_bytes) / result.games : 0.0) << "\n";
+    }
+    return 0;
+}
@@ -0,0 +1,76 @@
+// target_tests.cpp : replies to the target decision of an effect, a target of the wrong kind is rejected
+//
+
+#include <cstdio>
+#include <string>
+#include "tests.hpp"
+#include "agent.hpp"
+#include "card_catalog.hpp"
+#include "game.hpp"
+
+namespace {
+
+// a draw effect takes a player, a creature reply leaves the decision pending and a player reply resolves it
+void test_targets(const compiled_deck&) {
+    std::string path = write_deck("MTG_tests_targets.ini", {
+        "Name=Mountain\nType=land\nSubtype=Mountain\nColors=R\n",
+        "Name=Test Bear\nType=creature\nSubtype=Bear\nManaCost=R\nPower=2\nToughness=2\n",
+        "Name=Test Insight\nType=sorcery\nManaCost=R\nEffect=draw(1)\n" }, 14);
+    compiled_deck deck = load_deck(path);
+    std::remove(path.c_str());
+    card_id bear;
+    card_id insight;
+    check(card_catalog::global().find("Test Bear", bear) && card_catalog::global().find("Test Insight", insight), "the cards of the deck are in the catalog");
+
+    random_agent agent1(1);
+    random_agent agent2(2);
+    size_t replies = 0;
+    for (std::uint64_t seed = 0; seed < 50; seed++) {
+        game played("Player 1", "Player 2", deck.instantiate(), deck.instantiate(), &agent1, &agent2, seed);
+        while (!played.is_ended()) {
+            if (played.get_decision() != DecisionType::MAIN_PHASE) {
+                played.step();
+                continue;
+            }
+            player& me = *played.get_active_player();
+            player& opponent = *played.get_non_active_player();
+            bool bears = false;
+            for (size_t i = 0; i < me.get_battlefield().size(); i++) {
+                bears = bears || me.get_battlefield().get_id(i) == bear;
+            }
+            size_t hand_index = me.get_hand().size();
+            for (size_t i = 0; i < me.get_hand().size() && bears; i++) {
+                if (me.get_hand()[i] == insight && me.is_legal_move(move::cast(i), opponent)) {
+                    hand_index = i;
+                    break;
+                }
+            }
+            if (hand_index == me.get_hand().size()) {
+                played.step();
+                continue;
+            }
+
+            std::string name = "game " + std::to_string(seed) + ", turn " + std::to_string(played.get_turn_number());
+            played.step(move::cast(hand_index));
+            check(played.get_decision() == DecisionType::TARGET, name + ": the draw doesn't ask for its target");
+            size_t in_hand = me.get_hand().size();
+            bool library_empty = me.get_library().empty();
+            decision_reply reply;
+            reply.target = "me-Test Bear";
+            check(!played.step(reply), name + ": a creature is the target of a draw");
+            check(played.get_decision() == DecisionType::TARGET && me.is_resolving() && me.get_hand().size() == in_hand,
+                name + ": the rejected target doesn't leave the decision pending");
+            reply.target = "me";
+            check(played.step(reply), name + ": the player isn't the target of a draw");
+            // drawing from an empty library loses the game instead
+            check(!me.is_resolving() && (library_empty || me.get_hand().size() == in_hand + 1), name + ": the draw didn't resolve");
+            replies++;
+            if (!played.is_ended()) played.finish_turn();
+        }
+    }
+    check(replies > 0, "no draw was cast");
+}
+
+const test_registration targets_test("targets", test_targets);
+
+}
@@ -0,0 +1,40 @@
+#ifndef MTG_ENGINE_TESTS_H
+#define MTG_ENGINE_TESTS_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "binary_deck.hpp"
+
+// the checks of one part of the engine, run on the deck ctest passes to MTG_tests
+using test_body = void (*)(const compiled_deck& deck);
+
+// registers a test with MTG_tests, a test source keeps one per test as a static object
+struct test_registration
+{
+	/**
+	* test registration constructor
+	* @param name name of the test, the one given to MTG_tests and add_test
+	* @param body the checks
+	**/
+	test_registration(const std::string& name, test_body body);
+};
+
+/**
+* count a check, the failed ones are printed and fail the test
+* @param passed result of the check
+* @param what what failed
+**/
+void check(bool passed, const std::string& what);
+
+/**
+* write a deck file into the temporary directory
+* @param filename name of the file
+* @param sections the cards, INI sections without their [CardN] headers, each one copies times
+* @param copies copies of every section
+*
+* @returns path to the file
+**/
+std::string write_deck(const std::string& filename, const std::vector<std::string>& sections, size_t copies);
+
+#endif //MTG_ENGINE_TESTS_H
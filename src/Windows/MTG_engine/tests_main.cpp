@@ -0,0 +1,71 @@
+// tests_main.cpp : runs one of the tests of the engine registered in tests.hpp, as ctest does
+//
+
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+#include "tests.hpp"
+#include "game_log.hpp"
+
+namespace {
+
+// every check that fails is printed, a test passes if none failed
+size_t failures = 0;
+
+// filled by the static test_registration objects of the test sources, before main
+std::map<std::string, test_body>& tests() {
+    static std::map<std::string, test_body> registered;
+    return registered;
+}
+
+}
+
+test_registration::test_registration(const std::string& name, test_body body) {
+    tests().emplace(name, body);
+}
+
+void check(bool passed, const std::string& what) {
+    if (!passed) {
+        failures++;
+        std::cout << "failed: " << what << "\n";
+    }
+}
+
+std::string write_deck(const std::string& filename, const std::vector<std::string>& sections, size_t copies) {
+    std::string path = (std::filesystem::temp_directory_path() / filename).string();
+    std::ofstream out(path);
+    size_t n = 0;
+    for (const std::string& section : sections) {
+        for (size_t i = 0; i < copies; i++) {
+            out << "[Card" << ++n << "]\n" << section << "\n";
+        }
+    }
+    return path;
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc != 3 || tests().count(argv[1]) == 0) {
+        std::cout << "usage: MTG_tests <test> <deck.ini|.mtgd>\n";
+        std::cout << "tests:";
+        for (const auto& [name, body] : tests()) {
+            std::cout << " " << name;
+        }
+        std::cout << "\n";
+        return 1;
+    }
+
+    try {
+        set_game_log(nullptr);
+        compiled_deck deck = load_deck(argv[2]);
+        tests().at(argv[1])(deck);
+    } catch (const std::exception& e) {
+        std::cout << e.what() << "\n";
+        return 1;
+    }
+    std::cout << argv[1] << ": " << (failures == 0 ? "passed" : std::to_string(failures) + " checks failed") << "\n";
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,113 @@
+#include "thread_pool.hpp"
+
+#include <algorithm>
+
+/**
+* index of the worker running on this thread, size_t(-1) on threads outside any pool
+**/
+static thread_local size_t worker_index = static_cast<size_t>(-1);
+static thread_local const thread_pool* worker_pool = nullptr;
+
+thread_pool::thread_pool(size_t n_of_threads, std::function<void(size_t)> on_start) : on_start(std::move(on_start)) {
+    if (n_of_threads == 0) {
+        n_of_threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    }
+    for (size_t i = 0; i < n_of_threads; i++) {
+        queues.push_back(std::make_unique<worker_queue>());
+    }
+    for (size_t i = 0; i < n_of_threads; i++) {
+        workers.emplace_back(&thread_pool::worker_loop, this, i);
+    }
+}
+
+thread_pool::~thread_pool() {
+    {
+        std::unique_lock<std::mutex> lock(sleep_lock);
+        done.wait(lock, [this] { return unfinished.load() == 0; });
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto&& worker : workers) {
+        worker.join();
+    }
+}
+
+void thread_pool::submit(task new_task) {
+    size_t target = (worker_pool == this) ? worker_index : next_queue.fetch_add(1, std::memory_order_relaxed) % queues.size();
+    unfinished.fetch_add(1);
+    queued.fetch_add(1);
+    {
+        std::lock_guard<std::mutex> lock(queues[target]->lock);
+        queues[target]->tasks.push_back(std::move(new_task));
+    }
+    {
+        std::lock_guard<std::mutex> lock(sleep_lock);
+    }
+    wake.notify_one();
+}
+
+void thread_pool::wait() {
+    {
+        std::unique_lock<std::mutex> lock(sleep_lock);
+        done.wait(lock, [this] { return unfinished.load() == 0; });
+    }
+    std::lock_guard<std::mutex> lock(error_lock);
+    if (error) {
+        std::exception_ptr thrown = error;
+        error = nullptr;
+        std::rethrow_exception(thrown);
+    }
+}
+
+bool thread_pool::try_pop(size_t index, task& out) {
+    std::lock_guard<std::mutex> lock(queues[index]->lock);
+    if (queues[index]->tasks.empty()) return false;
+    out = std::move(queues[index]->tasks.back());
+    queues[index]->tasks.pop_back();
+    return true;
+}
+
+bool thread_pool::try_steal(size_t index, task& out) {
+    for (size_t i = 1; i < queues.size(); i++) {
+        worker_queue& victim = *queues[(index + i) % queues.size()];
+        std::lock_guard<std::mutex> lock(victim.lock);
+        if (!victim.tasks.empty()) {
+            out = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void thread_pool::run(task& current) {
+    queued.fetch_sub(1);
+    try {
+        current();
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(error_lock);
+        if (!error) error = std::current_exception();
+    }
+    current = nullptr;
+    if (unfinished.fetch_sub(1) == 1) {
+        std::lock_guard<std::mutex> lock(sleep_lock);
+        done.notify_all();
+    }
+}
+
+void thread_pool::worker_loop(size_t index) {
+    worker_index = index;
+    worker_pool = this;
+    if (on_start) on_start(index);
+
+    task current;
+    while (true) {
+        if (try_pop(index, current) || try_steal(index, current)) {
+            run(current);
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(sleep_lock);
+        wake.wait(lock, [this] { return stopping || queued.load() > 0; });
+        if (stopping && queued.load() == 0) return;
+    }
+}
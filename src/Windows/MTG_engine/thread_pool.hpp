@@ -0,0 +1,82 @@
+#ifndef MTG_ENGINE_THREAD_POOL_H
+#define MTG_ENGINE_THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// work-stealing pool, every worker has its own queue and steals from the others when it runs dry
+class thread_pool
+{
+public:
+	using task = std::function<void()>;
+
+	/**
+	* thread pool constructor, starts the workers
+	* @param n_of_threads number of workers, hardware concurrency if 0
+	* @param on_start called once on every worker thread with its index before it runs any task
+	**/
+	explicit thread_pool(size_t n_of_threads, std::function<void(size_t)> on_start = nullptr);
+
+	/**
+	* waits for the queued tasks and stops the workers
+	**/
+	~thread_pool();
+
+	thread_pool(const thread_pool&) = delete;
+	thread_pool& operator=(const thread_pool&) = delete;
+
+	/**
+	* queue a task, tasks submitted from a worker go to that worker's own queue
+	* @param new_task the task
+	**/
+	void submit(task new_task);
+
+	/**
+	* block until every submitted task finished
+	* rethrows the first exception thrown by a task
+	**/
+	void wait();
+
+	/**
+	* get the number of workers
+	*
+	* @returns number of workers
+	**/
+	size_t size() const { return workers.size(); }
+
+private:
+	struct worker_queue {
+		std::mutex lock;
+		std::deque<task> tasks;
+	};
+
+	std::vector<std::unique_ptr<worker_queue>> queues;
+	std::vector<std::thread> workers;
+	std::function<void(size_t)> on_start;
+
+	std::atomic<size_t> queued{0};
+	std::atomic<size_t> unfinished{0};
+	std::atomic<size_t> next_queue{0};
+
+	std::mutex sleep_lock;
+	std::condition_variable wake;
+	std::condition_variable done;
+	bool stopping = false;
+
+	std::mutex error_lock;
+	std::exception_ptr error;
+
+	void worker_loop(size_t index);
+	bool try_pop(size_t index, task& out);
+	bool try_steal(size_t index, task& out);
+	void run(task& current);
+};
+
+#endif //MTG_ENGINE_THREAD_POOL_H
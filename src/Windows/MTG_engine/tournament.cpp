@@ -0,0 +1,182 @@
+#include "tournament.hpp"
+#include "simulator.hpp"
+#include "game_log.hpp"
+#include "random.hpp"
+#include "binary_deck.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <filesystem>
+#include <map>
+#include <set>
+#include <stdexcept>
+
+tournament::tournament(const std::vector<std::string>& deck_files) {
+    for (auto&& file : deck_files) {
+        names.push_back(std::filesystem::path(file).stem().string());
+        decks.push_back(load_deck(file)); // interns the cards before games start on other threads
+    }
+}
+
+void tournament::queue_match(thread_pool& pool, size_t match_index, size_t games_per_match) {
+    match_result& match = *matches[match_index];
+    for (size_t i = 0; i < games_per_match; i++) {
+        // the seed depends only on the place of the game, not on the worker that plays it
+        std::uint64_t game_seed = mix_seed(mix_seed(seed, match_index), i);
+        pool.submit([this, &match, i, game_seed] {
+            random_agent agent_a(mix_seed(game_seed, 1));
+            random_agent agent_b(mix_seed(game_seed, 2));
+            simulation_result result;
+
+            // deck a is player 1 in even games, player 2 in odd ones
+            bool a_is_p1 = (i % 2 == 0);
+            if (a_is_p1) {
+                simulator::play_game(decks[match.deck_a], decks[match.deck_b], agent_a, agent_b, game_seed, result);
+            } else {
+                simulator::play_game(decks[match.deck_b], decks[match.deck_a], agent_b, agent_a, game_seed, result);
+            }
+
+            if (result.draws > 0) {
+                match.draws++;
+            } else if ((result.p1_wins > 0) == a_is_p1) {
+                match.a_wins++;
+            } else {
+                match.b_wins++;
+            }
+        });
+    }
+}
+
+void tournament::play_round_robin(thread_pool& pool, size_t games_per_match) {
+    for (size_t a = 0; a < decks.size(); a++) {
+        for (size_t b = a + 1; b < decks.size(); b++) {
+            matches.push_back(std::make_unique<match_result>(a, b));
+            queue_match(pool, matches.size() - 1, games_per_match);
+        }
+    }
+    pool.wait();
+}
+
+void tournament::play_swiss(thread_pool& pool, size_t games_per_match, size_t rounds) {
+    std::vector<size_t> points(decks.size(), 0);
+    std::set<std::pair<size_t, size_t>> played;
+
+    for (size_t round = 0; round < rounds; round++) {
+        std::vector<size_t> order(decks.size());
+        for (size_t i = 0; i < order.size(); i++) order[i] = i;
+        std::stable_sort(order.begin(), order.end(), [&points](size_t a, size_t b) { return points[a] > points[b]; });
+
+        // pair neighbours in the standings, avoiding rematches when possible
+        std::vector<bool> paired(decks.size(), false);
+        size_t first_match = matches.size();
+        for (size_t i = 0; i < order.size(); i++) {
+            size_t a = order[i];
+            if (paired[a]) continue;
+            size_t opponent = decks.size();
+            for (size_t j = i + 1; j < order.size(); j++) {
+                size_t b = order[j];
+                if (paired[b]) continue;
+                if (opponent == decks.size()) opponent = b;
+                if (!played.contains({std::min(a, b), std::max(a, b)})) {
+                    opponent = b;
+                    break;
+                }
+            }
+            paired[a] = true;
+            if (opponent == decks.size()) {
+                points[a] += 3; // bye
+                continue;
+            }
+            paired[opponent] = true;
+            played.insert({std::min(a, opponent), std::max(a, opponent)});
+            matches.push_back(std::make_unique<match_result>(a, opponent));
+        }
+
+        for (size_t m = first_match; m < matches.size(); m++) {
+            queue_match(pool, m, games_per_match);
+        }
+        pool.wait();
+
+        for (size_t m = first_match; m < matches.size(); m++) {
+            match_result& match = *matches[m];
+            if (match.a_wins > match.b_wins) {
+                points[match.deck_a] += 3;
+            } else if (match.b_wins > match.a_wins) {
+                points[match.deck_b] += 3;
+            } else {
+                points[match.deck_a] += 1;
+                points[match.deck_b] += 1;
+            }
+        }
+    }
+}
+
+void tournament::run(tournament_format format, size_t games_per_match, size_t rounds, size_t n_of_threads, std::uint64_t seed) {
+    this->seed = seed;
+    auto start = std::chrono::steady_clock::now();
+    {
+        thread_pool pool(n_of_threads, [](size_t) {
+            set_game_log(nullptr);
+        });
+        if (format == tournament_format::round_robin) {
+            play_round_robin(pool, games_per_match);
+        } else {
+            play_swiss(pool, games_per_match, rounds);
+        }
+    }
+    seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+size_t tournament::get_games() const {
+    size_t games = 0;
+    for (auto&& match : matches) {
+        games += match->games();
+    }
+    return games;
+}
+
+void tournament::write_results(std::ostream& out) const {
+    // the same pair can meet more than once in swiss
+    std::map<std::pair<size_t, size_t>, std::array<size_t, 3>> pairs;
+    for (auto&& match : matches) {
+        bool swapped = match->deck_a > match->deck_b;
+        auto& totals = pairs[{std::min(match->deck_a, match->deck_b), std::max(match->deck_a, match->deck_b)}];
+        totals[0] += swapped ? match->b_wins : match->a_wins;
+        totals[1] += swapped ? match->a_wins : match->b_wins;
+        totals[2] += match->draws;
+    }
+
+    out << "deck_a,deck_b,games,deck_a_wins,deck_b_wins,draws,deck_a_win_rate\n";
+    for (auto&& [pair, totals] : pairs) {
+        size_t games = totals[0] + totals[1] + totals[2];
+        out << names[pair.first] << "," << names[pair.second] << "," << games << ","
+            << totals[0] << "," << totals[1] << "," << totals[2] << ","
+            << (games > 0 ? static_cast<double>(totals[0]) / games : 0.0) << "\n";
+    }
+}
+
+void tournament::write_standings(std::ostream& out) const {
+    std::vector<std::array<size_t, 3>> records(decks.size(), {0, 0, 0}); // wins, losses, draws
+    for (auto&& match : matches) {
+        records[match->deck_a][0] += match->a_wins;
+        records[match->deck_a][1] += match->b_wins;
+        records[match->deck_a][2] += match->draws;
+        records[match->deck_b][0] += match->b_wins;
+        records[match->deck_b][1] += match->a_wins;
+        records[match->deck_b][2] += match->draws;
+    }
+
+    auto win_rate = [&records](size_t deck) {
+        size_t games = records[deck][0] + records[deck][1] + records[deck][2];
+        return games > 0 ? static_cast<double>(records[deck][0]) / games : 0.0;
+    };
+    std::vector<size_t> order(decks.size());
+    for (size_t i = 0; i < order.size(); i++) order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&win_rate](size_t a, size_t b) { return win_rate(a) > win_rate(b); });
+
+    for (auto&& deck : order) {
+        out << names[deck] << ": " << records[deck][0] << "-" << records[deck][1] << "-" << records[deck][2]
+            << " (" << win_rate(deck) * 100.0 << "%)\n";
+    }
+}
@@ -0,0 +1,96 @@
+#ifndef MTG_ENGINE_TOURNAMENT_H
+#define MTG_ENGINE_TOURNAMENT_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "deck.hpp"
+#include "thread_pool.hpp"
+
+enum class tournament_format {
+	round_robin,
+	swiss
+};
+
+/**
+* games played between two decks in one match, updated concurrently by the workers
+**/
+struct match_result {
+	size_t deck_a;
+	size_t deck_b;
+	std::atomic<size_t> a_wins{0};
+	std::atomic<size_t> b_wins{0};
+	std::atomic<size_t> draws{0};
+
+	match_result(size_t deck_a, size_t deck_b) : deck_a(deck_a), deck_b(deck_b) {}
+
+	/**
+	* get the number of finished games
+	*
+	* @returns number of games
+	**/
+	size_t games() const { return a_wins + b_wins + draws; }
+};
+
+// plays matches between many decks, every game of every match is a separate task of a thread pool
+class tournament
+{
+public:
+	/**
+	* tournament constructor, loads the decks
+	* @param deck_files paths to the deck INI or binary deck files
+	**/
+	explicit tournament(const std::vector<std::string>& deck_files);
+
+	/**
+	* play the whole tournament
+	* @param format round robin (every deck against every other deck) or swiss
+	* @param games_per_match games in one match, the decks alternate seats
+	* @param rounds number of swiss rounds, ignored for round robin
+	* @param n_of_threads number of workers, hardware concurrency if 0
+	* @param seed base seed, every game gets its own seed derived from it and its place in the tournament
+	**/
+	void run(tournament_format format, size_t games_per_match, size_t rounds, size_t n_of_threads, std::uint64_t seed);
+
+	/**
+	* write the aggregate results of every deck pair as CSV
+	* @param out the stream to write to
+	**/
+	void write_results(std::ostream& out) const;
+
+	/**
+	* write the standings of every deck as text
+	* @param out the stream to write to
+	**/
+	void write_standings(std::ostream& out) const;
+
+	/**
+	* get the number of games played
+	*
+	* @returns number of games
+	**/
+	size_t get_games() const;
+
+	/**
+	* get the wall-clock time the tournament took
+	*
+	* @returns seconds
+	**/
+	double get_seconds() const { return seconds; }
+
+private:
+	std::vector<std::string> names;
+	std::vector<compiled_deck> decks;
+	std::vector<std::unique_ptr<match_result>> matches;
+	double seconds = 0.0;
+	std::uint64_t seed = 0;
+
+	void queue_match(thread_pool& pool, size_t match_index, size_t games_per_match);
+	void play_round_robin(thread_pool& pool, size_t games_per_match);
+	void play_swiss(thread_pool& pool, size_t games_per_match, size_t rounds);
+};
+
+#endif //MTG_ENGINE_TOURNAMENT_H
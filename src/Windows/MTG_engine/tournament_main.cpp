@@ -0,0 +1,98 @@
+// tournament_main.cpp : plays round robin or swiss tournaments between decks on all cores
+//
+
+#include <algorithm>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "tournament.hpp"
+#include "game_events.hpp"
+
+static void print_usage() {
+    std::cout << "usage: MTG_tournament [--swiss ROUNDS] [--games GAMES_PER_MATCH] [--threads THREADS]\n"
+              << "                      [--seed SEED] [--output RESULTS.csv]\n"
+              << "                      [--events FILE [--event-level 0-3] [--event-format text|json|null]] <deck> <deck> [deck...]\n";
+}
+
+int main(int argc, char* argv[])
+{
+    tournament_format format = tournament_format::round_robin;
+    size_t rounds = 0;
+    size_t games_per_match = 100;
+    size_t n_of_threads = 0;
+    std::uint64_t seed = 1;
+    std::string output;
+    std::string events_file;
+    EventLevel event_level = EventLevel::TURN;
+    std::string event_format = "text";
+    std::vector<std::string> deck_files;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--swiss" && i + 1 < argc) {
+            format = tournament_format::swiss;
+            rounds = std::stoul(argv[++i]);
+        } else if (arg == "--games" && i + 1 < argc) {
+            games_per_match = std::stoul(argv[++i]);
+        } else if (arg == "--threads" && i + 1 < argc) {
+            n_of_threads = std::stoul(argv[++i]);
+        } else if (arg == "--seed" && i + 1 < argc) {
+            seed = std::stoull(argv[++i]);
+        } else if (arg == "--output" && i + 1 < argc) {
+            output = argv[++i];
+        } else if (arg == "--events" && i + 1 < argc) {
+            events_file = argv[++i];
+        } else if (arg == "--event-level" && i + 1 < argc) {
+            event_level = static_cast<EventLevel>(std::min<unsigned long>(std::stoul(argv[++i]), static_cast<unsigned long>(EventLevel::ZONE)));
+        } else if (arg == "--event-format" && i + 1 < argc) {
+            event_format = argv[++i];
+        } else if (arg.rfind("--", 0) == 0) {
+            print_usage();
+            return 1;
+        } else {
+            deck_files.push_back(arg);
+        }
+    }
+    if (deck_files.size() < 2) {
+        print_usage();
+        return 1;
+    }
+
+    try {
+        tournament tour(deck_files);
+        // the games of all threads publish to one bus if asked to, it is destroyed once they ended
+        std::ofstream events_out;
+        std::unique_ptr<event_sink> sink;
+        std::unique_ptr<event_bus> bus;
+        if (!events_file.empty()) {
+            events_out.open(events_file);
+            if (!events_out) throw std::runtime_error("can't write events: " + events_file);
+            sink = make_event_sink(event_format, events_out);
+            bus = std::make_unique<event_bus>(*sink, event_level);
+        }
+        tour.run(format, games_per_match, rounds, n_of_threads, seed);
+        if (bus) {
+            size_t dropped_events = bus->get_dropped();
+            bus.reset();
+            if (dropped_events > 0) std::cout << "dropped events: " << dropped_events << "\n";
+        }
+
+        tour.write_standings(std::cout);
+        if (output.empty()) {
+            tour.write_results(std::cout);
+        } else {
+            std::ofstream file(output);
+            tour.write_results(file);
+        }
+        std::cout << "games: " << tour.get_games() << "\n";
+        std::cout << "seconds: " << tour.get_seconds() << "\n";
+        std::cout << "games per second: " << (tour.get_seconds() > 0.0 ? tour.get_games() / tour.get_seconds() : 0.0) << "\n";
+    } catch (const std::exception& e) {
+        std::cout << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
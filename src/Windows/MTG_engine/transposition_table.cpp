@@ -0,0 +1,45 @@
+#include "transposition_table.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+transposition_table::transposition_table(size_t log2_entries)
+    : entries(std::make_unique<std::atomic<std::uint64_t>[]>(size_t{ 1 } << log2_entries)), mask((size_t{ 1 } << log2_entries) - 1) {
+    clear();
+}
+
+void transposition_table::clear() {
+    for (size_t i = 0; i <= mask; i++) {
+        entries[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+void transposition_table::add(std::uint64_t key, double score) {
+    std::atomic<std::uint64_t>& entry = entries[key & mask];
+    std::uint64_t steps = static_cast<std::uint64_t>(std::lround(std::clamp(score, 0.0, 1.0) * SCORE_STEPS));
+    std::uint64_t check = check_of(key) << (VISIT_BITS + SCORE_BITS);
+    std::uint64_t one_visit = std::uint64_t{ 1 } << SCORE_BITS;
+
+    std::uint64_t old_word = entry.load(std::memory_order_relaxed);
+    while (true) {
+        std::uint64_t visits = (old_word >> SCORE_BITS) & MAX_VISITS;
+        std::uint64_t new_word;
+        if ((old_word & ~((std::uint64_t{ 1 } << (VISIT_BITS + SCORE_BITS)) - 1)) == check && visits > 0) {
+            // the score can't overflow before the visits, every visit adds at most SCORE_STEPS
+            if (visits == MAX_VISITS) return;
+            new_word = old_word + one_visit + steps;
+        } else {
+            new_word = check | one_visit | steps;
+        }
+        if (entry.compare_exchange_weak(old_word, new_word, std::memory_order_relaxed)) return;
+    }
+}
+
+bool transposition_table::find(std::uint64_t key, stats& found) const {
+    std::uint64_t word = entries[key & mask].load(std::memory_order_relaxed);
+    std::uint64_t visits = (word >> SCORE_BITS) & MAX_VISITS;
+    if (visits == 0 || (word >> (VISIT_BITS + SCORE_BITS)) != check_of(key)) return false;
+    found.visits = static_cast<std::uint32_t>(visits);
+    found.score = static_cast<double>(word & ((std::uint64_t{ 1 } << SCORE_BITS) - 1)) / SCORE_STEPS;
+    return true;
+}
@@ -0,0 +1,79 @@
+#ifndef MTG_ENGINE_TRANSPOSITION_TABLE_H
+#define MTG_ENGINE_TRANSPOSITION_TABLE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// results of playouts per position, keyed by zobrist hashes (see game::hash), shared by the threads of a search
+// so a position reached by different orders of moves adds up the results of all of them
+// every entry is one 64 bit word changed with compare and swap: the top bits of the hash, the visits and the score,
+// so threads never lock and never see half of an entry
+// a position replaces the one in its entry, the results of a replaced position are lost
+class transposition_table
+{
+public:
+	static constexpr size_t DEFAULT_LOG2_ENTRIES = 16;
+
+	struct stats {
+		std::uint32_t visits = 0;
+		double score = 0;
+	};
+
+	/**
+	* transposition table constructor, all entries are empty
+	* @param log2_entries the table has 2^log2_entries entries
+	**/
+	explicit transposition_table(size_t log2_entries = DEFAULT_LOG2_ENTRIES);
+
+	transposition_table(const transposition_table&) = delete;
+	transposition_table& operator=(const transposition_table&) = delete;
+
+	/**
+	* empty every entry, not safe while other threads use the table
+	**/
+	void clear();
+
+	/**
+	* add the result of one playout through a position, results of a position with MAX_VISITS visits are dropped
+	* @param key hash of the position
+	* @param score the result, between 0 and 1
+	**/
+	void add(std::uint64_t key, double score);
+
+	/**
+	* look up the results of a position
+	* @param key hash of the position
+	* @param found the results
+	*
+	* @returns true if the position has results
+	**/
+	bool find(std::uint64_t key, stats& found) const;
+
+	/**
+	* get the number of entries
+	*
+	* @returns number of entries
+	**/
+	size_t size() const {
+		return mask + 1;
+	}
+
+private:
+	// layout of an entry from the top: check bits of the hash, visits, score in steps of 1 / SCORE_STEPS
+	static constexpr unsigned CHECK_BITS = 16;
+	static constexpr unsigned VISIT_BITS = 20;
+	static constexpr unsigned SCORE_BITS = 28;
+	static constexpr std::uint64_t SCORE_STEPS = 256;
+	static constexpr std::uint64_t MAX_VISITS = (std::uint64_t{ 1 } << VISIT_BITS) - 1;
+
+	std::unique_ptr<std::atomic<std::uint64_t>[]> entries;
+	size_t mask;
+
+	static std::uint64_t check_of(std::uint64_t key) {
+		return key >> (64 - CHECK_BITS);
+	}
+};
+
+#endif //MTG_ENGINE_TRANSPOSITION_TABLE_H
@@ -5,6 +5,8 @@
 #ifndef MTG_ENGINE_TYPES_H
 #define MTG_ENGINE_TYPES_H
 
+#include <string_view>
+
 enum class CardType {
     CREATURE,
     ARTIFACT,
@@ -14,4 +16,47 @@ enum class CardType {
     SORCERY
 };
 
+/**
+* converts the Type of a card in a deck file to a CardType
+*
+* @param type_string the string to convert (e.g. "creature")
+*
+* @returns the card type
+**/
+inline CardType string_to_card_type(std::string_view type_string) {
+    if (type_string == "creature") return CardType::CREATURE;
+    if (type_string == "artifact") return CardType::ARTIFACT;
+    if (type_string == "enchantment") return CardType::ENCHANTMENT;
+    if (type_string == "land") return CardType::LAND;
+    if (type_string == "instant") return CardType::INSTANT;
+    if (type_string == "sorcery") return CardType::SORCERY;
+    throw ("invalid card type string");
+}
+
+/**
+* converts a CardType to the string used in deck files and printouts
+*
+* @param type the card type to convert
+*
+* @returns the string
+**/
+inline const char* card_type_to_string(CardType type) {
+    switch (type) {
+        case CardType::CREATURE:
+            return "creature";
+        case CardType::ARTIFACT:
+            return "artifact";
+        case CardType::ENCHANTMENT:
+            return "enchantment";
+        case CardType::LAND:
+            return "land";
+        case CardType::INSTANT:
+            return "instant";
+        case CardType::SORCERY:
+            return "sorcery";
+        default:
+            throw "NOT A VALID CARD TYPE";
+    }
+}
+
 #endif //MTG_ENGINE_TYPES_H
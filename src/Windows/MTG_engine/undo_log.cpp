@@ -0,0 +1,134 @@
+#include "undo_log.hpp"
+#include "game.hpp"
+
+undo_log::undo_log(std::pmr::memory_resource* resource) : resource(resource) {}
+
+undo_log::~undo_log() = default;
+
+void undo_log::mark() {
+    marks.push_back(entries.size());
+}
+
+void undo_log::undo() {
+    if (marks.empty()) return;
+    size_t first = marks.back();
+    marks.pop_back();
+
+    // newest first, so a part saved at several levels ends up as it was at the mark
+    while (entries.size() > first) {
+        entry& saved = entries.back();
+        switch (saved.type) {
+            case EntryType::PLAYER_COUNTERS: {
+                player& target = *static_cast<player*>(saved.target);
+                const player_counters& counters = players[saved.slot];
+                target.life = counters.life;
+                target.played_land = counters.played_land;
+                target.mana_pool = counters.mana_pool;
+                target.library_hash = counters.library_hash;
+                target.graveyard_hash = counters.graveyard_hash;
+                target.hand_hash = counters.hand_hash;
+                target.resolving = counters.resolving;
+                target.resolving_spell = counters.resolving_spell;
+                target.next_effect = counters.next_effect;
+                target.resolving_target = counters.resolving_target;
+                target.resolving_creature = counters.resolving_creature;
+                target.discards_left = counters.discards_left;
+                players_used--;
+                break;
+            }
+            case EntryType::CARD_ZONE:
+                *static_cast<std::pmr::vector<card_id>*>(saved.target) = card_zones[saved.slot];
+                card_zones_used--;
+                break;
+            case EntryType::BATTLEFIELD:
+                static_cast<battlefield_zone*>(saved.target)->assign(battlefields[saved.slot]);
+                battlefields_used--;
+                break;
+            case EntryType::GAME_COUNTERS: {
+                game& target = *static_cast<game*>(saved.target);
+                const game_counters& counters = games[saved.slot];
+                target.ended = counters.ended;
+                target.turn_number = counters.turn_number;
+                target.active_player = counters.p1_active ? &target.p1 : &target.p2;
+                target.non_active_player = counters.p1_active ? &target.p2 : &target.p1;
+                target.current_phase = counters.current_phase;
+                target.pending = counters.pending;
+                target.started = counters.started;
+                target.p1_kept_hand = counters.p1_kept_hand;
+                target.declared_attackers = counters.declared_attackers;
+                target.declared_blocks = counters.declared_blocks;
+                target.ordered_attacker = counters.ordered_attacker;
+                target.unblocked_damage = counters.unblocked_damage;
+                target.rng = counters.rng;
+                games_used--;
+                break;
+            }
+        }
+        entries.pop_back();
+    }
+}
+
+void undo_log::commit() {
+    if (!marks.empty()) marks.pop_back();
+}
+
+bool undo_log::saved_since_mark(EntryType type, const void* target) const {
+    for (size_t i = marks.back(); i < entries.size(); i++) {
+        if (entries[i].target == target && entries[i].type == type) return true;
+    }
+    return false;
+}
+
+void undo_log::save_counters(player& target) {
+    if (marks.empty() || saved_since_mark(EntryType::PLAYER_COUNTERS, &target)) return;
+    player_counters counters{ target.life, target.played_land, target.mana_pool, target.library_hash, target.graveyard_hash, target.hand_hash,
+        target.resolving, target.resolving_spell, target.next_effect, target.resolving_target, target.resolving_creature, target.discards_left };
+    if (players_used == players.size()) {
+        players.push_back(counters);
+    } else {
+        players[players_used] = counters;
+    }
+    entries.push_back(entry{ EntryType::PLAYER_COUNTERS, &target, players_used++ });
+}
+
+void undo_log::save_zone(std::pmr::vector<card_id>& target) {
+    if (marks.empty() || saved_since_mark(EntryType::CARD_ZONE, &target)) return;
+    if (card_zones_used == card_zones.size()) {
+        card_zones.emplace_back(target, resource);
+    } else {
+        card_zones[card_zones_used] = target;
+    }
+    entries.push_back(entry{ EntryType::CARD_ZONE, &target, card_zones_used++ });
+}
+
+void undo_log::save_zone(battlefield_zone& target) {
+    if (marks.empty() || saved_since_mark(EntryType::BATTLEFIELD, &target)) return;
+    if (battlefields_used == battlefields.size()) {
+        battlefields.emplace_back(target, resource);
+    } else {
+        battlefields[battlefields_used].assign(target);
+    }
+    entries.push_back(entry{ EntryType::BATTLEFIELD, &target, battlefields_used++ });
+}
+
+void undo_log::save_counters(game& target) {
+    if (marks.empty() || saved_since_mark(EntryType::GAME_COUNTERS, &target)) return;
+    if (games_used == games.size()) {
+        games.emplace_back();
+    }
+    // assigned field by field so the attackers and blocks keep their buffers
+    game_counters& counters = games[games_used];
+    counters.ended = target.ended;
+    counters.turn_number = target.turn_number;
+    counters.p1_active = target.active_player == &target.p1;
+    counters.current_phase = target.current_phase;
+    counters.pending = target.pending;
+    counters.started = target.started;
+    counters.p1_kept_hand = target.p1_kept_hand;
+    counters.declared_attackers = target.declared_attackers;
+    counters.declared_blocks = target.declared_blocks;
+    counters.ordered_attacker = target.ordered_attacker;
+    counters.unblocked_damage = target.unblocked_damage;
+    counters.rng = target.rng;
+    entries.push_back(entry{ EntryType::GAME_COUNTERS, &target, games_used++ });
+}
@@ -0,0 +1,129 @@
+#ifndef MTG_ENGINE_UNDO_LOG_H
+#define MTG_ENGINE_UNDO_LOG_H
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory_resource>
+#include <vector>
+#include "card_catalog.hpp"
+#include "mana.hpp"
+#include "move.hpp"
+#include "permanent_handle.hpp"
+#include "phase.hpp"
+#include "random.hpp"
+
+class player;
+class game;
+class battlefield_zone;
+enum class DecisionType : std::uint8_t;
+
+// reverts a game to an earlier point for apply-and-revert search (see game::set_undo_log)
+// the state tells the log before it changes a part of itself (the counters of a player or of the game, a zone),
+// the first change of a part after a mark saves a copy of that part, undo copies the saved parts back
+// a move changes few parts, so it costs a few small copies, and the copies go into buffers the log keeps for the next marks
+class undo_log
+{
+public:
+	/**
+	* undo log constructor
+	* @param resource memory resource of the saved copies
+	**/
+	explicit undo_log(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+	~undo_log();
+
+	undo_log(const undo_log&) = delete;
+	undo_log& operator=(const undo_log&) = delete;
+
+	/**
+	* start a new level, undo reverts everything that changes after it, levels nest
+	**/
+	void mark();
+
+	/**
+	* revert everything changed since the last mark and remove the mark
+	**/
+	void undo();
+
+	/**
+	* keep everything changed since the last mark and remove the mark, the changes belong to the level before
+	**/
+	void commit();
+
+	/**
+	* get the number of marks that were not undone or committed
+	*
+	* @returns number of marks
+	**/
+	size_t depth() const {
+		return marks.size();
+	}
+
+	/**
+	* save a part of the state before it changes, called by the state itself
+	* nothing is saved outside of a mark or if the part was saved since the last mark
+	**/
+	void save_counters(player& target);
+	void save_zone(std::pmr::vector<card_id>& target);
+	void save_zone(battlefield_zone& target);
+	void save_counters(game& target);
+
+private:
+	enum class EntryType : std::uint8_t { PLAYER_COUNTERS, CARD_ZONE, BATTLEFIELD, GAME_COUNTERS };
+
+	struct entry {
+		EntryType type;
+		void* target;
+		size_t slot;
+	};
+
+	struct player_counters {
+		int life;
+		bool played_land;
+		mana mana_pool;
+		std::uint64_t library_hash;
+		std::uint64_t graveyard_hash;
+		std::uint64_t hand_hash;
+		bool resolving;
+		card_id resolving_spell;
+		size_t next_effect;
+		MoveTarget resolving_target;
+		permanent_handle resolving_creature;
+		size_t discards_left;
+	};
+
+	struct game_counters {
+		bool ended;
+		size_t turn_number;
+		bool p1_active;
+		phase current_phase;
+		DecisionType pending;
+		bool started;
+		bool p1_kept_hand;
+		std::vector<size_t> declared_attackers;
+		std::map<size_t, std::vector<size_t>> declared_blocks;
+		size_t ordered_attacker;
+		int unblocked_damage;
+		game_rng rng;
+	};
+
+	std::pmr::memory_resource* resource;
+
+	std::vector<entry> entries;
+	std::vector<size_t> marks;
+
+	// saved copies, the copies of the entries from the last mark are at the top, the rest is kept for reuse
+	std::vector<player_counters> players;
+	std::vector<game_counters> games;
+	std::vector<std::pmr::vector<card_id>> card_zones;
+	std::vector<battlefield_zone> battlefields;
+	size_t players_used = 0;
+	size_t games_used = 0;
+	size_t card_zones_used = 0;
+	size_t battlefields_used = 0;
+
+	// the same address can be two parts (a game and its first player), so the type is compared too
+	bool saved_since_mark(EntryType type, const void* target) const;
+};
+
+#endif //MTG_ENGINE_UNDO_LOG_H
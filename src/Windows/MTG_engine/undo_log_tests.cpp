@@ -0,0 +1,46 @@
+// undo_log_tests.cpp : the undo log against copies of the game
+//
+
+#include <string>
+#include "tests.hpp"
+#include "undo_log.hpp"
+#include "arena.hpp"
+#include "game.hpp"
+
+namespace {
+
+// undoing two turns gives back the game copied before them, at every turn of self-play games
+void test_undo_log(const compiled_deck& deck) {
+    random_agent agent1(1);
+    random_agent agent2(2);
+    game_arena& arena = game_arena::thread_local_arena();
+    game_arena scratch;
+    for (std::uint64_t seed = 0; seed < 100; seed++) {
+        {
+            game played("Player 1", "Player 2", deck.instantiate(arena.get_resource()), deck.instantiate(arena.get_resource()), &agent1, &agent2, seed);
+            played.start_game();
+            undo_log log;
+            played.set_undo_log(&log);
+            while (!played.is_ended()) {
+                {
+                    game copy(played, scratch.get_resource());
+                    log.mark();
+                    played.turn();
+                    if (!played.is_ended()) played.turn();
+                    log.undo();
+                    std::string name = "game " + std::to_string(seed) + ", turn " + std::to_string(copy.get_turn_number());
+                    check(played.hash() == copy.hash() && played.get_turn_number() == copy.get_turn_number()
+                        && played.get_active_player()->get_life() == copy.get_active_player()->get_life()
+                        && played.get_non_active_player()->get_life() == copy.get_non_active_player()->get_life(), name + ": undo differs from the copy");
+                }
+                scratch.reset();
+                played.turn();
+            }
+        }
+        arena.reset();
+    }
+}
+
+const test_registration undo_log_test("undo_log", test_undo_log);
+
+}
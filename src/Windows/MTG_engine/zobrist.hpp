@@ -0,0 +1,58 @@
+#ifndef MTG_ENGINE_ZOBRIST_H
+#define MTG_ENGINE_ZOBRIST_H
+
+#include <cstdint>
+
+// parts of a game state that have a zobrist key (see zobrist_key)
+enum class zobrist_part : std::uint8_t {
+	LIBRARY,		// a card and its position from the bottom of the library
+	HAND,			// a card in the hand
+	GRAVEYARD,		// a card in the graveyard
+	PERMANENT,		// a card on the battlefield with its tapped flag, summoning sickness and health
+	LIFE,
+	MANA_POOL,
+	PLAYED_LAND,
+	HAND_SIZE,
+	LIBRARY_SIZE,
+	ACTIVE,			// the hash of the active player
+	NON_ACTIVE,		// the hash of the non-active player
+	PHASE,
+	ENDED,
+	ATTACKER,		// a declared attacker and its position in the declaration
+	BLOCK,			// an attacker and one of its blockers, with the position of the blocker in the damage order
+	ORDERED_ATTACKER,	// the attacker whose blocks are resolved next, with the unblocked damage so far
+	KEPT_HAND,		// player 1 kept their hand and player 2 decides about a mulligan
+	RESOLVING,		// the spell whose effects resolve and its next effect
+	RESOLVING_TARGET,	// the target of the resolving spell, with the handle of a creature target
+	DISCARDS_LEFT	// cards a player still has to choose for a discard
+};
+
+/**
+* the last step of splitmix64, spreads every bit of the input over the output
+* @param x input
+*
+* @returns mixed bits
+**/
+constexpr std::uint64_t zobrist_mix(std::uint64_t x) {
+	x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+	return x ^ (x >> 31);
+}
+
+/**
+* get the zobrist key of a part of a game state
+* a state hashes to the sum of the keys of its parts, so a part that changes updates the hash by subtracting its old key
+* and adding the new one, and equal cards in a zone don't cancel out as they would with xor
+* the keys are computed from the part instead of looked up in a table of random numbers, so there is no limit on the
+* number of cards or on life totals
+* @param part which part
+* @param value the card, the amount, ...
+* @param detail the position or the state of the card, 0 for parts without one
+*
+* @returns the key
+**/
+constexpr std::uint64_t zobrist_key(zobrist_part part, std::uint64_t value, std::uint64_t detail = 0) {
+	return zobrist_mix(zobrist_mix((static_cast<std::uint64_t>(part) + 1) * 0x9e3779b97f4a7c15ULL + value) + detail);
+}
+
+#endif //MTG_ENGINE_ZOBRIST_H
@@ -0,0 +1,313 @@
+#ifndef MTG_ENGINE_ZONE_H
+#define MTG_ENGINE_ZONE_H
+
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+#include "card_catalog.hpp"
+#include "permanent_handle.hpp"
+#include "undo_log.hpp"
+#include "zobrist.hpp"
+
+// permanents on the battlefield of a player, stored as structure of arrays
+// the state the game loops over (untap, heal, check deaths, combat) is in packed arrays indexed by position,
+// positions change when a permanent leaves (the last one takes its place), handles do not
+// the zone keeps the zobrist hash of its permanents up to date, the order of the permanents doesn't change it
+class battlefield_zone
+{
+public:
+	static constexpr std::uint8_t TAPPED = 1 << 0;
+	static constexpr std::uint8_t SUMMONING_SICKNESS = 1 << 1;
+	static constexpr std::uint8_t DEAD = 1 << 2;
+
+	/**
+	* battlefield zone constructor
+	* @param resource memory resource of the game (see game_arena)
+	**/
+	explicit battlefield_zone(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+		: ids(resource), types(resource), flags(resource), power(resource), toughness(resource), health(resource), slots(resource),
+		slot_positions(resource), slot_generations(resource), free_slots(resource) {}
+
+	/**
+	* copy a battlefield into another memory resource, the copy has no undo log
+	* @param other the battlefield to copy
+	* @param resource memory resource of the copy
+	**/
+	battlefield_zone(const battlefield_zone& other, std::pmr::memory_resource* resource)
+		: ids(other.ids, resource), types(other.types, resource), flags(other.flags, resource), power(other.power, resource),
+		toughness(other.toughness, resource), health(other.health, resource), slots(other.slots, resource),
+		slot_positions(other.slot_positions, resource), slot_generations(other.slot_generations, resource), free_slots(other.free_slots, resource),
+		state_hash(other.state_hash) {}
+
+	battlefield_zone(battlefield_zone&&) = default;
+	battlefield_zone& operator=(battlefield_zone&&) = default;
+
+	/**
+	* copy the permanents of another battlefield, keeps the memory resource and the undo log of this one
+	* @param other the battlefield to copy
+	**/
+	void assign(const battlefield_zone& other) {
+		ids = other.ids;
+		types = other.types;
+		flags = other.flags;
+		power = other.power;
+		toughness = other.toughness;
+		health = other.health;
+		slots = other.slots;
+		slot_positions = other.slot_positions;
+		slot_generations = other.slot_generations;
+		free_slots = other.free_slots;
+		state_hash = other.state_hash;
+	}
+
+	/**
+	* set the undo log told about changes of the battlefield
+	* @param log the log, nullptr for none
+	**/
+	void set_undo_log(undo_log* log) {
+		journal = log;
+	}
+
+	/**
+	* put a card onto the battlefield, creatures start with full health and summoning sickness
+	* @param id card to put onto the battlefield
+	*
+	* @returns handle of the new permanent
+	**/
+	permanent_handle add(card_id id) {
+		record();
+		const card& definition = card_definition(id);
+		std::uint32_t slot;
+		if (free_slots.empty()) {
+			slot = static_cast<std::uint32_t>(slot_positions.size());
+			slot_positions.push_back(0);
+			slot_generations.push_back(0);
+		} else {
+			slot = free_slots.back();
+			free_slots.pop_back();
+		}
+		slot_positions[slot] = static_cast<std::uint32_t>(ids.size());
+
+		ids.push_back(id);
+		types.push_back(definition.get_type());
+		flags.push_back(SUMMONING_SICKNESS);
+		if (definition.get_type() == CardType::CREATURE) {
+			const creature& creature_ = static_cast<const creature&>(definition);
+			power.push_back(creature_.get_power());
+			toughness.push_back(creature_.get_toughness());
+			health.push_back(creature_.get_toughness());
+		} else {
+			power.push_back(0);
+			toughness.push_back(0);
+			health.push_back(0);
+		}
+		slots.push_back(slot);
+		state_hash += permanent_key(ids.size() - 1);
+		return permanent_handle{ slot, slot_generations[slot] };
+	}
+
+	/**
+	* take a permanent off the battlefield, the last permanent takes its position
+	* @param index position of the permanent
+	*
+	* @returns the card that left
+	**/
+	card_id remove(size_t index) {
+		record();
+		state_hash -= permanent_key(index);
+		card_id id = ids[index];
+		std::uint32_t slot = slots[index];
+		slot_generations[slot]++;
+		free_slots.push_back(slot);
+
+		size_t last = ids.size() - 1;
+		if (index != last) {
+			ids[index] = ids[last];
+			types[index] = types[last];
+			flags[index] = flags[last];
+			power[index] = power[last];
+			toughness[index] = toughness[last];
+			health[index] = health[last];
+			slots[index] = slots[last];
+			slot_positions[slots[index]] = static_cast<std::uint32_t>(index);
+		}
+		ids.pop_back();
+		types.pop_back();
+		flags.pop_back();
+		power.pop_back();
+		toughness.pop_back();
+		health.pop_back();
+		slots.pop_back();
+		return id;
+	}
+
+	/**
+	* get the number of permanents
+	*
+	* @returns number of permanents
+	**/
+	size_t size() const {
+		return ids.size();
+	}
+
+	/**
+	* checks if there are no permanents
+	*
+	* @returns true if the battlefield is empty
+	**/
+	bool empty() const {
+		return ids.empty();
+	}
+
+	/**
+	* get the handle of the permanent at a position
+	* @param index position of the permanent
+	*
+	* @returns handle
+	**/
+	permanent_handle handle(size_t index) const {
+		return permanent_handle{ slots[index], slot_generations[slots[index]] };
+	}
+
+	/**
+	* checks if the permanent of a handle is still on the battlefield
+	* @param handle handle of the permanent
+	*
+	* @returns true if it is
+	**/
+	bool contains(permanent_handle handle) const {
+		return handle.slot < slot_generations.size() && slot_generations[handle.slot] == handle.generation;
+	}
+
+	/**
+	* get the current position of the permanent of a handle, it has to be on the battlefield
+	* @param handle handle of the permanent
+	*
+	* @returns position
+	**/
+	size_t index_of(permanent_handle handle) const {
+		return slot_positions[handle.slot];
+	}
+
+	card_id get_id(size_t index) const { return ids[index]; }
+	const card& definition(size_t index) const { return card_definition(ids[index]); }
+	const std::string& get_name(size_t index) const { return definition(index).get_name(); }
+	CardType get_type(size_t index) const { return types[index]; }
+	int get_power(size_t index) const { return power[index]; }
+	int get_toughness(size_t index) const { return toughness[index]; }
+	int get_health(size_t index) const { return health[index]; }
+	bool is_tapped(size_t index) const { return flags[index] & TAPPED; }
+	bool has_summoning_sickness(size_t index) const { return flags[index] & SUMMONING_SICKNESS; }
+	bool is_dead(size_t index) const { return flags[index] & DEAD; }
+
+	void set_tapped(size_t index, bool set_to) {
+		record();
+		state_hash -= permanent_key(index);
+		flags[index] = set_to ? (flags[index] | TAPPED) : (flags[index] & ~TAPPED);
+		state_hash += permanent_key(index);
+	}
+
+	void set_summoning_sickness(size_t index, bool set_to) {
+		record();
+		state_hash -= permanent_key(index);
+		flags[index] = set_to ? (flags[index] | SUMMONING_SICKNESS) : (flags[index] & ~SUMMONING_SICKNESS);
+		state_hash += permanent_key(index);
+	}
+
+	/**
+	* deals damage to a permanent, a creature dies when its health drops to 0
+	* @param index position of the permanent
+	* @param amount
+	**/
+	void deal_damage(size_t index, int amount) {
+		record();
+		state_hash -= permanent_key(index);
+		health[index] -= amount;
+		if (health[index] <= 0) {
+			flags[index] |= DEAD;
+		}
+		state_hash += permanent_key(index);
+	}
+
+	/**
+	* untap every permanent and remove summoning sickness
+	**/
+	void untap_all() {
+		record();
+		for (auto& flag : flags) {
+			flag &= ~(TAPPED | SUMMONING_SICKNESS);
+		}
+		rehash();
+	}
+
+	/**
+	* heal every creature back to its toughness
+	**/
+	void heal_creatures() {
+		record();
+		for (size_t i = 0; i < health.size(); i++) {
+			health[i] = toughness[i];
+		}
+		rehash();
+	}
+
+	/**
+	* checks if any creature died since the last sweep
+	*
+	* @returns true if some permanent is dead
+	**/
+	bool any_dead() const {
+		std::uint8_t all = 0;
+		for (auto flag : flags) {
+			all |= flag;
+		}
+		return all & DEAD;
+	}
+
+	/**
+	* get the zobrist hash of the permanents (see zobrist_key)
+	*
+	* @returns hash
+	**/
+	std::uint64_t hash() const {
+		return state_hash;
+	}
+
+private:
+	// per permanent, indexed by position
+	std::pmr::vector<card_id> ids;
+	std::pmr::vector<CardType> types;
+	std::pmr::vector<std::uint8_t> flags;
+	std::pmr::vector<int> power;
+	std::pmr::vector<int> toughness;
+	std::pmr::vector<int> health;
+	std::pmr::vector<std::uint32_t> slots;
+
+	// per handle slot
+	std::pmr::vector<std::uint32_t> slot_positions;
+	std::pmr::vector<std::uint32_t> slot_generations;
+	std::pmr::vector<std::uint32_t> free_slots;
+
+	std::uint64_t state_hash = 0;
+
+	undo_log* journal = nullptr;
+
+	void record() {
+		if (journal != nullptr) journal->save_zone(*this);
+	}
+
+	// dead is left out, it follows from the health
+	std::uint64_t permanent_key(size_t index) const {
+		return zobrist_key(zobrist_part::PERMANENT, ids[index],
+			(flags[index] & (TAPPED | SUMMONING_SICKNESS)) | (static_cast<std::uint64_t>(static_cast<std::uint32_t>(health[index])) << 8));
+	}
+
+	void rehash() {
+		state_hash = 0;
+		for (size_t i = 0; i < ids.size(); i++) {
+			state_hash += permanent_key(i);
+		}
+	}
+};
+
+#endif //MTG_ENGINE_ZONE_H